@@ -0,0 +1,114 @@
+// ============================================
+// GAME-STARTED ANIMATION SCHEDULER
+// ============================================
+// Cooperative, timestamp-driven frame scheduler. The render task
+// calls tick() once per pass; it reports at most one frame to draw
+// and never waits, so packets keep flowing while an animation
+// plays. Court events are queued in arrival order and
+// duplicates of a queued/playing court are coalesced.
+
+#pragma once
+
+#include <cstdint>
+
+#ifndef ANIM_FRAME_MS
+#define ANIM_FRAME_MS 40
+#endif
+#define ANIM_PHASE1_FRAMES 19 // ball-bounce frames
+#define ANIM_TOTAL_FRAMES 37  // total frames (~1.5 s)
+#define ANIM_RUSH_FRAMES 25   // total frames when another court is waiting: bounce + all 6 flash frames
+#define ANIM_QUEUE_DEPTH 8
+
+enum class AnimTick : uint8_t
+{
+  Idle,  // nothing playing — draw the normal view
+  Hold,  // playing, current frame still on screen
+  Frame, // draw frame `frame` for court `courtId`
+  Done   // last animation just finished — restore the normal view
+};
+
+struct AnimFrame
+{
+  uint8_t courtId;
+  uint8_t frame;
+};
+
+class AnimationScheduler
+{
+public:
+  // Queue a game-started animation. Returns false if the court is
+  // already playing/queued (coalesced) or the queue is full.
+  bool enqueue(uint8_t courtId)
+  {
+    if (activeCourt_ == courtId)
+      return false;
+    for (uint8_t i = 0; i < pending_; i++)
+    {
+      if (queue_[(head_ + i) % ANIM_QUEUE_DEPTH] == courtId)
+        return false;
+    }
+    if (pending_ >= ANIM_QUEUE_DEPTH)
+      return false;
+    queue_[(head_ + pending_) % ANIM_QUEUE_DEPTH] = courtId;
+    pending_++;
+    return true;
+  }
+
+  AnimTick tick(uint32_t now, AnimFrame &out)
+  {
+    if (activeCourt_ == 0)
+    {
+      if (!startNext(now))
+        return AnimTick::Idle;
+    }
+
+    uint32_t frame = (now - startMs_) / ANIM_FRAME_MS;
+
+    // Another court is waiting: end right after the invert flashes,
+    // dropping the static hold that follows them
+    uint32_t total = pending_ > 0 ? ANIM_RUSH_FRAMES : ANIM_TOTAL_FRAMES;
+    if (frame >= total)
+    {
+      activeCourt_ = 0;
+      if (!startNext(now))
+        return AnimTick::Done;
+      frame = 0;
+    }
+
+    if ((int32_t)frame == lastFrame_)
+      return AnimTick::Hold;
+
+    // Time-based: if the render task was late, skip straight to the current frame
+    lastFrame_ = (int32_t)frame;
+    out.courtId = activeCourt_;
+    out.frame = (uint8_t)frame;
+    return AnimTick::Frame;
+  }
+
+  bool active() const { return activeCourt_ != 0; }
+
+  // When tick() next has something to do (the next frame, or the end
+  // of the animation). Only meaningful while active().
+  uint32_t nextFrameMs() const { return startMs_ + (uint32_t)(lastFrame_ + 1) * ANIM_FRAME_MS; }
+  uint8_t pending() const { return pending_; }
+
+private:
+  bool startNext(uint32_t now)
+  {
+    if (pending_ == 0)
+      return false;
+    activeCourt_ = queue_[head_];
+    head_ = (head_ + 1) % ANIM_QUEUE_DEPTH;
+    pending_--;
+    startMs_ = now;
+    lastFrame_ = -1;
+    return true;
+  }
+
+  uint8_t queue_[ANIM_QUEUE_DEPTH] = {0};
+  uint8_t head_ = 0;
+  uint8_t pending_ = 0;
+  uint8_t activeCourt_ = 0; // 0 = none
+  uint32_t startMs_ = 0;
+  int32_t lastFrame_ = -1;
+};
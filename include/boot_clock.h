@@ -0,0 +1,92 @@
+// ============================================
+// RETAINED BOARD CLOCK
+// ============================================
+// The receiver's board clock (boardMillis()) dates every game. After
+// a reset it has to resume, or running games would restart from zero.
+// Two sources, best first:
+//
+//   - a copy in RTC memory, refreshed every few hundred ms, paired
+//     with the RTC timer, which keeps counting through a soft reset
+//     (panic, watchdog, OTA). The clock resumes exactly, reset
+//     included.
+//   - the event log's last timestamp, after a power loss has wiped
+//     RTC memory. Time spent powered off is not counted.
+//
+// A CRC tells a retained copy from the garbage left after power-on.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "crc.h"
+
+#define RETAINED_CLOCK_MAGIC 0x4B4C4352u // "RCLK"
+#define RETAINED_CLOCK_MAX_GAP_US (10ull * 60 * 1000000) // longer "resets" are not trusted
+
+struct RetainedClock
+{
+  uint32_t magic;
+  uint32_t boardMs; // board clock at the last save
+  uint64_t rtcUs;   // RTC timer at the same moment
+  uint16_t crc;     // CRC-16 of the fields above
+};
+
+inline uint16_t retainedClockCrc(const RetainedClock &c)
+{
+  return crc16((const uint8_t *)&c, offsetof(RetainedClock, crc));
+}
+
+inline void retainClock(RetainedClock &c, uint32_t boardMs, uint64_t rtcUs)
+{
+  c.magic = RETAINED_CLOCK_MAGIC;
+  c.boardMs = boardMs;
+  c.rtcUs = rtcUs;
+  c.crc = retainedClockCrc(c);
+}
+
+// Board clock now, from a retained copy. False when the copy is
+// corrupt or the RTC timer does not follow on from it (power loss).
+inline bool resumeClock(const RetainedClock &c, uint64_t rtcUs, uint32_t &boardMs)
+{
+  if (c.magic != RETAINED_CLOCK_MAGIC || c.crc != retainedClockCrc(c))
+    return false;
+  if (rtcUs < c.rtcUs || rtcUs - c.rtcUs > RETAINED_CLOCK_MAX_GAP_US)
+    return false;
+  boardMs = c.boardMs + (uint32_t)((rtcUs - c.rtcUs) / 1000);
+  return true;
+}
+
+enum class ClockSource : uint8_t
+{
+  Rtc,      // resumed from RTC memory across a soft reset
+  EventLog, // resumed from the last logged timestamp
+  Fresh     // nothing to resume: starts at millis()
+};
+
+// Board clock at boot from the best source available
+inline ClockSource bootBoardMs(const RetainedClock &c, uint64_t rtcUs, bool haveLog, uint32_t logLastMs,
+                               uint32_t millisNow, uint32_t &boardMs)
+{
+  if (resumeClock(c, rtcUs, boardMs))
+    return ClockSource::Rtc;
+  if (haveLog)
+  {
+    boardMs = logLastMs;
+    return ClockSource::EventLog;
+  }
+  boardMs = millisNow;
+  return ClockSource::Fresh;
+}
+
+inline const char *clockSourceName(ClockSource s)
+{
+  switch (s)
+  {
+  case ClockSource::Rtc:
+    return "RTC";
+  case ClockSource::EventLog:
+    return "event log";
+  default:
+    return "fresh";
+  }
+}
@@ -0,0 +1,111 @@
+// ============================================
+// COBS FRAMING
+// ============================================
+// Consistent Overhead Byte Stuffing: removes every 0x00 from a
+// payload so 0x00 can delimit frames on a byte stream (USB serial).
+// Frames are written as 0x00 <cobs(payload)> 0x00; the leading
+// delimiter ends whatever partial data or text came before.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#define COBS_MAX_ENCODED(n) ((n) + (n) / 254 + 1)
+#define COBS_MAX_FRAME(n) (COBS_MAX_ENCODED(n) + 2) // with both delimiters
+
+// Encode `len` bytes; `out` needs COBS_MAX_ENCODED(len) bytes. No
+// delimiter is written. Returns the encoded length.
+inline size_t cobsEncode(const uint8_t *in, size_t len, uint8_t *out)
+{
+  size_t codeAt = 0, o = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; i++)
+  {
+    if (in[i] != 0)
+    {
+      out[o++] = in[i];
+      code++;
+    }
+    if (in[i] == 0 || code == 0xFF)
+    {
+      out[codeAt] = code;
+      codeAt = o++;
+      code = 1;
+    }
+  }
+  out[codeAt] = code;
+  return o;
+}
+
+// Returns the decoded length, or 0 if the input is not valid COBS
+inline size_t cobsDecode(const uint8_t *in, size_t len, uint8_t *out, size_t cap)
+{
+  size_t i = 0, o = 0;
+  while (i < len)
+  {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > len)
+      return 0;
+    for (uint8_t k = 1; k < code; k++)
+    {
+      if (o >= cap)
+        return 0;
+      out[o++] = in[i++];
+    }
+    if (code != 0xFF && i < len)
+    {
+      if (o >= cap)
+        return 0;
+      out[o++] = 0;
+    }
+  }
+  return o;
+}
+
+// Delimited frame: `out` needs COBS_MAX_FRAME(len) bytes. Returns the
+// number of bytes to put on the wire.
+inline size_t cobsFrame(const uint8_t *payload, size_t len, uint8_t *out)
+{
+  out[0] = 0;
+  size_t n = cobsEncode(payload, len, out + 1);
+  out[n + 1] = 0;
+  return n + 2;
+}
+
+// Splits a byte stream into decoded payloads of up to MaxPayload bytes
+template <size_t MaxPayload>
+class CobsReader
+{
+public:
+  // Returns true when `b` closed a non-empty chunk. `payload` and
+  // `len` hold it decoded (valid until the next call); len is 0 when
+  // the chunk was not valid COBS or overflowed.
+  bool feed(uint8_t b, const uint8_t *&payload, size_t &len)
+  {
+    if (b != 0)
+    {
+      if (len_ < sizeof(buf_))
+        buf_[len_++] = b;
+      else
+        overflow_ = true;
+      return false;
+    }
+
+    bool closed = len_ > 0;
+    if (closed)
+    {
+      len = overflow_ ? 0 : cobsDecode(buf_, len_, out_, sizeof(out_));
+      payload = out_;
+    }
+    len_ = 0;
+    overflow_ = false;
+    return closed;
+  }
+
+private:
+  uint8_t buf_[COBS_MAX_ENCODED(MaxPayload)];
+  uint8_t out_[MaxPayload];
+  size_t len_ = 0;
+  bool overflow_ = false;
+};
@@ -0,0 +1,247 @@
+// ============================================
+// COURT PACKET PROTOCOL
+// ============================================
+// Wire format shared by transmitters, the receiver
+// and the native test/preview builds.
+//
+// Two frame formats are accepted:
+//
+//   v1 (legacy) — exactly 2 bytes: a bare CourtPacket.
+//
+//   v2 — little-endian header followed by 1..PACKET_MAX_RECORDS
+//   court records, so a relay can forward many courts at once:
+//
+//     0     magic        PACKET_MAGIC
+//     1     version      PACKET_VERSION
+//     2     srcId        sending unit (court transmitter = its COURT_ID)
+//     3     flags        bit n (0..5) set → one u16 extension field present;
+//                         bit 6 → records carry an age (see below)
+//     4-5   seq          per-source sequence number, wraps
+//     6-9   uptimeS      seconds since the sender powered on
+//     10    batteryPct   0-100, PACKET_BATTERY_UNKNOWN if not measured
+//     11    count        number of court records
+//     12..  extensions   one u16 per set flag bit, in bit order
+//     ...   records      {courtId, occupied} × count, or
+//                         {courtId, occupied, age u16} × count with bit 6
+//
+// A record's age is how long before the frame was sent its state
+// change happened, in PACKET_AGE_UNIT_MS units (saturating). Senders
+// that journal transitions while the link is down set it so the
+// receiver can date games from the press, not the delivery.
+//
+// Receivers skip extension fields they do not understand, so new
+// optional fields can be added without another version bump.
+//
+// Extension fields (flag bit → u16):
+//   0  PACKET_EXT_AWAKE_MS   sender's wake-to-sleep time on its
+//                            previous heartbeat cycle, in ms
+//   1  PACKET_EXT_INTERVAL_S seconds until the sender's next
+//                            heartbeat (adaptive heartbeat)
+//   2  PACKET_EXT_PRESS_MS   wake-to-send time of the sender's last
+//                            button press, in ms
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct CourtPacket
+{
+  uint8_t courtId;  // 1-based court number
+  uint8_t occupied; // 1 = in use, 0 = available
+};
+
+#define PACKET_MAGIC 0xA5
+#define PACKET_VERSION 2
+#define PACKET_HEADER_BYTES 12
+#define PACKET_MAX_RECORDS 16
+#define PACKET_EXT_SLOTS 6 // flag bits 0..5
+#define PACKET_FLAG_EXT_MASK 0x3F
+#define PACKET_FLAG_RECORD_AGE 0x40
+#define PACKET_AGE_UNIT_MS 100
+#define PACKET_BATTERY_UNKNOWN 0xFF
+#define PACKET_EXT_AWAKE_MS 0
+#define PACKET_EXT_INTERVAL_S 1
+#define PACKET_EXT_PRESS_MS 2
+#define PACKET_MAX_BYTES (PACKET_HEADER_BYTES + 2 * PACKET_EXT_SLOTS + 4 * PACKET_MAX_RECORDS)
+
+// Decoded frame, whichever format it arrived in
+struct CourtFrame
+{
+  uint8_t version; // 1 = legacy 2-byte frame (no seq/uptime/battery)
+  uint8_t srcId;
+  uint8_t flags;
+  uint16_t seq;
+  uint32_t uptimeS;
+  uint8_t batteryPct;
+  uint8_t count;
+  uint16_t ext[PACKET_EXT_SLOTS]; // valid where the matching flag bit is set
+  CourtPacket records[PACKET_MAX_RECORDS];
+  uint16_t ages[PACKET_MAX_RECORDS]; // PACKET_AGE_UNIT_MS units, 0 = current
+};
+
+// A frame as handed from the radio callback to the state task, stamped with
+// the receive time so queueing delay does not skew game timings.
+struct ReceivedFrame
+{
+  CourtFrame frame;
+  uint32_t rxMs;
+  uint32_t rxStamp; // INSTR_STAMP() at receipt, for the latency probes
+};
+
+inline void initCourtFrame(CourtFrame &f, uint8_t srcId, uint16_t seq)
+{
+  f.version = PACKET_VERSION;
+  f.srcId = srcId;
+  f.flags = 0;
+  f.seq = seq;
+  f.uptimeS = 0;
+  f.batteryPct = PACKET_BATTERY_UNKNOWN;
+  f.count = 0;
+  for (int i = 0; i < PACKET_EXT_SLOTS; i++)
+    f.ext[i] = 0;
+  for (int i = 0; i < PACKET_MAX_RECORDS; i++)
+    f.ages[i] = 0;
+}
+
+inline bool addCourtRecord(CourtFrame &f, uint8_t courtId, bool occupied)
+{
+  if (f.count >= PACKET_MAX_RECORDS)
+    return false;
+  f.records[f.count].courtId = courtId;
+  f.records[f.count].occupied = occupied ? 1 : 0;
+  f.ages[f.count] = 0;
+  f.count++;
+  return true;
+}
+
+// A record for a state change `ageMs` before the frame goes out
+inline bool addAgedCourtRecord(CourtFrame &f, uint8_t courtId, bool occupied, uint32_t ageMs)
+{
+  if (!addCourtRecord(f, courtId, occupied))
+    return false;
+  uint32_t units = ageMs / PACKET_AGE_UNIT_MS;
+  f.ages[f.count - 1] = units > 0xFFFF ? 0xFFFF : (uint16_t)units;
+  if (units > 0)
+    f.flags |= PACKET_FLAG_RECORD_AGE;
+  return true;
+}
+
+inline uint32_t recordAgeMs(const CourtFrame &f, int i)
+{
+  return (uint32_t)f.ages[i] * PACKET_AGE_UNIT_MS;
+}
+
+inline void setFrameExt(CourtFrame &f, uint8_t bit, uint16_t value)
+{
+  f.flags |= (uint8_t)(1u << bit);
+  f.ext[bit] = value;
+}
+
+inline bool hasFrameExt(const CourtFrame &f, uint8_t bit)
+{
+  return f.version >= PACKET_VERSION && (f.flags & (1u << bit));
+}
+
+// Serialize as v2. Returns bytes written, or 0 if `cap` is too small.
+inline size_t encodeCourtFrame(const CourtFrame &f, uint8_t *buf, size_t cap)
+{
+  bool aged = f.flags & PACKET_FLAG_RECORD_AGE;
+  size_t need = PACKET_HEADER_BYTES + (aged ? 4 : 2) * (size_t)f.count;
+  for (int b = 0; b < PACKET_EXT_SLOTS; b++)
+    if (f.flags & (1u << b))
+      need += 2;
+  if (need > cap || f.count == 0 || f.count > PACKET_MAX_RECORDS)
+    return 0;
+
+  uint8_t *p = buf;
+  *p++ = PACKET_MAGIC;
+  *p++ = PACKET_VERSION;
+  *p++ = f.srcId;
+  *p++ = f.flags & (PACKET_FLAG_EXT_MASK | PACKET_FLAG_RECORD_AGE);
+  *p++ = (uint8_t)(f.seq & 0xFF);
+  *p++ = (uint8_t)(f.seq >> 8);
+  for (int i = 0; i < 4; i++)
+    *p++ = (uint8_t)(f.uptimeS >> (8 * i));
+  *p++ = f.batteryPct;
+  *p++ = f.count;
+  for (int b = 0; b < PACKET_EXT_SLOTS; b++)
+  {
+    if (f.flags & (1u << b))
+    {
+      *p++ = (uint8_t)(f.ext[b] & 0xFF);
+      *p++ = (uint8_t)(f.ext[b] >> 8);
+    }
+  }
+  for (int i = 0; i < f.count; i++)
+  {
+    *p++ = f.records[i].courtId;
+    *p++ = f.records[i].occupied;
+    if (aged)
+    {
+      *p++ = (uint8_t)(f.ages[i] & 0xFF);
+      *p++ = (uint8_t)(f.ages[i] >> 8);
+    }
+  }
+  return (size_t)(p - buf);
+}
+
+// Parse either format. Returns false for anything malformed; court ids
+// are range-checked later against the receiver's court count.
+inline bool decodeCourtFrame(const uint8_t *data, size_t len, CourtFrame &f)
+{
+  if (len == sizeof(CourtPacket))
+  {
+    // Legacy v1: the whole frame is one CourtPacket
+    initCourtFrame(f, data[0], 0);
+    f.version = 1;
+    f.records[0].courtId = data[0];
+    f.records[0].occupied = data[1] ? 1 : 0;
+    f.count = 1;
+    return true;
+  }
+
+  if (len < PACKET_HEADER_BYTES || data[0] != PACKET_MAGIC || data[1] < PACKET_VERSION)
+    return false;
+
+  // Bit 7 would change the record layout; refuse rather than misparse
+  if (data[3] & ~(PACKET_FLAG_EXT_MASK | PACKET_FLAG_RECORD_AGE))
+    return false;
+
+  initCourtFrame(f, data[2], (uint16_t)(data[4] | (data[5] << 8)));
+  f.version = data[1];
+  f.flags = data[3];
+  f.uptimeS = (uint32_t)data[6] | ((uint32_t)data[7] << 8) |
+              ((uint32_t)data[8] << 16) | ((uint32_t)data[9] << 24);
+  f.batteryPct = data[10];
+  f.count = data[11];
+  if (f.count == 0 || f.count > PACKET_MAX_RECORDS)
+    return false;
+
+  const uint8_t *p = data + PACKET_HEADER_BYTES;
+  const uint8_t *end = data + len;
+  for (int b = 0; b < PACKET_EXT_SLOTS; b++)
+  {
+    if (!(f.flags & (1u << b)))
+      continue;
+    if (end - p < 2)
+      return false;
+    f.ext[b] = (uint16_t)(p[0] | (p[1] << 8));
+    p += 2;
+  }
+
+  bool aged = f.flags & PACKET_FLAG_RECORD_AGE;
+  if (end - p < (aged ? 4 : 2) * f.count)
+    return false;
+  for (int i = 0; i < f.count; i++)
+  {
+    f.records[i].courtId = *p++;
+    f.records[i].occupied = *p++ ? 1 : 0;
+    if (aged)
+    {
+      f.ages[i] = (uint16_t)(p[0] | (p[1] << 8));
+      p += 2;
+    }
+  }
+  return true;
+}
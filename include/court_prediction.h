@@ -0,0 +1,151 @@
+// ============================================
+// NEXT-COURT PREDICTION
+// ============================================
+// Estimates when each in-use court will free up from its game-length
+// histogram (WaitStats) and how long it has been in play: the
+// expected remaining time given the game has already lasted that
+// long. Courts are kept in a queue ordered by predicted free time, so
+// "court 6 likely next, ~3 min" is the head of the queue.
+//
+// Work happens per event, not per frame: a game start or end
+// re-predicts that one court (O(bins) + an O(N) reinsert), and
+// refresh() only re-predicts courts whose predicted time has already
+// passed. Display ticks read the head in O(1).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "receiver_logic.h"
+
+#ifndef PREDICT_MIN_COURT_GAMES
+#define PREDICT_MIN_COURT_GAMES 5 // below this, use the board-wide histogram
+#endif
+#ifndef PREDICT_DEFAULT_GAME_MS
+#define PREDICT_DEFAULT_GAME_MS 1200000UL // 20 min, before any game has ended
+#endif
+#ifndef PREDICT_OVERDUE_MS
+#define PREDICT_OVERDUE_MS 60000UL // longer than anything seen: "any minute now"
+#endif
+
+// Mean remaining game time given `elapsedMs` already played, from the
+// histogram (bins treated as uniform). 0 when no recorded game ran
+// that long.
+inline uint32_t expectedRemainingMs(const WaitStats &s, uint32_t elapsedMs)
+{
+  double weight = 0, sum = 0;
+  for (int i = 0; i < WAIT_HIST_BINS; i++)
+  {
+    if (s.hist[i] == 0)
+      continue;
+    double lo = (double)i * WAIT_HIST_BIN_MS;
+    double hi = lo + WAIT_HIST_BIN_MS;
+    if (hi <= elapsedMs)
+      continue;
+    if (lo < elapsedMs)
+    {
+      // Only the part of this bin past elapsedMs is still possible
+      double frac = (hi - elapsedMs) / WAIT_HIST_BIN_MS;
+      weight += s.hist[i] * frac;
+      sum += s.hist[i] * frac * (hi - elapsedMs) / 2;
+    }
+    else
+    {
+      weight += s.hist[i];
+      sum += s.hist[i] * ((lo + hi) / 2 - elapsedMs);
+    }
+  }
+  return weight > 0 ? (uint32_t)(sum / weight) : 0;
+}
+
+template <size_t N>
+class CourtPredictor
+{
+public:
+  CourtPredictor() { reset(); }
+
+  void reset()
+  {
+    count_ = 0;
+    for (size_t i = 0; i < N; i++)
+      pos_[i] = kAbsent;
+  }
+
+  // Re-predict one court (0-based) after it started or finished a game
+  void update(const BasicSystemState<N> &state, int idx, uint32_t now)
+  {
+    remove(idx);
+    const CourtState &court = state.courts[idx];
+    if (!court.inUse || court.inUseSinceMs == 0)
+      return;
+    freeAtMs_[idx] = now + predictRemaining(state, idx, now - court.inUseSinceMs);
+    insert(idx, now);
+  }
+
+  // Re-predict courts that have run past their predicted time
+  void refresh(const BasicSystemState<N> &state, uint32_t now)
+  {
+    while (count_ > 0 && (int32_t)(freeAtMs_[order_[0]] - now) <= 0)
+      update(state, order_[0], now);
+  }
+
+  size_t size() const { return count_; }
+
+  // k-th court (0-based index) in predicted free order; 0 is next
+  int courtAt(size_t k) const { return order_[k]; }
+
+  uint32_t remainingMs(size_t k, uint32_t now) const
+  {
+    int32_t left = (int32_t)(freeAtMs_[order_[k]] - now);
+    return left > 0 ? (uint32_t)left : 0;
+  }
+
+private:
+  static constexpr uint8_t kAbsent = 0xFF;
+
+  uint32_t predictRemaining(const BasicSystemState<N> &state, int idx, uint32_t elapsedMs) const
+  {
+    const WaitStats &own = state.waits[idx];
+    const WaitStats &s = own.histTotal >= PREDICT_MIN_COURT_GAMES ? own : state.allWaits;
+    uint32_t left;
+    if (s.histTotal > 0)
+      left = expectedRemainingMs(s, elapsedMs);
+    else
+      left = elapsedMs < PREDICT_DEFAULT_GAME_MS ? PREDICT_DEFAULT_GAME_MS - elapsedMs : 0;
+    return left < PREDICT_OVERDUE_MS ? PREDICT_OVERDUE_MS : left;
+  }
+
+  void remove(int idx)
+  {
+    uint8_t p = pos_[idx];
+    if (p == kAbsent)
+      return;
+    for (size_t k = p; k + 1 < count_; k++)
+    {
+      order_[k] = order_[k + 1];
+      pos_[order_[k]] = (uint8_t)k;
+    }
+    count_--;
+    pos_[idx] = kAbsent;
+  }
+
+  void insert(int idx, uint32_t now)
+  {
+    int32_t key = (int32_t)(freeAtMs_[idx] - now);
+    size_t k = count_;
+    while (k > 0 && (int32_t)(freeAtMs_[order_[k - 1]] - now) > key)
+    {
+      order_[k] = order_[k - 1];
+      pos_[order_[k]] = (uint8_t)k;
+      k--;
+    }
+    order_[k] = (uint8_t)idx;
+    pos_[idx] = (uint8_t)k;
+    count_++;
+  }
+
+  uint32_t freeAtMs_[N];
+  uint8_t order_[N]; // court indexes sorted by freeAtMs_
+  uint8_t pos_[N];   // court index → slot in order_, kAbsent if idle
+  size_t count_;
+};
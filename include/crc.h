@@ -0,0 +1,26 @@
+// ============================================
+// CRC
+// ============================================
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), bitwise. Small
+// records only, so a lookup table is not worth the flash.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+inline uint16_t crc16Update(uint16_t crc, const uint8_t *data, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++)
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+inline uint16_t crc16(const uint8_t *data, size_t len)
+{
+  return crc16Update(0xFFFF, data, len);
+}
@@ -0,0 +1,346 @@
+// ============================================
+// EVENT LOG
+// ============================================
+// Append-only log of court transitions, so a brownout or reflash does
+// not wipe the day's statistics or the timers of games in progress.
+// Replaying the log through applyPacket() rebuilds SystemState.
+//
+// Storage is a ring of EVENT_LOG_SEGMENTS files under one directory,
+// written with plain stdio: on the receiver that directory is the
+// LittleFS mount (which does its own wear leveling), natively it is
+// any temp directory. Records are buffered in RAM and written in
+// batches; each batch is appended and the file closed, which commits
+// it on LittleFS. When the active segment is full the oldest one is
+// recycled, so only the last EVENT_LOG_SEGMENTS × SEGMENT_BYTES of
+// history is kept.
+//
+// Record (12 bytes, little-endian):
+//
+//     0     type      EventType
+//     1     courtId
+//     2-5   seq       log sequence number, +1 per record
+//     6-9   timeMs    board clock (see EventLog::lastTimeMs)
+//     10-11 crc       CRC-16 of bytes 0-9
+//
+// A torn or corrupt record ends its segment. If it is the active
+// segment, later appends go to a fresh segment rather than behind
+// the damage.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <unistd.h>
+#include "crc.h"
+#include "receiver_logic.h"
+
+#ifndef EVENT_LOG_SEGMENTS
+#define EVENT_LOG_SEGMENTS 4
+#endif
+#ifndef EVENT_LOG_SEGMENT_BYTES
+#define EVENT_LOG_SEGMENT_BYTES 16384 // ~680 games per segment
+#endif
+#ifndef EVENT_LOG_BATCH
+#define EVENT_LOG_BATCH 16 // records buffered before a forced write
+#endif
+#ifndef EVENT_LOG_FLUSH_MS
+#define EVENT_LOG_FLUSH_MS 2000 // max age of a buffered record
+#endif
+#ifndef EVENT_LOG_CLOCK_MS
+#define EVENT_LOG_CLOCK_MS 60000 // clock record period while a game is running
+#endif
+
+#define EVENT_RECORD_BYTES 12
+
+enum EventType : uint8_t
+{
+  EV_NONE = 0, // erased / zero-filled space, never written
+  EV_OCCUPIED = 1,
+  EV_FREED = 2,
+  EV_CLOCK = 3 // no state change; keeps the board clock moving across a reboot
+};
+
+struct EventRecord
+{
+  uint8_t type;
+  uint8_t courtId;
+  uint32_t seq;
+  uint32_t timeMs;
+};
+
+inline void encodeEventRecord(const EventRecord &r, uint8_t *out)
+{
+  out[0] = r.type;
+  out[1] = r.courtId;
+  for (int i = 0; i < 4; i++)
+  {
+    out[2 + i] = (uint8_t)(r.seq >> (8 * i));
+    out[6 + i] = (uint8_t)(r.timeMs >> (8 * i));
+  }
+  uint16_t crc = crc16(out, 10);
+  out[10] = (uint8_t)(crc & 0xFF);
+  out[11] = (uint8_t)(crc >> 8);
+}
+
+inline bool decodeEventRecord(const uint8_t *in, EventRecord &r)
+{
+  uint16_t crc = (uint16_t)(in[10] | (in[11] << 8));
+  if (crc != crc16(in, 10))
+    return false;
+  if (in[0] == EV_NONE || in[0] > EV_CLOCK)
+    return false;
+  r.type = in[0];
+  r.courtId = in[1];
+  r.seq = 0;
+  r.timeMs = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    r.seq |= (uint32_t)in[2 + i] << (8 * i);
+    r.timeMs |= (uint32_t)in[6 + i] << (8 * i);
+  }
+  return true;
+}
+
+struct EventLogStats
+{
+  uint32_t replayed;   // records applied at the last replay
+  uint32_t written;    // records appended since open()
+  uint32_t writeFails; // batches that could not be written (records dropped)
+  uint32_t tornSegments;
+};
+
+class EventLog
+{
+public:
+  // Scan the segments under `dir` and pick where the next record goes.
+  // Returns false only if `dir` is unusable.
+  bool open(const char *dir)
+  {
+    snprintf(dir_, sizeof(dir_), "%s", dir);
+    stats_ = EventLogStats{};
+    pending_ = 0;
+    nextSeq_ = 1;
+    lastTimeMs_ = 0;
+    active_ = -1;
+
+    int newest = -1;
+    uint32_t newestSeq = 0;
+    for (int i = 0; i < EVENT_LOG_SEGMENTS; i++)
+    {
+      SegmentInfo &s = segs_[i];
+      scanSegment(i, s, [](const EventRecord &) {});
+      if (s.count > 0 && (newest < 0 || s.firstSeq > newestSeq))
+      {
+        newest = i;
+        newestSeq = s.firstSeq;
+      }
+      if (s.torn)
+        stats_.tornSegments++;
+    }
+
+    if (newest < 0)
+    {
+      active_ = 0;
+      return resetSegment(0);
+    }
+
+    nextSeq_ = segs_[newest].lastSeq + 1;
+    lastTimeMs_ = segs_[newest].lastTimeMs;
+    active_ = newest;
+    if (segs_[newest].torn || segs_[newest].bytes + EVENT_RECORD_BYTES > EVENT_LOG_SEGMENT_BYTES)
+      return rotate();
+    return true;
+  }
+
+  // Rebuild `state` from every retained record, oldest segment first.
+  // The caller should have run initSystemState(). Courts never seen in
+  // the log are opened at the first record's time. Returns the number
+  // of records applied.
+  template <size_t N>
+  uint32_t replay(BasicSystemState<N> &state)
+  {
+    bool opened = false;
+    auto apply = [&](const EventRecord &r)
+    {
+      if (!opened)
+      {
+        openAllCourts(state, r.timeMs);
+        opened = true;
+      }
+      if (r.type == EV_CLOCK)
+        return;
+      CourtPacket pkt = {r.courtId, (uint8_t)(r.type == EV_OCCUPIED)};
+      applyPacket(state, pkt, r.timeMs);
+    };
+
+    int order[EVENT_LOG_SEGMENTS];
+    int n = segmentsOldestFirst(order);
+    stats_.replayed = 0;
+    for (int k = 0; k < n; k++)
+    {
+      SegmentInfo s;
+      stats_.replayed += scanSegment(order[k], s, apply);
+    }
+    return stats_.replayed;
+  }
+
+  // Queue a record; written on the next flush()
+  void append(EventType type, uint8_t courtId, uint32_t timeMs)
+  {
+    if (pending_ == EVENT_LOG_BATCH && !flush())
+      pending_ = 0; // storage is failing; drop rather than block the loop
+    EventRecord r = {type, courtId, nextSeq_++, timeMs};
+    encodeEventRecord(r, batch_ + pending_ * EVENT_RECORD_BYTES);
+    if (pending_ == 0)
+      oldestPendingMs_ = timeMs;
+    pending_++;
+    lastTimeMs_ = timeMs;
+  }
+
+  // Call from the state task: writes a clock record while games are running
+  // and flushes batches that are full or old enough
+  void service(uint32_t now, bool gameRunning)
+  {
+    if (gameRunning && now - lastTimeMs_ >= EVENT_LOG_CLOCK_MS)
+      append(EV_CLOCK, 0, now);
+    if (pending_ > 0 && (pending_ >= EVENT_LOG_BATCH || now - oldestPendingMs_ >= EVENT_LOG_FLUSH_MS))
+      flush();
+  }
+
+  bool flush()
+  {
+    if (pending_ == 0)
+      return true;
+    if (active_ < 0)
+      return false;
+
+    size_t bytes = pending_ * EVENT_RECORD_BYTES;
+    if (segs_[active_].bytes + bytes > EVENT_LOG_SEGMENT_BYTES && !rotate())
+    {
+      stats_.writeFails++;
+      return false;
+    }
+
+    char path[sizeof(dir_) + 16];
+    segmentPath(active_, path, sizeof(path));
+    FILE *f = fopen(path, "ab");
+    bool ok = f && fwrite(batch_, 1, bytes, f) == bytes && fflush(f) == 0;
+    if (f)
+    {
+      fsync(fileno(f));
+      fclose(f);
+    }
+    if (!ok)
+    {
+      stats_.writeFails++;
+      rotate(); // never append behind a partial write
+      return false;
+    }
+    segs_[active_].bytes += bytes;
+    stats_.written += pending_;
+    pending_ = 0;
+    return true;
+  }
+
+  // Timestamp of the newest record (written or pending). After a
+  // reboot the board clock resumes from here.
+  uint32_t lastTimeMs() const { return lastTimeMs_; }
+  const EventLogStats &stats() const { return stats_; }
+
+private:
+  struct SegmentInfo
+  {
+    uint32_t count;
+    uint32_t firstSeq, lastSeq, lastTimeMs;
+    size_t bytes; // valid prefix
+    bool torn;    // bytes after the valid prefix
+  };
+
+  void segmentPath(int i, char *out, size_t cap) const
+  {
+    snprintf(out, cap, "%s/ev%d.log", dir_, i);
+  }
+
+  // Walk the valid prefix of segment i, handing each record to onRecord
+  template <typename Fn>
+  uint32_t scanSegment(int i, SegmentInfo &s, Fn &&onRecord)
+  {
+    s = SegmentInfo{0, 0, 0, 0, 0, false};
+    char path[sizeof(dir_) + 16];
+    segmentPath(i, path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (!f)
+      return 0;
+
+    uint8_t buf[EVENT_RECORD_BYTES];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), f)) == sizeof(buf))
+    {
+      EventRecord r;
+      if (!decodeEventRecord(buf, r) || (s.count > 0 && r.seq != s.lastSeq + 1))
+      {
+        s.torn = true;
+        break;
+      }
+      if (s.count == 0)
+        s.firstSeq = r.seq;
+      s.lastSeq = r.seq;
+      s.lastTimeMs = r.timeMs;
+      s.count++;
+      s.bytes += sizeof(buf);
+      onRecord(r);
+    }
+    if (got > 0 && got < sizeof(buf))
+      s.torn = true;
+    fclose(f);
+    return s.count;
+  }
+
+  int segmentsOldestFirst(int *order) const
+  {
+    int n = 0;
+    for (int i = 0; i < EVENT_LOG_SEGMENTS; i++)
+    {
+      if (segs_[i].count == 0)
+        continue;
+      int k = n++;
+      while (k > 0 && segs_[order[k - 1]].firstSeq > segs_[i].firstSeq)
+      {
+        order[k] = order[k - 1];
+        k--;
+      }
+      order[k] = i;
+    }
+    return n;
+  }
+
+  bool resetSegment(int i)
+  {
+    char path[sizeof(dir_) + 16];
+    segmentPath(i, path, sizeof(path));
+    FILE *f = fopen(path, "wb");
+    segs_[i] = SegmentInfo{0, 0, 0, 0, 0, false};
+    if (!f)
+      return false;
+    fclose(f);
+    return true;
+  }
+
+  // Move to the next slot, dropping whatever history it held
+  bool rotate()
+  {
+    active_ = (active_ + 1) % EVENT_LOG_SEGMENTS;
+    return resetSegment(active_);
+  }
+
+  char dir_[64];
+  SegmentInfo segs_[EVENT_LOG_SEGMENTS];
+  int active_;
+  uint32_t nextSeq_;
+  uint32_t lastTimeMs_;
+  uint8_t batch_[EVENT_LOG_BATCH * EVENT_RECORD_BYTES];
+  size_t pending_;
+  uint32_t oldestPendingMs_;
+  EventLogStats stats_;
+};
@@ -0,0 +1,201 @@
+// ============================================
+// FRAMEBUFFER TARGET
+// ============================================
+// The receiver's screens draw into a 1-bpp 128×64 buffer in SSD1306
+// page layout (one byte = 8 vertical pixels, 128 bytes per page) and
+// then hand it to a FrameTarget. On hardware the target is the panel
+// (flushDisplay() pushes the changed spans); natively it is memory,
+// which the preview dumps as PBM and the tests compare with golden
+// images.
+//
+// The drawing primitives reproduce the Adafruit GFX results for the
+// built-in font and shapes the screens use, so both sides draw the
+// same pixels.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "oled_flush.h"
+#include "oled_font.h"
+
+class FrameTarget
+{
+public:
+  virtual ~FrameTarget() {}
+  virtual uint8_t *buffer() = 0; // FB_BYTES, drawn in place
+  virtual void present() = 0;    // the frame in buffer() is complete
+  // Whole-panel inversion is a controller setting, not buffer contents
+  virtual void setInverted(bool on) = 0;
+};
+
+class MemoryTarget : public FrameTarget
+{
+public:
+  MemoryTarget() { memset(buf_, 0, sizeof(buf_)); }
+
+  uint8_t *buffer() override { return buf_; }
+  void present() override { presented++; }
+  void setInverted(bool on) override { inverted = on; }
+
+  // Pixel as the panel shows it, inversion applied
+  bool lit(int x, int y) const
+  {
+    bool on = (buf_[(y >> 3) * FB_WIDTH + x] >> (y & 7)) & 1;
+    return on != inverted;
+  }
+
+  bool inverted = false;
+  uint32_t presented = 0;
+
+private:
+  uint8_t buf_[FB_BYTES];
+};
+
+// ============================================
+// PRIMITIVES
+// ============================================
+
+inline void fbPixel(uint8_t *fb, int x, int y, bool on)
+{
+  if (x < 0 || x >= FB_WIDTH || y < 0 || y >= FB_HEIGHT)
+    return;
+  uint8_t bit = (uint8_t)(1 << (y & 7));
+  if (on)
+    fb[(y >> 3) * FB_WIDTH + x] |= bit;
+  else
+    fb[(y >> 3) * FB_WIDTH + x] &= (uint8_t)~bit;
+}
+
+inline void fbVLine(uint8_t *fb, int x, int y, int h)
+{
+  for (int i = 0; i < h; i++)
+    fbPixel(fb, x, y + i, true);
+}
+
+inline void fbHLine(uint8_t *fb, int x, int y, int w)
+{
+  for (int i = 0; i < w; i++)
+    fbPixel(fb, x + i, y, true);
+}
+
+inline void fbFillRect(uint8_t *fb, int x, int y, int w, int h)
+{
+  for (int i = 0; i < w; i++)
+    fbVLine(fb, x + i, y, h);
+}
+
+inline void fbRect(uint8_t *fb, int x, int y, int w, int h)
+{
+  fbHLine(fb, x, y, w);
+  fbHLine(fb, x, y + h - 1, w);
+  fbVLine(fb, x, y, h);
+  fbVLine(fb, x + w - 1, y, h);
+}
+
+// Midpoint fill, same spans as Adafruit_GFX::fillCircle()
+inline void fbFillCircle(uint8_t *fb, int x0, int y0, int r)
+{
+  fbVLine(fb, x0, y0 - r, 2 * r + 1);
+  int f = 1 - r, ddx = 1, ddy = -2 * r;
+  int x = 0, y = r, px = x, py = y;
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddy += 2;
+      f += ddy;
+    }
+    x++;
+    ddx += 2;
+    f += ddx;
+    if (x < y + 1)
+    {
+      fbVLine(fb, x0 + x, y0 - y, 2 * y + 1);
+      fbVLine(fb, x0 - x, y0 - y, 2 * y + 1);
+    }
+    if (y != py)
+    {
+      fbVLine(fb, x0 + py, y0 - px, 2 * px + 1);
+      fbVLine(fb, x0 - py, y0 - px, 2 * px + 1);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+// Width GFX getTextBounds() reports for the built-in font
+inline int fbTextWidth(const char *s, int size)
+{
+  return (int)strlen(s) * FONT_ADVANCE * size;
+}
+
+// Built-in font at any integer scale, each font pixel a size×size
+// block. Text that reaches the right edge wraps to the next line, as
+// with GFX's default setTextWrap(true).
+inline void fbText(uint8_t *fb, int x, int y, const char *s, int size)
+{
+  for (; *s; s++)
+  {
+    if (x + FONT_ADVANCE * size > FB_WIDTH)
+    {
+      x = 0;
+      y += 8 * size;
+    }
+    const uint8_t *cols = fontGlyph(*s);
+    for (int i = 0; i < FONT_GLYPH_COLS; i++)
+      for (int j = 0; j < 8; j++)
+        if ((cols[i] >> j) & 1)
+          fbFillRect(fb, x + i * size, y + j * size, size, size);
+    x += FONT_ADVANCE * size;
+  }
+}
+
+// ============================================
+// PBM (portable bitmap) I/O
+// ============================================
+
+// Binary P4, inversion applied. Returns false on I/O failure.
+inline bool writePbm(const char *path, const MemoryTarget &t)
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  fprintf(f, "P4\n%d %d\n", FB_WIDTH, FB_HEIGHT);
+  for (int y = 0; y < FB_HEIGHT; y++)
+  {
+    uint8_t row[FB_WIDTH / 8] = {};
+    for (int x = 0; x < FB_WIDTH; x++)
+      if (t.lit(x, y))
+        row[x >> 3] |= (uint8_t)(0x80 >> (x & 7));
+    fwrite(row, 1, sizeof(row), f);
+  }
+  return fclose(f) == 0;
+}
+
+// Reads a P4 of exactly FB_WIDTH×FB_HEIGHT into rows of packed bits
+// (PBM order: MSB = leftmost). Returns false if missing or malformed.
+inline bool readPbm(const char *path, uint8_t rows[FB_HEIGHT][FB_WIDTH / 8])
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  int w = 0, h = 0;
+  bool ok = fscanf(f, "P4 %d %d", &w, &h) == 2 && w == FB_WIDTH && h == FB_HEIGHT &&
+            fgetc(f) != EOF && fread(rows, 1, FB_HEIGHT * FB_WIDTH / 8, f) == FB_HEIGHT * FB_WIDTH / 8;
+  fclose(f);
+  return ok;
+}
+
+// Pixels where `t` differs from a PBM image
+inline int pbmDiffPixels(const MemoryTarget &t, const uint8_t rows[FB_HEIGHT][FB_WIDTH / 8])
+{
+  int diff = 0;
+  for (int y = 0; y < FB_HEIGHT; y++)
+    for (int x = 0; x < FB_WIDTH; x++)
+      diff += t.lit(x, y) != (bool)((rows[y][x >> 3] >> (7 - (x & 7))) & 1);
+  return diff;
+}
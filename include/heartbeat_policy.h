@@ -0,0 +1,77 @@
+// ============================================
+// ADAPTIVE HEARTBEAT
+// ============================================
+// Transmitter-side heartbeat interval. Starts at the minimum after
+// power-on and after every state change (the first minutes of a game
+// or an open court are when a missed packet matters most), doubles
+// after a run of ACKed sends, and drops back to the minimum as soon
+// as a send goes unACKed. Each frame advertises the interval to the
+// next heartbeat (PACKET_EXT_INTERVAL_S) so the receiver can size
+// that court's fault deadline to match.
+
+#pragma once
+
+#include <cstdint>
+
+#ifndef HEARTBEAT_MIN_SEC
+#define HEARTBEAT_MIN_SEC 15
+#endif
+#ifndef HEARTBEAT_MAX_SEC
+#define HEARTBEAT_MAX_SEC 120
+#endif
+#ifndef HEARTBEAT_STABLE_SENDS
+#define HEARTBEAT_STABLE_SENDS 2 // consecutive ACKs before the interval doubles
+#endif
+
+struct HeartbeatPolicy
+{
+  uint16_t intervalS;
+  uint8_t streak; // ACKed sends at the current interval
+};
+
+inline void initHeartbeat(HeartbeatPolicy &p)
+{
+  p.intervalS = HEARTBEAT_MIN_SEC;
+  p.streak = 0;
+}
+
+// Court changed state: report tightly again until the link proves stable
+inline void heartbeatStateChanged(HeartbeatPolicy &p)
+{
+  initHeartbeat(p);
+}
+
+// Interval that will apply if the send about to go out is ACKed. This
+// is what the frame advertises. If the frame arrives but its ACK is
+// lost, the receiver still takes the longer interval while the sender
+// falls back to the minimum, so the next heartbeat comes early and the
+// receiver's Fault deadline is only more lenient than it needs to be.
+inline uint16_t heartbeatNextIfAcked(const HeartbeatPolicy &p)
+{
+  if (p.streak + 1 < HEARTBEAT_STABLE_SENDS)
+    return p.intervalS;
+  uint32_t doubled = (uint32_t)p.intervalS * 2;
+  return doubled > HEARTBEAT_MAX_SEC ? HEARTBEAT_MAX_SEC : (uint16_t)doubled;
+}
+
+// Fold in the outcome of a send; returns seconds until the next heartbeat
+inline uint16_t heartbeatAfterSend(HeartbeatPolicy &p, bool acked)
+{
+  if (!acked)
+  {
+    initHeartbeat(p);
+    return p.intervalS;
+  }
+
+  uint16_t next = heartbeatNextIfAcked(p);
+  if (next != p.intervalS)
+  {
+    p.intervalS = next;
+    p.streak = 0;
+  }
+  else if (p.streak < 0xFF)
+  {
+    p.streak++;
+  }
+  return p.intervalS;
+}
@@ -0,0 +1,263 @@
+// ============================================
+// INSTRUMENTATION
+// ============================================
+// Scoped timers feeding fixed-bucket latency histograms, for the
+// receiver's hot paths (packet handling, rendering, the I2C flush,
+// loop scheduling). Time comes from the CPU cycle counter on the
+// ESP32 and from steady_clock natively, so benchmarks and tests use
+// the same histograms the firmware dumps.
+//
+// Buckets are log-linear: four per power of two, so a percentile is
+// reported as its bucket's upper edge and is at most 25% high. Each
+// histogram is a few hundred bytes with no allocation; recording is
+// a handful of integer ops.
+//
+// With INSTRUMENTATION_ENABLED 0 the INSTR_* macros expand to nothing
+// and their arguments are not evaluated.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifndef INSTRUMENTATION_ENABLED
+#define INSTRUMENTATION_ENABLED 1
+#endif
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+// ============================================
+// CLOCK
+// ============================================
+
+#ifdef ARDUINO
+// CPU cycles; wraps every ~18 s at 240 MHz, far above any probe span
+inline uint32_t instrStamp()
+{
+  return ESP.getCycleCount();
+}
+
+inline uint32_t instrStampToUs(uint32_t ticks)
+{
+  static const uint32_t perUs = getCpuFrequencyMhz();
+  return ticks / perUs;
+}
+#else
+// Microseconds since the first call
+inline uint32_t instrStamp()
+{
+  using Clock = std::chrono::steady_clock;
+  static const Clock::time_point epoch = Clock::now();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - epoch).count();
+}
+
+inline uint32_t instrStampToUs(uint32_t ticks)
+{
+  return ticks;
+}
+#endif
+
+// Microseconds from `start` (an instrStamp()) to now
+inline uint32_t instrElapsedUs(uint32_t start)
+{
+  return instrStampToUs(instrStamp() - start);
+}
+
+// ============================================
+// HISTOGRAM
+// ============================================
+
+// Values up to 2^INSTR_HIST_MAX_LOG2 µs (~134 s) get their own
+// bucket; anything larger lands in the last one
+#define INSTR_HIST_MAX_LOG2 27
+#define INSTR_HIST_SUB 4 // buckets per power of two
+#define INSTR_HIST_BUCKETS (INSTR_HIST_SUB + (INSTR_HIST_MAX_LOG2 - 1) * INSTR_HIST_SUB)
+
+class LatencyHistogram
+{
+public:
+  LatencyHistogram() { reset(); }
+
+  void reset()
+  {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    sumUs_ = 0;
+    minUs_ = UINT32_MAX;
+    maxUs_ = 0;
+  }
+
+  void record(uint32_t us)
+  {
+    buckets_[bucketOf(us)]++;
+    count_++;
+    sumUs_ += us;
+    if (us < minUs_)
+      minUs_ = us;
+    if (us > maxUs_)
+      maxUs_ = us;
+  }
+
+  uint32_t count() const { return count_; }
+  uint32_t minUs() const { return count_ ? minUs_ : 0; }
+  uint32_t maxUs() const { return maxUs_; }
+  uint32_t meanUs() const { return count_ ? (uint32_t)(sumUs_ / count_) : 0; }
+  uint32_t bucketCount(int i) const { return buckets_[i]; }
+
+  // Smallest bucket upper edge with at least `pct`% of samples at or
+  // below it, capped at the largest sample. 0 when empty.
+  uint32_t percentileUs(uint32_t pct) const
+  {
+    if (count_ == 0)
+      return 0;
+    uint64_t want = ((uint64_t)count_ * pct + 99) / 100;
+    if (want == 0)
+      want = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < INSTR_HIST_BUCKETS; i++)
+    {
+      seen += buckets_[i];
+      if (seen >= want)
+      {
+        uint32_t edge = bucketUpperUs(i);
+        return edge < maxUs_ ? edge : maxUs_;
+      }
+    }
+    return maxUs_;
+  }
+
+  // Values 0-3 map to themselves; above that, 2 bits of mantissa
+  // under the leading one pick one of four buckets per octave
+  static int bucketOf(uint32_t us)
+  {
+    if (us < INSTR_HIST_SUB)
+      return (int)us;
+    int e = 31 - __builtin_clz(us); // >= 2
+    if (e >= INSTR_HIST_MAX_LOG2)
+      return INSTR_HIST_BUCKETS - 1;
+    int sub = (int)((us >> (e - 2)) & (INSTR_HIST_SUB - 1));
+    return INSTR_HIST_SUB + (e - 2) * INSTR_HIST_SUB + sub;
+  }
+
+  static uint32_t bucketUpperUs(int i)
+  {
+    if (i < INSTR_HIST_SUB)
+      return (uint32_t)i;
+    int e = (i - INSTR_HIST_SUB) / INSTR_HIST_SUB + 2;
+    int sub = (i - INSTR_HIST_SUB) % INSTR_HIST_SUB;
+    uint32_t lower = (uint32_t)(INSTR_HIST_SUB + sub) << (e - 2);
+    return lower + ((uint32_t)1 << (e - 2)) - 1;
+  }
+
+private:
+  uint32_t buckets_[INSTR_HIST_BUCKETS];
+  uint32_t count_;
+  uint64_t sumUs_;
+  uint32_t minUs_;
+  uint32_t maxUs_;
+};
+
+// Records the lifetime of the enclosing scope
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer(LatencyHistogram &h) : h_(h), start_(instrStamp()) {}
+  ~ScopedTimer() { h_.record(instrElapsedUs(start_)); }
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+  LatencyHistogram &h_;
+  uint32_t start_;
+};
+
+// ============================================
+// RECEIVER PROBES
+// ============================================
+
+enum class Probe : uint8_t
+{
+  RxToState,  // radio callback → court state updated (queue wait + apply)
+  RxToScreen, // radio callback → frame with the change handed to the flush
+  Render,     // drawing one screen into the framebuffer
+  Flush,      // pushing the changed spans over I2C
+  AnimFrame,  // one game-started animation frame, drawn and handed to the flush
+  LoopLate,   // how far past its deadline the state task resumed
+  Count
+};
+
+// Short names: the OLED stats page has room for three characters
+inline const char *probeName(Probe p)
+{
+  static const char *const kNames[] = {"rx", "scr", "rnd", "i2c", "anm", "jit"};
+  return (size_t)p < sizeof(kNames) / sizeof(kNames[0]) ? kNames[(size_t)p] : "?";
+}
+
+class Instruments
+{
+public:
+  LatencyHistogram &operator[](Probe p) { return hist_[(size_t)p]; }
+  const LatencyHistogram &operator[](Probe p) const { return hist_[(size_t)p]; }
+
+  void reset()
+  {
+    for (size_t i = 0; i < (size_t)Probe::Count; i++)
+      hist_[i].reset();
+  }
+
+private:
+  LatencyHistogram hist_[(size_t)Probe::Count];
+};
+
+// ============================================
+// FORMATTING
+// ============================================
+
+// At most 5 characters: "850us", "4.2ms", "120ms", "1.5s", "42s"
+inline void formatDurationUs(char *out, size_t cap, uint32_t us)
+{
+  if (us < 1000)
+    snprintf(out, cap, "%luus", (unsigned long)us);
+  else if (us < 10000)
+    snprintf(out, cap, "%lu.%lums", (unsigned long)(us / 1000), (unsigned long)(us / 100 % 10));
+  else if (us < 1000000)
+    snprintf(out, cap, "%lums", (unsigned long)(us / 1000));
+  else if (us < 10000000)
+    snprintf(out, cap, "%lu.%lus", (unsigned long)(us / 1000000), (unsigned long)(us / 100000 % 10));
+  else
+    snprintf(out, cap, "%lus", (unsigned long)(us / 1000000));
+}
+
+// One summary line for the serial dump and the benchmarks, e.g.
+// "rnd n=120 min=410 p50=447 p90=511 p99=575 max=630 mean=452 us"
+inline int formatHistogramLine(char *out, size_t cap, const char *name, const LatencyHistogram &h)
+{
+  return snprintf(out, cap, "%s n=%lu min=%lu p50=%lu p90=%lu p99=%lu max=%lu mean=%lu us",
+                  name, (unsigned long)h.count(), (unsigned long)h.minUs(),
+                  (unsigned long)h.percentileUs(50), (unsigned long)h.percentileUs(90),
+                  (unsigned long)h.percentileUs(99), (unsigned long)h.maxUs(),
+                  (unsigned long)h.meanUs());
+}
+
+// ============================================
+// PROBE MACROS
+// ============================================
+
+#define INSTR_CAT_(a, b) a##b
+#define INSTR_CAT(a, b) INSTR_CAT_(a, b)
+
+#if INSTRUMENTATION_ENABLED
+#define INSTR_SCOPE(hist) ScopedTimer INSTR_CAT(instrScope_, __LINE__)(hist)
+#define INSTR_RECORD(hist, us) (hist).record(us)
+#define INSTR_STAMP() instrStamp()
+#else
+#define INSTR_SCOPE(hist)
+#define INSTR_RECORD(hist, us)
+#define INSTR_STAMP() 0u
+#endif
@@ -0,0 +1,110 @@
+// ============================================
+// LINK TRACKING
+// ============================================
+// Per-source sequence tracking for v2 frames: suppresses
+// duplicates (ESP-NOW retries, relays forwarding the same frame
+// twice), drops frames that arrive after a newer one, and counts
+// sequence gaps as lost frames. Legacy frames carry no sequence
+// number and always pass.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "court_packet.h"
+
+// Uptime going backwards by more than this means the sender rebooted
+#define LINK_REBOOT_SLACK_S 2
+
+enum class SeqResult : uint8_t
+{
+  Fresh,     // new frame — apply it
+  Duplicate, // same seq as the last accepted frame
+  Stale      // older than the last accepted frame (reordered)
+};
+
+struct LinkState
+{
+  bool seen;
+  uint16_t lastSeq;
+  uint32_t lastUptimeS;
+  uint32_t lastRxMs;
+  uint8_t batteryPct;
+  uint32_t received; // fresh frames accepted
+  uint32_t duplicates;
+  uint32_t stale;
+  uint32_t lost; // frames never seen, inferred from sequence gaps
+  uint32_t reboots;
+  uint16_t awakeMs;      // last reported wake-to-sleep time (PACKET_EXT_AWAKE_MS)
+  uint32_t awakeTotalMs; // sum of reports, for the average
+  uint32_t awakeReports;
+  uint16_t pressMs;      // last reported press-to-send time (PACKET_EXT_PRESS_MS)
+  uint32_t pressTotalMs;
+  uint32_t pressReports;
+};
+
+template <size_t MaxSources>
+class LinkTracker
+{
+public:
+  LinkTracker() { reset(); }
+
+  void reset()
+  {
+    for (size_t i = 0; i < MaxSources; i++)
+      links_[i] = LinkState{};
+  }
+
+  SeqResult observe(const CourtFrame &f, uint32_t rxMs)
+  {
+    if (f.version < PACKET_VERSION || f.srcId < 1 || f.srcId > MaxSources)
+      return SeqResult::Fresh; // untracked source
+
+    LinkState &l = links_[f.srcId - 1];
+    bool rebooted = l.seen && f.uptimeS + LINK_REBOOT_SLACK_S < l.lastUptimeS;
+    if (rebooted)
+      l.reboots++;
+
+    if (l.seen && !rebooted)
+    {
+      int16_t delta = (int16_t)(uint16_t)(f.seq - l.lastSeq);
+      if (delta == 0)
+      {
+        l.duplicates++;
+        return SeqResult::Duplicate;
+      }
+      if (delta < 0)
+      {
+        l.stale++;
+        return SeqResult::Stale;
+      }
+      l.lost += (uint32_t)(delta - 1);
+    }
+
+    l.seen = true;
+    l.lastSeq = f.seq;
+    l.lastUptimeS = f.uptimeS;
+    l.lastRxMs = rxMs;
+    l.batteryPct = f.batteryPct;
+    l.received++;
+    if (hasFrameExt(f, PACKET_EXT_AWAKE_MS))
+    {
+      l.awakeMs = f.ext[PACKET_EXT_AWAKE_MS];
+      l.awakeTotalMs += l.awakeMs;
+      l.awakeReports++;
+    }
+    if (hasFrameExt(f, PACKET_EXT_PRESS_MS))
+    {
+      l.pressMs = f.ext[PACKET_EXT_PRESS_MS];
+      l.pressTotalMs += l.pressMs;
+      l.pressReports++;
+    }
+    return SeqResult::Fresh;
+  }
+
+  const LinkState &link(uint8_t srcId) const { return links_[srcId - 1]; }
+  static constexpr size_t maxSources() { return MaxSources; }
+
+private:
+  LinkState links_[MaxSources];
+};
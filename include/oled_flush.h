@@ -0,0 +1,177 @@
+// ============================================
+// OLED DIRTY-REGION TRACKING
+// ============================================
+// Diffs an SSD1306-layout framebuffer (one byte = 8 vertical
+// pixels, 128 bytes per page) against a shadow of what was
+// last sent to the panel and returns the column spans per page
+// that actually changed. The caller pushes only those spans, as
+// the I2C transactions forEachFlushTransfer() lays out.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#define FB_WIDTH 128
+#define FB_HEIGHT 64
+#define FB_PAGES (FB_HEIGHT / 8)
+#define FB_BYTES (FB_WIDTH * FB_PAGES)
+
+// Unchanged runs shorter than this are sent anyway rather than
+// paying for another column/page addressing transaction.
+#ifndef OLED_SPAN_MERGE_GAP
+#define OLED_SPAN_MERGE_GAP 8
+#endif
+#define OLED_MAX_SPANS 32
+
+struct DirtySpan
+{
+  uint8_t page;
+  uint8_t x0; // first changed column (inclusive)
+  uint8_t x1; // last changed column (inclusive)
+};
+
+struct FlushStats
+{
+  uint32_t flushes;
+  uint32_t spans;
+  uint32_t bytes;  // bytes put on the bus, including addressing overhead
+  uint32_t waitUs; // drawing held up by the previous frame still on the bus
+  uint32_t errors; // flushes resent whole after a failed transfer
+};
+
+class FrameDiffer
+{
+public:
+  // Force the next diff to report the whole frame (e.g. after panel init)
+  void invalidate() { valid_ = false; }
+
+  // Compare `fb` with the shadow, record the changed spans in `out`
+  // and copy the new contents into the shadow. Returns the span count.
+  size_t diff(const uint8_t *fb, DirtySpan *out, size_t maxSpans)
+  {
+    size_t n = 0;
+    if (!valid_)
+    {
+      for (uint8_t p = 0; p < FB_PAGES && n < maxSpans; p++)
+        out[n++] = {p, 0, FB_WIDTH - 1};
+      memcpy(shadow_, fb, FB_BYTES);
+      valid_ = true;
+      return n;
+    }
+
+    for (uint8_t p = 0; p < FB_PAGES; p++)
+    {
+      const uint8_t *row = fb + p * FB_WIDTH;
+      uint8_t *shadowRow = shadow_ + p * FB_WIDTH;
+      int open = -1; // index into out[] of the span being grown on this page
+      for (int x = 0; x < FB_WIDTH; x++)
+      {
+        if (row[x] == shadowRow[x])
+          continue;
+        if (open >= 0 && x - out[open].x1 <= OLED_SPAN_MERGE_GAP)
+        {
+          out[open].x1 = (uint8_t)x;
+        }
+        else if (n < maxSpans)
+        {
+          out[n] = {p, (uint8_t)x, (uint8_t)x};
+          open = (int)n++;
+        }
+        else if (open >= 0)
+        {
+          // Out of span slots: widen this page's last span instead
+          out[open].x1 = (uint8_t)x;
+        }
+        else
+        {
+          // No slot at all for this page — leave the shadow stale so
+          // the bytes are picked up by the next flush
+          continue;
+        }
+        shadowRow[x] = row[x];
+      }
+    }
+    return n;
+  }
+
+private:
+  uint8_t shadow_[FB_BYTES];
+  bool valid_ = false;
+};
+
+// ============================================
+// TRANSFER PLAN
+// ============================================
+// A flush as SSD1306 I2C transactions, in bus order. Each starts with
+// a control byte: 0x00 for a command stream, 0x40 for data that lands
+// in the addressed window. Data is sent straight from the framebuffer,
+// so the frame must stay untouched until the transfer is done.
+
+#define OLED_CTRL_COMMANDS 0x00
+#define OLED_CTRL_DATA 0x40
+#define OLED_CMD_COLUMNADDR 0x21
+#define OLED_CMD_PAGEADDR 0x22
+#define OLED_CMD_NORMAL 0xA6
+#define OLED_CMD_INVERT 0xA7
+#define OLED_CMD_NOP 0xE3
+
+struct FlushJob
+{
+  const uint8_t *fb; // the frame the spans index into
+  DirtySpan spans[OLED_MAX_SPANS];
+  uint8_t count;
+  int8_t invert; // -1 = unchanged, else the panel inversion, set before the data
+};
+
+// Calls send(head, headLen, data, dataLen) per transaction: the
+// control and command bytes in `head`, then up to `maxChunk` bytes of
+// frame data (none for commands). Stops early and returns false when
+// send() does (bus error). The differ's shadow already holds the
+// frame by then, so the caller has to invalidate() it and send the
+// inversion again, or the panel stays out of step until those pixels
+// change.
+template <typename Send>
+bool forEachFlushTransfer(const FlushJob &job, size_t maxChunk, Send &&send)
+{
+  if (job.invert >= 0)
+  {
+    const uint8_t inv[] = {OLED_CTRL_COMMANDS, job.invert ? (uint8_t)OLED_CMD_INVERT : (uint8_t)OLED_CMD_NORMAL};
+    if (!send(inv, sizeof(inv), nullptr, 0))
+      return false;
+  }
+
+  static const uint8_t kData[] = {OLED_CTRL_DATA};
+  for (size_t i = 0; i < job.count; i++)
+  {
+    const DirtySpan &sp = job.spans[i];
+    const uint8_t addr[] = {OLED_CTRL_COMMANDS, OLED_CMD_PAGEADDR, sp.page, sp.page,
+                            OLED_CMD_COLUMNADDR, sp.x0, sp.x1};
+    if (!send(addr, sizeof(addr), nullptr, 0))
+      return false;
+
+    const uint8_t *src = job.fb + sp.page * FB_WIDTH + sp.x0;
+    size_t remaining = (size_t)(sp.x1 - sp.x0) + 1;
+    while (remaining > 0)
+    {
+      size_t chunk = remaining < maxChunk ? remaining : maxChunk;
+      if (!send(kData, sizeof(kData), src, chunk))
+        return false;
+      src += chunk;
+      remaining -= chunk;
+    }
+  }
+  return true;
+}
+
+// Bytes a job puts on the bus, one address byte per transaction included
+inline uint32_t flushJobBytes(const FlushJob &job, size_t maxChunk)
+{
+  uint32_t bytes = 0;
+  forEachFlushTransfer(job, maxChunk, [&](const uint8_t *, size_t headLen, const uint8_t *, size_t len)
+                       {
+    bytes += (uint32_t)(1 + headLen + len);
+    return true; });
+  return bytes;
+}
@@ -0,0 +1,303 @@
+// ============================================
+// OLED COURT TABLE RENDERER
+// ============================================
+// Draws the receiver's normal view (title, column headers, one page
+// of court rows) straight into an SSD1306-layout framebuffer, without
+// Adafruit GFX's per-pixel glyph plotting or snprintf:
+//
+//   - The bold "RallyRack" title and the header row + rule are
+//     rasterized once and copied in with memcpy each frame.
+//   - The MM:SS and average columns use a digit atlas pre-shifted to
+//     each row's y offset, so a glyph column is two ORs.
+//   - Everything else (court number, status word, the Avg: header and
+//     the Next: title) is blitted column by column from oled_font.h.
+//
+// Output is pixel-identical to the GFX path it replaces (default
+// font, size 1, no background), which src/bench checks every run.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "oled_flush.h"
+#include "oled_font.h"
+#include "receiver_logic.h"
+#include "court_prediction.h"
+
+// Table layout (px)
+#define TABLE_COL_NUM 0
+#define TABLE_COL_STATUS 18
+#define TABLE_COL_NOW 78
+#define TABLE_COL_AVG 108
+#define TABLE_HEADER_Y 10
+#define TABLE_RULE_Y 19
+#define TABLE_FIRST_ROW_Y 22
+#define TABLE_ROW_PITCH 10
+
+// ============================================
+// BLITTING
+// ============================================
+
+// OR one glyph into `fb` with its top-left at (x, y). Clips at the
+// panel edges like GFX does.
+inline void blitGlyph(uint8_t *fb, int x, int y, char c)
+{
+  if (y < 0 || y >= FB_HEIGHT)
+    return;
+  const uint8_t *cols = fontGlyph(c);
+  int page = y >> 3, shift = y & 7;
+  uint8_t *lo = fb + page * FB_WIDTH;
+  uint8_t *hi = page + 1 < FB_PAGES && shift ? lo + FB_WIDTH : nullptr;
+  for (int i = 0; i < FONT_GLYPH_COLS; i++)
+  {
+    int cx = x + i;
+    if (cx < 0 || cx >= FB_WIDTH || cols[i] == 0)
+      continue;
+    lo[cx] |= (uint8_t)(cols[i] << shift);
+    if (hi)
+      hi[cx] |= (uint8_t)(cols[i] >> (8 - shift));
+  }
+}
+
+// Returns the x after the last glyph
+inline int blitText(uint8_t *fb, int x, int y, const char *s)
+{
+  for (; *s; s++, x += FONT_ADVANCE)
+    blitGlyph(fb, x, y, *s);
+  return x;
+}
+
+inline void blitHLine(uint8_t *fb, int y)
+{
+  uint8_t bit = (uint8_t)(1 << (y & 7));
+  uint8_t *row = fb + (y >> 3) * FB_WIDTH;
+  for (int x = 0; x < FB_WIDTH; x++)
+    row[x] |= bit;
+}
+
+// Decimal digits of v, most significant first. Returns the length.
+inline int formatDecimal(char *out, unsigned long v)
+{
+  char tmp[10];
+  int n = 0;
+  do
+  {
+    tmp[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v && n < (int)sizeof(tmp));
+  for (int i = 0; i < n; i++)
+    out[i] = tmp[n - 1 - i];
+  out[n] = '\0';
+  return n;
+}
+
+// ============================================
+// RENDER CACHE
+// ============================================
+
+class OledRenderCache
+{
+public:
+  OledRenderCache() { build(); }
+
+  // Clear `fb` and lay down the static regions. `title` replaces the
+  // default bold "RallyRack" (e.g. the Next: estimate); nullptr keeps it.
+  void beginFrame(uint8_t *fb, const char *title) const
+  {
+    memset(fb, 0, FB_BYTES);
+    if (title)
+    {
+      blitText(fb, 0, 0, title);
+      blitText(fb, 1, 0, title); // bold via double-print
+    }
+    else
+    {
+      memcpy(fb, titleStrip_, FB_WIDTH);
+    }
+    // Pages 1-2 hold the header row and the rule; the first court row
+    // starts inside page 2 and is ORed on top
+    memcpy(fb + FB_WIDTH, headerStrip_, sizeof(headerStrip_));
+  }
+
+  // One court row from the digit atlas (MM:SS, average) and the font
+  void drawRow(uint8_t *fb, int row, const CourtState &court, int courtNum, uint32_t now) const
+  {
+    int y = TABLE_FIRST_ROW_Y + row * TABLE_ROW_PITCH;
+    char num[12];
+    formatDecimal(num, (unsigned long)courtNum);
+    blitText(fb, TABLE_COL_NUM, y, num);
+
+    const char *status;
+    char clock[6];
+    if (court.inUse && court.inUseSinceMs > 0)
+    {
+      if (courtFaulted(court, now))
+      {
+        status = "Fault";
+        memcpy(clock, "  ??", 5);
+      }
+      else
+      {
+        status = "Started";
+        unsigned long totalSec = (unsigned long)(now - court.inUseSinceMs) / 1000;
+        unsigned long m = totalSec / 60, s = totalSec % 60;
+        if (m > 99)
+          m = 99;
+        clock[0] = (char)('0' + m / 10);
+        clock[1] = (char)('0' + m % 10);
+        clock[2] = ':';
+        clock[3] = (char)('0' + s / 10);
+        clock[4] = (char)('0' + s % 10);
+        clock[5] = '\0';
+      }
+    }
+    else if (court.available)
+    {
+      status = "Open";
+      memcpy(clock, "  --", 5);
+    }
+    else
+    {
+      status = "---";
+      memcpy(clock, " --", 4);
+    }
+    blitText(fb, TABLE_COL_STATUS, y, status);
+    drawAtlas(fb, row, TABLE_COL_NOW, clock);
+
+    // "%2lum", truncated to 5 characters like CourtRowFields::avg. A
+    // 100+ minute average runs off the edge: GFX wraps it, this clips.
+    char avg[12];
+    unsigned long avgMin = minutesFromMs((unsigned long)(court.avgWaitMs + 0.5f));
+    int n = 0;
+    if (avgMin < 10)
+      avg[n++] = ' ';
+    n += formatDecimal(avg + n, avgMin);
+    avg[n++] = 'm';
+    avg[n < 5 ? n : 5] = '\0';
+    drawAtlas(fb, row, TABLE_COL_AVG, avg);
+  }
+
+private:
+  // Glyphs the numeric columns can show
+  static constexpr const char *kAtlasChars = "0123456789:m -?";
+  static constexpr int kAtlasGlyphs = 15;
+
+  void build()
+  {
+    uint8_t fb[FB_BYTES];
+    memset(fb, 0, sizeof(fb));
+    blitText(fb, 0, 0, "RallyRack");
+    blitText(fb, 1, 0, "RallyRack");
+    memcpy(titleStrip_, fb, FB_WIDTH);
+
+    memset(fb, 0, sizeof(fb));
+    blitText(fb, TABLE_COL_NUM, TABLE_HEADER_Y, "#");
+    blitText(fb, TABLE_COL_STATUS, TABLE_HEADER_Y, "Status");
+    blitText(fb, TABLE_COL_NOW, TABLE_HEADER_Y, "Now");
+    blitText(fb, TABLE_COL_AVG, TABLE_HEADER_Y, "Avg");
+    blitHLine(fb, TABLE_RULE_Y);
+    memcpy(headerStrip_, fb + FB_WIDTH, sizeof(headerStrip_));
+
+    for (int i = 0; i < 128; i++)
+      atlasIndex_[i] = 0xFF;
+    for (int g = 0; g < kAtlasGlyphs; g++)
+    {
+      char c = kAtlasChars[g];
+      atlasIndex_[(int)c] = (uint8_t)g;
+      const uint8_t *cols = fontGlyph(c);
+      for (int r = 0; r < COURTS_PER_PAGE; r++)
+      {
+        int shift = (TABLE_FIRST_ROW_Y + r * TABLE_ROW_PITCH) & 7;
+        for (int i = 0; i < FONT_GLYPH_COLS; i++)
+          atlas_[r][g][i] = (uint16_t)(cols[i] << shift);
+      }
+    }
+  }
+
+  // Fixed-width column text from the pre-shifted atlas; characters
+  // outside it fall back to the font
+  void drawAtlas(uint8_t *fb, int row, int x, const char *s) const
+  {
+    int y = TABLE_FIRST_ROW_Y + row * TABLE_ROW_PITCH;
+    uint8_t *lo = fb + (y >> 3) * FB_WIDTH;
+    uint8_t *hi = (y >> 3) + 1 < FB_PAGES ? lo + FB_WIDTH : nullptr;
+    for (; *s; s++, x += FONT_ADVANCE)
+    {
+      unsigned char c = (unsigned char)*s;
+      uint8_t g = c < 128 ? atlasIndex_[c] : 0xFF;
+      if (g == 0xFF || x + FONT_GLYPH_COLS > FB_WIDTH)
+      {
+        blitGlyph(fb, x, y, (char)c);
+        continue;
+      }
+      const uint16_t *cols = atlas_[row][g];
+      for (int i = 0; i < FONT_GLYPH_COLS; i++)
+      {
+        lo[x + i] |= (uint8_t)cols[i];
+        if (hi)
+          hi[x + i] |= (uint8_t)(cols[i] >> 8);
+      }
+    }
+  }
+
+  uint8_t titleStrip_[FB_WIDTH];
+  uint8_t headerStrip_[2 * FB_WIDTH];
+  uint16_t atlas_[COURTS_PER_PAGE][kAtlasGlyphs][FONT_GLYPH_COLS];
+  uint8_t atlasIndex_[128];
+};
+
+// The whole normal view: title (nullptr = default), right-aligned
+// board average, headers and the page of courts starting at
+// `firstCourt` (0-based)
+template <size_t N>
+void renderCourtTable(const OledRenderCache &cache, uint8_t *fb, const CourtState (&courts)[N],
+                      const char *title, unsigned long overallMs, int firstCourt, uint32_t now)
+{
+  cache.beginFrame(fb, title);
+
+  char avg[16] = "Avg:";
+  int n = 4 + formatDecimal(avg + 4, minutesFromMs(overallMs));
+  avg[n++] = 'm';
+  avg[n] = '\0';
+  blitText(fb, FB_WIDTH - FONT_ADVANCE * n, 0, avg);
+
+  for (int r = 0; r < COURTS_PER_PAGE; r++)
+  {
+    int i = firstCourt + r;
+    if (i >= (int)N)
+      break;
+    cache.drawRow(fb, r, courts[i], i + 1, now);
+  }
+}
+
+template <size_t N>
+void renderCourtTable(const OledRenderCache &cache, uint8_t *fb, const BasicSystemState<N> &state,
+                      const char *title, unsigned long overallMs, int firstCourt, uint32_t now)
+{
+  renderCourtTable(cache, fb, state.courts, title, overallMs, firstCourt, now);
+}
+
+// "Next:6 ~3m": court `courtIdx` (0-based) frees up in `remainingMs`.
+// Court ids are 8-bit and minutes are capped at 999, so the longest
+// title, "Next:255 ~999m", fits a 16-byte buffer.
+inline const char *formatNextTitle(char *buf, size_t cap, int courtIdx, uint32_t remainingMs)
+{
+  uint8_t court = (uint8_t)(courtIdx + 1);
+  unsigned long minutes = minutesFromMs(remainingMs);
+  if (minutes > 999)
+    minutes = 999;
+  snprintf(buf, cap, "Next:%u ~%lum", (unsigned)court, minutes);
+  return buf;
+}
+
+// Title while every court is in use: the next-court estimate, e.g.
+// "Next:6 ~3m". Returns nullptr (default title) otherwise.
+template <size_t N>
+const char *nextCourtTitle(char *buf, size_t cap, const CourtPredictor<N> &predictor, uint32_t now)
+{
+  if (predictor.size() != N)
+    return nullptr;
+  return formatNextTitle(buf, cap, predictor.courtAt(0), predictor.remainingMs(0, now));
+}
@@ -0,0 +1,102 @@
+// ============================================
+// OLED EVENT SCREENS
+// ============================================
+// The full-screen "Court X open!" alert and the game-started
+// animation, plus the hidden latency stats page, drawn with the
+// framebuffer.h primitives so the receiver and the native
+// preview/tests produce the same frames. The normal court table lives
+// in oled_render.h.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include "animation.h"
+#include "framebuffer.h"
+#include "instrumentation.h"
+
+inline void drawCourtOpenAlert(FrameTarget &t, int courtNum)
+{
+  uint8_t *fb = t.buffer();
+  memset(fb, 0, FB_BYTES);
+  t.setInverted(false);
+
+  // "Court X" as large as fits the width (size 3 up to court 9)
+  char line[12];
+  snprintf(line, sizeof(line), "Court %d", courtNum);
+  int size = fbTextWidth(line, 3) <= FB_WIDTH ? 3 : 2;
+  fbText(fb, (FB_WIDTH - fbTextWidth(line, size)) / 2, 6, line, size);
+  fbText(fb, (FB_WIDTH - fbTextWidth("open!", 2)) / 2, 38, "open!", 2);
+}
+
+// Frame `f` (0 .. ANIM_TOTAL_FRAMES-1) of the game-started animation.
+// Frame pacing lives in AnimationScheduler; this only draws.
+inline void drawGameStartedFrame(FrameTarget &t, int courtNum, int f)
+{
+  uint8_t *fb = t.buffer();
+  memset(fb, 0, FB_BYTES);
+  char courtLine[12];
+  snprintf(courtLine, sizeof(courtLine), "Court %d", courtNum);
+  const char *sub = "game started!";
+
+  if (f < ANIM_PHASE1_FRAMES)
+  {
+    // Phase 1: bouncing ball + text slides in from top
+    t.setInverted(false);
+    float bt = (float)f / (ANIM_PHASE1_FRAMES - 1); // 0 → 1
+    int ballX = 6 + (int)(bt * 116);
+    float bouncePhase = bt * 3.0f * 3.14159f; // 3 arcs
+    float damping = 1.0f - bt * 0.55f;
+    int ballY = 56 - (int)(fabsf(sinf(bouncePhase)) * 30.0f * damping);
+
+    // Filled ball with tiny black holes — pickleball look
+    fbFillCircle(fb, ballX, ballY, 4);
+    fbPixel(fb, ballX - 1, ballY - 1, false);
+    fbPixel(fb, ballX + 1, ballY - 1, false);
+    fbPixel(fb, ballX, ballY + 1, false);
+
+    // "Court X" slides down from above the screen
+    int slideY = (f >= 9) ? 2 : (-16 + f * 2);
+    fbText(fb, (FB_WIDTH - fbTextWidth(courtLine, 2)) / 2, slideY, courtLine, 2);
+
+    // "game started!" fades in halfway through
+    if (f >= 10)
+      fbText(fb, (FB_WIDTH - fbTextWidth(sub, 1)) / 2, 26, sub, 1);
+  }
+  else
+  {
+    // Phase 2: static text + double border + 3 invert flashes
+    int p2f = f - ANIM_PHASE1_FRAMES;
+    t.setInverted(p2f < 6 && p2f % 2 == 0);
+    fbText(fb, (FB_WIDTH - fbTextWidth(courtLine, 2)) / 2, 10, courtLine, 2);
+    fbText(fb, (FB_WIDTH - fbTextWidth(sub, 1)) / 2, 36, sub, 1);
+
+    // Double border for a stadium feel
+    fbRect(fb, 0, 0, FB_WIDTH, FB_HEIGHT);
+    fbRect(fb, 2, 2, FB_WIDTH - 4, FB_HEIGHT - 4);
+  }
+}
+
+// Hidden stats page: p50 / p99 / max of each probe, one per line
+inline void drawStatsPage(FrameTarget &t, const Instruments &ins)
+{
+  uint8_t *fb = t.buffer();
+  memset(fb, 0, FB_BYTES);
+  t.setInverted(false);
+  fbText(fb, 0, 0, "lat   p50   p99   max", 1);
+  fbHLine(fb, 0, 8, FB_WIDTH);
+  for (size_t i = 0; i < (size_t)Probe::Count; i++)
+  {
+    const LatencyHistogram &h = ins[(Probe)i];
+    char p50[8] = "-", p99[8] = "-", max[8] = "-", line[32];
+    if (h.count() > 0)
+    {
+      formatDurationUs(p50, sizeof(p50), h.percentileUs(50));
+      formatDurationUs(p99, sizeof(p99), h.percentileUs(99));
+      formatDurationUs(max, sizeof(max), h.maxUs());
+    }
+    snprintf(line, sizeof(line), "%-3s%6s%6s%6s", probeName((Probe)i), p50, p99, max);
+    fbText(fb, 0, 10 + 9 * (int)i, line, 1);
+  }
+}
@@ -0,0 +1,97 @@
+// ============================================
+// TRANSMITTER POWER BUDGET
+// ============================================
+// Time-in-state accounting for the court button. The firmware
+// measures how long it spends active, transmitting, light- and
+// deep-sleeping in each court mode; average current is derived
+// from those durations and the per-state currents below
+// (ESP32-C3 datasheet figures plus the arcade LED), so changes to
+// the sleep strategy show up as a number without a bench meter.
+
+#pragma once
+
+#include <cstdint>
+
+#ifndef PWR_ACTIVE_MA
+#define PWR_ACTIVE_MA 22.0f // CPU at 160 MHz, radio off
+#endif
+#ifndef PWR_RADIO_MA
+#define PWR_RADIO_MA 85.0f // WiFi started + ESP-NOW TX burst, averaged
+#endif
+#ifndef PWR_LIGHT_SLEEP_MA
+#define PWR_LIGHT_SLEEP_MA 0.35f // light sleep, RC_FAST kept on for LEDC
+#endif
+#ifndef PWR_DEEP_SLEEP_MA
+#define PWR_DEEP_SLEEP_MA 0.01f
+#endif
+#ifndef PWR_LED_FULL_MA
+#define PWR_LED_FULL_MA 6.5f // arcade LED at 100% duty from 3.3 V
+#endif
+
+enum PowerState : uint8_t
+{
+  PWR_ACTIVE,
+  PWR_RADIO,
+  PWR_LIGHT_SLEEP,
+  PWR_DEEP_SLEEP,
+  PWR_STATE_COUNT
+};
+
+enum PowerMode : uint8_t
+{
+  PWR_MODE_AVAILABLE,
+  PWR_MODE_OCCUPIED,
+  PWR_MODE_COUNT
+};
+
+struct PowerBudget
+{
+  uint32_t ms[PWR_MODE_COUNT][PWR_STATE_COUNT];
+  uint32_t ledFullMs[PWR_MODE_COUNT]; // LED time scaled to 100% duty equivalent
+};
+
+inline void initPowerBudget(PowerBudget &b)
+{
+  for (int m = 0; m < PWR_MODE_COUNT; m++)
+  {
+    for (int s = 0; s < PWR_STATE_COUNT; s++)
+      b.ms[m][s] = 0;
+    b.ledFullMs[m] = 0;
+  }
+}
+
+inline void addPowerTime(PowerBudget &b, PowerMode mode, PowerState state, uint32_t ms)
+{
+  b.ms[mode][state] += ms;
+}
+
+// LED on for `ms` at an average duty of dutyPct (0-100)
+inline void addLedTime(PowerBudget &b, PowerMode mode, uint32_t ms, uint8_t dutyPct)
+{
+  b.ledFullMs[mode] += (uint32_t)((uint64_t)ms * dutyPct / 100);
+}
+
+inline uint32_t modeTotalMs(const PowerBudget &b, PowerMode mode)
+{
+  uint32_t total = 0;
+  for (int s = 0; s < PWR_STATE_COUNT; s++)
+    total += b.ms[mode][s];
+  return total;
+}
+
+// Average supply current over all time spent in `mode`, in mA
+inline float averageCurrentMa(const PowerBudget &b, PowerMode mode)
+{
+  static const float kStateMa[PWR_STATE_COUNT] = {
+      PWR_ACTIVE_MA, PWR_RADIO_MA, PWR_LIGHT_SLEEP_MA, PWR_DEEP_SLEEP_MA};
+
+  uint32_t total = modeTotalMs(b, mode);
+  if (total == 0)
+    return 0.0f;
+
+  double charge = 0; // mA·ms
+  for (int s = 0; s < PWR_STATE_COUNT; s++)
+    charge += (double)b.ms[mode][s] * kStateMa[s];
+  charge += (double)b.ledFullMs[mode] * PWR_LED_FULL_MA;
+  return (float)(charge / total);
+}
@@ -1,18 +1,13 @@
 #pragma once
 
 #include <stdint.h>
+#include "court_packet.h"
 
+// Courts served by one receiver. Override per build (e.g. -DNUM_COURTS=24);
+// all court storage and paging is sized from this at compile time.
+#ifndef NUM_COURTS
 #define NUM_COURTS 8
-
-// ============================================
-// SHARED PACKET PROTOCOL
-// ============================================
-
-struct CourtPacket
-{
-  uint8_t courtId;  // 1-based court number
-  uint8_t occupied; // 1 = in use, 0 = available
-};
+#endif
 
 // ============================================
 // RECEIVER / RACK CONTROLLER CONFIG
@@ -25,8 +20,65 @@ struct CourtPacket
 #define OLED_WIDTH 128
 #define OLED_HEIGHT 64
 #define OLED_I2C_ADDR 0x3D
-#define OLED_UPDATE_MS 500
+#define OLED_REFRESH_MS 5000 // longest the table goes undrawn; clocks, faults and page flips are scheduled
 #define OLED_PAGE_MS 2500
+#define OLED_I2C_HZ 400000   // bus clock for all panel traffic
+#define OLED_I2C_FMP 0       // 1: try Fast-mode Plus, falling back to OLED_I2C_HZ if the panel stops ACKing
+#define OLED_I2C_FMP_HZ 1000000
+#define OLED_ASYNC_FLUSH 1   // 1: a flush task feeds the panel via the ESP-IDF I2C driver while the next frame is drawn
+#define OLED_FLUSH_TIMEOUT_MS 50 // longest one transaction may hold the bus
+#define OLED_I2C_CHUNK 31    // data bytes per Wire write (Wire buffer minus control byte), OLED_ASYNC_FLUSH 0 only
+#define OLED_STATS_MS 10000  // how often bytes-pushed stats are reported on serial
+#define FAST_BOOT 1          // 1: no I2C scan or splash; the restored board is the first frame
+
+// Two pinned tasks (see render_pipeline.h): the state task owns the
+// court board and the radio queue, the render task owns the OLED bus
+#define STATE_TASK_CORE 0      // alongside the WiFi task that queues packets
+#define RENDER_TASK_CORE 1
+#define STATE_TASK_PRIORITY 2  // above rendering: a packet never waits for a flush
+#define RENDER_TASK_PRIORITY 1
+#define RECEIVER_TASK_STACK 8192
+#define FLUSH_TASK_PRIORITY 2  // on the render core, above it: queues each transaction as the last one ends
+#define FLUSH_TASK_STACK 3072
+#define ANIM_QUEUE_DEPTH 8     // game-started animations handed to the render task (power of two)
+
+// The state task sleeps until a packet arrives or something is due;
+// background work (telemetry, sync, event log flush, serial input,
+// reports) runs on this cadence
+#define LOOP_SERVICE_MS 500
+#define ALERT_MS 5000 // how long "Court X open!" holds the screen
+
+// Packet queue between the ESP-NOW callback and the state task (power of two)
+#define RX_QUEUE_DEPTH 32
+
+// Link tracking: sources are court transmitters (srcId = COURT_ID) plus
+// a few ids above the court range reserved for relays/hubs
+#define LINK_MAX_SOURCES (NUM_COURTS + 8)
+#define LINK_STATS_MS 60000 // per-source loss/battery summary on serial
+
+// Court event log on the LittleFS partition (see event_log.h)
+#define EVENT_LOG_DIR "/littlefs"
+
+// Binary telemetry on the USB serial port (see telemetry.h); text log
+// lines keep working alongside it. Per-packet heartbeat lines are off
+// by default: with 8+ courts they are most of the UART traffic.
+#define TELEMETRY_ENABLED 1
+#define TELEMETRY_DELTA_MS 500     // changed courts at most this often
+#define TELEMETRY_SNAPSHOT_MS 10000 // full board for readers joining mid-stream
+#define LOG_HEARTBEATS 0
+
+// Acknowledged delta sync (see state_sync.h) for a dashboard bridge
+// that writes ACKs back over the same port. Replaces the one-way
+// telemetry stream when enabled.
+#define SYNC_ENABLED 0
+#define SYNC_INTERVAL_MS 500 // changes are batched this long
+#define SYNC_RETRY_MS 1000   // resend until the bridge ACKs
+
+// Latency probes (see instrumentation.h). On the serial port 's'
+// dumps the histograms, 'r' resets them and 'p' toggles the hidden
+// OLED stats page, as does the BOOT button. 0 compiles every probe out.
+#define INSTRUMENTATION_ENABLED 1
+#define STATS_BUTTON_PIN 0 // QT Py S3 BOOT button, active low
 
 // Debounce
 #define DEBOUNCE_MS 200
@@ -40,16 +92,48 @@ struct CourtPacket
 // Pin assignments
 #define BUTTON_PIN GPIO_NUM_3 // wake-capable GPIO on ESP32-C3
 #define LED_PIN 10            // confirmation LED
+// #define BATTERY_ADC_PIN 0   // LiPo sense via 1:2 divider; reported as unknown if unset
 
 // Timing
 #define LED_FLASH_MS 300
+#define LED_PWM_HZ 5000
+#define LED_PULSE_HALF_MS 1000 // available-mode pulse: fade up, then down, over ~2 s
 #define SEND_TIMEOUT_MS 1000
-#define HEARTBEAT_SEC 15       // re-broadcast state every N seconds
-#define FAULT_TIMEOUT_MS 45000 // 3× heartbeat — court goes Fault if no packet received
+#define HEARTBEAT_SEC 15       // re-broadcast state every N seconds (adaptive minimum)
+#define HEARTBEAT_MIN_SEC HEARTBEAT_SEC
+#define HEARTBEAT_MAX_SEC 120  // stable link + unchanged state backs off up to this
+#define FAULT_TIMEOUT_MS 45000 // 3× heartbeat — Fault deadline for senders that do not advertise an interval
+
+// Unacknowledged presses wait in an RTC-memory journal (tx_journal.h)
+// and are resent, dated from the press, until the receiver ACKs them
+#define TX_JOURNAL_DEPTH 8     // transitions kept while the link is down
+#define TX_COALESCE_MS 3000    // a press undone this quickly is never sent
+#define TX_RETRY_BASE_MS 25    // first retry delay, doubled per failure, jittered
+#define TX_RETRY_MAX_MS 60000  // longest retry delay (heartbeats also flush the journal)
+#define TX_RETRY_INLINE_MS 200 // retries this soon are waited out awake; later ones sleep first
+
+// Court state is kept in RTC memory (tx_state.h) and written to NVS
+// lazily, off the press-to-send path
+#define TX_NVS_LAZY 1             // 0 = write NVS on every press, as before (for comparing timings)
+#define TX_NVS_COMMIT_MS 600000   // a changed state reaches NVS within 10 min...
+#define TX_NVS_LOW_BATT_PCT 10    // ...or right away once the battery is this low
+
+// The channel the receiver ACKed on is cached in RTC memory (tx_channel.h)
+#define TX_CHANNEL_RELEARN_FAILS 4 // failed sends in a row before every channel is probed again
+#define TX_CHANNEL_PROBE_MAX_SKIP 64 // failed probes back off to at most one per this many sends
+
+// Power logging on the transmitter's USB serial ([POWER] lines)
+#define POWER_LOG 1
+#define POWER_LOG_MS 60000         // available mode: summary every minute
+#define POWER_LOG_EVERY_WAKES 20   // occupied mode: summary every N heartbeat wakes
 
 // ============================================
 // SHARED CONFIG
 // ============================================
 
+// WiFi channel the receiver parks its radio on for ESP-NOW (1-13).
+// Transmitters try it first and probe the others if it stays silent.
+#define ESPNOW_CHANNEL 1
+
 // Receiver MAC address
 uint8_t RECEIVER_MAC[] = {0xB4, 0x3A, 0x45, 0xB0, 0xD5, 0x14};
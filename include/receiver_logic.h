@@ -1,16 +1,22 @@
 // ============================================
 // RECEIVER LOGIC (Testable Functions)
 // ============================================
-// Core state machine and calculation logic
-// extracted for unit testing
+// Core state machine and calculation logic, shared
+// by the receiver firmware and the native test and
+// preview builds
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <cstdio>
+#include "court_packet.h"
+#include "wait_stats.h"
 
+#ifndef NUM_COURTS
 #define NUM_COURTS 8
+#endif
 
 // ============================================
 // TIME CALCULATIONS
@@ -25,6 +31,16 @@ inline unsigned long minutesFromMs(unsigned long valueMs)
 #define FAULT_TIMEOUT_MS 45000
 #endif
 
+// Per-court fault deadline as a multiple of the heartbeat interval the
+// transmitter advertises; FAULT_TIMEOUT_MS covers senders that do not
+#ifndef FAULT_HEARTBEAT_MULT
+#define FAULT_HEARTBEAT_MULT 3
+#endif
+
+#ifndef OLED_PAGE_MS
+#define OLED_PAGE_MS 2500
+#endif
+
 inline void fmtMMSS(char *buf, size_t sz, unsigned long ms)
 {
   unsigned long totalSec = ms / 1000;
@@ -39,28 +55,52 @@ inline void fmtMMSS(char *buf, size_t sz, unsigned long ms)
 // COURT STATE & STATISTICS
 // ============================================
 
+// Packed per-court record: 32-bit millis() timestamps first, flags
+// last, so the whole court board is a small contiguous array that
+// the display and packet paths walk linearly.
 struct CourtState
 {
-  bool available;
-  bool inUse;
-  unsigned long availableSinceMs;
-  unsigned long inUseSinceMs;
+  uint32_t availableSinceMs;
+  uint32_t inUseSinceMs;
+  uint32_t lastHeardMs;
+  uint32_t lastResetPressMs;
+  uint32_t faultTimeoutMs; // 0 = FAULT_TIMEOUT_MS
   float avgWaitMs;
   uint32_t waitSamples;
-  unsigned long lastHeardMs;
-  unsigned long lastResetPressMs;
+  bool available;
+  bool inUse;
 };
 
-struct SystemState
+// Court board sized exactly at compile time. Every function below is
+// templated on the court count, so one receiver build can serve 8 or
+// 64 courts without paying for unused slots.
+template <size_t N>
+struct BasicSystemState
 {
-  CourtState courts[NUM_COURTS];
+  static_assert(N >= 1 && N <= 255, "court ids are a uint8_t (1..255)");
+  static constexpr int kCourts = (int)N;
+
+  CourtState courts[N];
+  uint64_t totalGameMs; // sum of every recorded game, for an O(1) overall average
+  uint32_t totalGames;
+
+  // Streaming statistics, kept apart from the hot court array
+  WaitStats waits[N];
+  WaitStats allWaits;
 };
 
+using SystemState = BasicSystemState<NUM_COURTS>;
+
 // Initialize system state
-inline void initSystemState(SystemState &state)
+template <size_t N>
+void initSystemState(BasicSystemState<N> &state)
 {
-  for (int i = 0; i < NUM_COURTS; i++)
+  state.totalGameMs = 0;
+  state.totalGames = 0;
+  initWaitStats(state.allWaits);
+  for (int i = 0; i < (int)N; i++)
   {
+    initWaitStats(state.waits[i]);
     state.courts[i].available = false;
     state.courts[i].inUse = false;
     state.courts[i].availableSinceMs = 0;
@@ -69,16 +109,18 @@ inline void initSystemState(SystemState &state)
     state.courts[i].waitSamples = 0;
     state.courts[i].lastHeardMs = 0;
     state.courts[i].lastResetPressMs = 0;
+    state.courts[i].faultTimeoutMs = 0;
   }
 }
 
 // Get global average wait time
-inline unsigned long globalAverageWaitMs(const SystemState &state)
+template <size_t N>
+unsigned long globalAverageWaitMs(const BasicSystemState<N> &state)
 {
   uint64_t weightedSum = 0;
   uint32_t sampleCount = 0;
 
-  for (int i = 0; i < NUM_COURTS; i++)
+  for (int i = 0; i < (int)N; i++)
   {
     weightedSum += (uint64_t)state.courts[i].avgWaitMs * state.courts[i].waitSamples;
     sampleCount += state.courts[i].waitSamples;
@@ -90,14 +132,35 @@ inline unsigned long globalAverageWaitMs(const SystemState &state)
   return weightedSum / sampleCount;
 }
 
+// Same figure from the running totals: constant time regardless of
+// court count, so the display tick does not walk the whole board.
+// Only games recorded through recordGame() are counted.
+template <size_t N>
+unsigned long overallAverageMs(const BasicSystemState<N> &state)
+{
+  if (state.totalGames == 0)
+    return 0;
+  return (unsigned long)(state.totalGameMs / state.totalGames);
+}
+
+// Best answer to "how long is a game right now": the last 60 minutes
+// when any game ended in them, otherwise the lifetime average
+template <size_t N>
+unsigned long currentWaitMs(BasicSystemState<N> &state, uint32_t now)
+{
+  uint32_t recent = windowMeanMs(state.allWaits, now, false);
+  return recent ? recent : overallAverageMs(state);
+}
+
 // ============================================
 // STATE TRANSITIONS
 // ============================================
 
 // Simulate receiving a transmitter signal (court available)
-inline void simulateCourtAvailable(SystemState &state, int courtId, unsigned long now)
+template <size_t N>
+void simulateCourtAvailable(BasicSystemState<N> &state, int courtId, unsigned long now)
 {
-  if (courtId < 1 || courtId > NUM_COURTS)
+  if (courtId < 1 || courtId > (int)N)
     return;
 
   int idx = courtId - 1;
@@ -118,9 +181,10 @@ inline void simulateCourtAvailable(SystemState &state, int courtId, unsigned lon
 }
 
 // Simulate court becoming occupied (button press, game starts)
-inline void simulateCourtOccupied(SystemState &state, int courtId, unsigned long now, uint32_t debounceMs = 0)
+template <size_t N>
+void simulateCourtOccupied(BasicSystemState<N> &state, int courtId, unsigned long now, uint32_t debounceMs = 0)
 {
-  if (courtId < 1 || courtId > NUM_COURTS)
+  if (courtId < 1 || courtId > (int)N)
     return;
 
   int idx = courtId - 1;
@@ -136,78 +200,247 @@ inline void simulateCourtOccupied(SystemState &state, int courtId, unsigned long
   state.courts[idx].lastResetPressMs = now;
 }
 
+// Fold a finished game (ending at `now`) into the court's rolling
+// average (Welford), the board-wide totals and the streaming stats
+template <size_t N>
+void recordGame(BasicSystemState<N> &state, CourtState &court, uint32_t gameMs, uint32_t now)
+{
+  court.waitSamples++;
+  court.avgWaitMs += (gameMs - court.avgWaitMs) / court.waitSamples;
+  state.totalGameMs += gameMs;
+  state.totalGames++;
+  addWaitSample(state.waits[&court - state.courts], gameMs, now);
+  addWaitSample(state.allWaits, gameMs, now);
+}
+
+// Close out the current game (if any) and mark the court open
+template <size_t N>
+void freeCourt(BasicSystemState<N> &state, CourtState &court, uint32_t now)
+{
+  if (court.inUse && court.inUseSinceMs > 0)
+    recordGame(state, court, now - court.inUseSinceMs, now);
+
+  court.inUse = false;
+  court.inUseSinceMs = 0;
+  court.available = true;
+  court.availableSinceMs = now;
+}
+
 // Simulate court becoming available (game ends, button pressed when occupied)
-inline void simulateCourtFreed(SystemState &state, int courtId, unsigned long now)
+template <size_t N>
+void simulateCourtFreed(BasicSystemState<N> &state, int courtId, unsigned long now)
 {
-  if (courtId < 1 || courtId > NUM_COURTS)
+  if (courtId < 1 || courtId > (int)N)
     return;
 
-  int idx = courtId - 1;
+  CourtState &court = state.courts[courtId - 1];
+  freeCourt(state, court, now);
+  court.lastHeardMs = now;
+}
 
-  // Record game duration into rolling average
-  if (state.courts[idx].inUse && state.courts[idx].inUseSinceMs > 0)
+// Boot default on the rack: every court open since `now`
+template <size_t N>
+void openAllCourts(BasicSystemState<N> &state, unsigned long now)
+{
+  for (int i = 0; i < (int)N; i++)
   {
-    unsigned long gameMs = now - state.courts[idx].inUseSinceMs;
-    state.courts[idx].waitSamples++;
-    state.courts[idx].avgWaitMs += (gameMs - state.courts[idx].avgWaitMs) / state.courts[idx].waitSamples;
+    state.courts[i].available = true;
+    state.courts[i].availableSinceMs = now;
   }
+}
 
-  state.courts[idx].inUse = false;
-  state.courts[idx].inUseSinceMs = 0;
-  state.courts[idx].available = true;
-  state.courts[idx].availableSinceMs = now;
-  state.courts[idx].lastHeardMs = now;
+// ============================================
+// PACKET HANDLING
+// ============================================
+
+enum class PacketResult : uint8_t
+{
+  Rejected,  // malformed / unknown court — state untouched
+  Heartbeat, // state unchanged, court stamped as alive
+  Occupied,  // available/idle → in use (game started)
+  Freed      // in use/idle → available (game ended)
+};
+
+// Single entry point for transmitter packets. Used by the firmware
+// and by every native harness, so they all run the same state machine.
+// `now` dates the state change; `heardMs` is when the packet arrived,
+// later than `now` for a change the sender journaled while offline.
+template <size_t N>
+PacketResult applyPacket(BasicSystemState<N> &state, const CourtPacket &pkt, uint32_t now, uint32_t heardMs)
+{
+  if (pkt.courtId < 1 || pkt.courtId > N)
+    return PacketResult::Rejected;
+
+  CourtState &court = state.courts[pkt.courtId - 1];
+  court.lastHeardMs = heardMs; // stamp on every packet — used for fault detection
+
+  if (pkt.occupied)
+  {
+    if (court.inUse)
+      return PacketResult::Heartbeat;
+    court.available = false;
+    court.availableSinceMs = 0;
+    court.inUse = true;
+    court.inUseSinceMs = now;
+    return PacketResult::Occupied;
+  }
+
+  if (court.available)
+    return PacketResult::Heartbeat;
+  freeCourt(state, court, now);
+  return PacketResult::Freed;
+}
+
+template <size_t N>
+PacketResult applyPacket(BasicSystemState<N> &state, const CourtPacket &pkt, uint32_t now)
+{
+  return applyPacket(state, pkt, now, now);
+}
+
+// When record `i` of a frame received at `rxMs` happened: backdated by
+// the age the sender attached, but never before the court's current
+// state began, so game durations stay non-negative
+template <size_t N>
+uint32_t recordTimeMs(const BasicSystemState<N> &state, const CourtFrame &f, int i, uint32_t rxMs)
+{
+  uint32_t at = rxMs - recordAgeMs(f, i);
+  uint8_t id = f.records[i].courtId;
+  if (id < 1 || id > N)
+    return rxMs;
+  const CourtState &court = state.courts[id - 1];
+  uint32_t since = court.inUse ? court.inUseSinceMs : court.available ? court.availableSinceMs : 0;
+  if (since != 0 && (int32_t)(at - since) < 0)
+    at = since;
+  return at;
+}
+
+// Size each court's fault deadline from the heartbeat interval its
+// sender advertised in this frame. Frames without the field (legacy
+// or fixed-interval senders) fall back to FAULT_TIMEOUT_MS.
+template <size_t N>
+void noteHeartbeatInterval(BasicSystemState<N> &state, const CourtFrame &f)
+{
+  uint32_t timeoutMs = 0;
+  if (hasFrameExt(f, PACKET_EXT_INTERVAL_S) && f.ext[PACKET_EXT_INTERVAL_S] > 0)
+    timeoutMs = (uint32_t)f.ext[PACKET_EXT_INTERVAL_S] * 1000UL * FAULT_HEARTBEAT_MULT;
+
+  for (int i = 0; i < f.count; i++)
+  {
+    uint8_t id = f.records[i].courtId;
+    if (id >= 1 && id <= N)
+      state.courts[id - 1].faultTimeoutMs = timeoutMs;
+  }
 }
 
 // ============================================
 // DISPLAY HELPERS
 // ============================================
 
-// Get display text for a court (for testing)
-class CourtDisplayText
+#define COURTS_PER_PAGE 4
+
+// Number of OLED table pages needed for N courts
+template <size_t N>
+constexpr int courtPageCount()
 {
-public:
-  char buffer[50];
+  return (int)((N + COURTS_PER_PAGE - 1) / COURTS_PER_PAGE);
+}
 
-  void generate(const CourtState &court, int courtNum, unsigned long now)
+// Page shown at `now`: the table rotates every OLED_PAGE_MS
+template <size_t N>
+int courtPageAt(uint32_t now)
+{
+  return (int)((now / OLED_PAGE_MS) % (uint32_t)courtPageCount<N>());
+}
+
+// Column strings for one court row, padded the way the OLED table
+// draws them: # @ 0, Status @ 18, Now @ 78, Avg @ 108.
+struct CourtRowFields
+{
+  char num[4];
+  char status[8];
+  char now[7]; // MM:SS + null
+  char avg[6]; // "99m" + null
+};
+
+inline bool courtFaulted(const CourtState &court, uint32_t now, uint32_t timeoutMs)
+{
+  return (court.lastHeardMs > 0) && (now - court.lastHeardMs > timeoutMs);
+}
+
+// Against the court's own deadline (see noteHeartbeatInterval)
+inline bool courtFaulted(const CourtState &court, uint32_t now)
+{
+  return courtFaulted(court, now, court.faultTimeoutMs ? court.faultTimeoutMs : FAULT_TIMEOUT_MS);
+}
+
+// Whether `f`, received at `rxMs`, names a court that courtFaulted()
+// shows as Fault: applying it clears the Fault on screen. Call before
+// noteHeartbeatInterval() and the records are applied.
+template <size_t N>
+bool frameClearsFault(const BasicSystemState<N> &state, const CourtFrame &f, uint32_t rxMs)
+{
+  for (int i = 0; i < f.count; i++)
   {
-    unsigned long avgMin = minutesFromMs((unsigned long)(court.avgWaitMs + 0.5f));
+    uint8_t id = f.records[i].courtId;
+    if (id >= 1 && id <= N && courtFaulted(state.courts[id - 1], rxMs))
+      return true;
+  }
+  return false;
+}
 
-    char numStr[4];
-    char statusStr[8];
-    char nowStr[7];
-    char avgStr[6];
+inline void formatCourtRow(const CourtState &court, int courtNum, uint32_t now, CourtRowFields &f)
+{
+  unsigned long avgMin = minutesFromMs((unsigned long)(court.avgWaitMs + 0.5f));
+  if (avgMin > 9999)
+    avgMin = 9999; // "9999m" fills f.avg
 
-    snprintf(numStr, sizeof(numStr), "%d", courtNum);
-    snprintf(avgStr, sizeof(avgStr), "%lum", avgMin);
+  snprintf(f.num, sizeof(f.num), "%d", courtNum);
+  snprintf(f.avg, sizeof(f.avg), "%2lum", avgMin);
 
-    if (court.inUse && court.inUseSinceMs > 0)
-    {
-      bool fault = (court.lastHeardMs > 0) &&
-                   (now - court.lastHeardMs > FAULT_TIMEOUT_MS);
-      if (fault)
-      {
-        snprintf(statusStr, sizeof(statusStr), "Fault");
-        snprintf(nowStr, sizeof(nowStr), "??");
-      }
-      else
-      {
-        snprintf(statusStr, sizeof(statusStr), "Started");
-        fmtMMSS(nowStr, sizeof(nowStr), now - court.inUseSinceMs);
-      }
-    }
-    else if (court.available)
+  if (court.inUse && court.inUseSinceMs > 0)
+  {
+    if (courtFaulted(court, now))
     {
-      snprintf(statusStr, sizeof(statusStr), "Open");
-      snprintf(nowStr, sizeof(nowStr), "--");
+      snprintf(f.status, sizeof(f.status), "Fault");
+      snprintf(f.now, sizeof(f.now), "  ??");
     }
     else
     {
-      snprintf(statusStr, sizeof(statusStr), "---");
-      snprintf(nowStr, sizeof(nowStr), "--");
+      snprintf(f.status, sizeof(f.status), "Started");
+      fmtMMSS(f.now, sizeof(f.now), now - court.inUseSinceMs);
     }
+  }
+  else if (court.available)
+  {
+    snprintf(f.status, sizeof(f.status), "Open");
+    snprintf(f.now, sizeof(f.now), "  --");
+  }
+  else
+  {
+    snprintf(f.status, sizeof(f.status), "---");
+    snprintf(f.now, sizeof(f.now), " --");
+  }
+}
+
+inline const char *skipPadding(const char *s)
+{
+  while (*s == ' ')
+    s++;
+  return s;
+}
+
+// Get display text for a court (for testing)
+class CourtDisplayText
+{
+public:
+  char buffer[50];
 
-    snprintf(buffer, sizeof(buffer), "%s %s %s %s", numStr, statusStr, nowStr, avgStr);
+  void generate(const CourtState &court, int courtNum, unsigned long now)
+  {
+    CourtRowFields f;
+    formatCourtRow(court, courtNum, now, f);
+    snprintf(buffer, sizeof(buffer), "%s %s %s %s",
+             f.num, f.status, skipPadding(f.now), skipPadding(f.avg));
   }
 
   const char *str() const { return buffer; }
@@ -0,0 +1,180 @@
+// ============================================
+// STATE / RENDER SPLIT
+// ============================================
+// The receiver runs two pinned FreeRTOS tasks. The state task owns the
+// court board: it drains the radio queue, applies packets, runs the
+// timer wheel, the event log and the serial traffic. The render task
+// owns the OLED and its I2C bus. Neither waits for the other.
+//
+// The state task hands the render task a BoardSnapshot, a copy of
+// everything the screens draw, through a triple-buffered mailbox:
+// publishing never blocks, and the render task always picks up the
+// newest complete copy, skipping any it was too busy to draw. Frames
+// are built in the back half of a FramePair while the front half is
+// on its way to the panel.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "receiver_logic.h"
+#include "court_prediction.h"
+#include "oled_flush.h"
+#include "oled_render.h"
+
+// ============================================
+// BOARD SNAPSHOT
+// ============================================
+
+template <size_t N>
+struct BoardSnapshot
+{
+  uint32_t version; // bumps on every publish
+  CourtState courts[N];
+  uint32_t overallMs;    // "Avg:" in the title
+  int16_t nextCourt;     // court (0-based) the "Next:" title names, -1 = default title
+  uint32_t nextFreeAtMs; // when it is predicted to free up
+  int8_t alertCourtId;   // "Court X open!" on screen, -1 = none
+  bool statsPage;        // hidden latency page instead of the table
+  uint32_t changeStamp;  // receipt of the oldest change not yet shown, 0 = none
+};
+
+// Fill the board part of `s`; the caller sets version, alert, stats
+// page and change stamp
+template <size_t N>
+void takeBoardSnapshot(BoardSnapshot<N> &s, const BasicSystemState<N> &state,
+                       const CourtPredictor<N> &predictor, uint32_t overallMs, uint32_t now)
+{
+  for (size_t i = 0; i < N; i++)
+    s.courts[i] = state.courts[i];
+  s.overallMs = overallMs;
+  if (predictor.size() == N)
+  {
+    s.nextCourt = (int16_t)predictor.courtAt(0);
+    s.nextFreeAtMs = now + predictor.remainingMs(0, now);
+  }
+  else
+  {
+    s.nextCourt = -1;
+    s.nextFreeAtMs = 0;
+  }
+}
+
+// Title for the snapshot at `now`, as nextCourtTitle() gives it for the
+// live predictor
+template <size_t N>
+const char *snapshotTitle(char *buf, size_t cap, const BoardSnapshot<N> &s, uint32_t now)
+{
+  if (s.nextCourt < 0)
+    return nullptr;
+  int32_t left = (int32_t)(s.nextFreeAtMs - now);
+  return formatNextTitle(buf, cap, s.nextCourt, left > 0 ? (uint32_t)left : 0);
+}
+
+// ============================================
+// SNAPSHOT MAILBOX
+// ============================================
+// Triple buffer for one producer and one consumer. The producer fills
+// back() and publishes it; the consumer fetch()es the newest published
+// slot into front(). The third slot lets either side swap without
+// waiting, so the producer never writes a slot the consumer is reading.
+
+template <typename T>
+class SnapshotMailbox
+{
+public:
+  // Producer side
+  T &back() { return slots_[back_]; }
+  void publish()
+  {
+    back_ = middle_.exchange((uint8_t)(back_ | kFresh), std::memory_order_acq_rel) & kIndex;
+  }
+
+  // Consumer side. False when nothing was published since the last
+  // fetch; front() then still holds the previous snapshot.
+  bool fetch()
+  {
+    if (!(middle_.load(std::memory_order_acquire) & kFresh))
+      return false;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+    return true;
+  }
+  const T &front() const { return slots_[front_]; }
+
+private:
+  static constexpr uint8_t kIndex = 0x03;
+  static constexpr uint8_t kFresh = 0x04; // middle slot not fetched yet
+
+  T slots_[3];
+  uint8_t back_ = 0;  // producer-owned
+  uint8_t front_ = 1; // consumer-owned
+  std::atomic<uint8_t> middle_{2};
+};
+
+// ============================================
+// FRAME BUFFERS
+// ============================================
+// Screens draw into back(); swap() makes it the front, the frame being
+// flushed, and hands the old front back for the next frame. Every
+// screen clears its buffer before drawing, so what a recycled buffer
+// held does not matter.
+
+class FramePair
+{
+public:
+  FramePair() { memset(buf_, 0, sizeof(buf_)); }
+
+  uint8_t *back() { return buf_[back_]; }
+  const uint8_t *front() const { return buf_[back_ ^ 1]; }
+  void swap() { back_ ^= 1; }
+
+private:
+  uint8_t buf_[2][FB_BYTES];
+  uint8_t back_ = 0;
+};
+
+// ============================================
+// TASK LOAD
+// ============================================
+// Wake-ups and busy time of one task. Counters only grow and have one
+// writer, so a report from another task reads them without locking and
+// works on differences.
+
+struct TaskLoad
+{
+  std::atomic<uint32_t> wakes{0};
+  std::atomic<uint32_t> busyUs{0};
+
+  // One pass that ran for `us`; owner task only
+  void add(uint32_t us)
+  {
+    wakes.store(wakes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    busyUs.store(busyUs.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+  }
+};
+
+struct TaskLoadMark
+{
+  uint32_t wakes;
+  uint32_t busyUs;
+};
+
+// "2.0 wakes/s, busy 0.31%" over the `elapsedMs` since `mark`, then
+// move the mark up to now
+inline void formatTaskLoad(char *out, size_t cap, const TaskLoad &load, TaskLoadMark &mark, uint32_t elapsedMs)
+{
+  uint32_t wakes = load.wakes.load(std::memory_order_relaxed);
+  uint32_t busy = load.busyUs.load(std::memory_order_relaxed);
+  uint32_t dw = wakes - mark.wakes, db = busy - mark.busyUs;
+  mark.wakes = wakes;
+  mark.busyUs = busy;
+  if (elapsedMs == 0)
+    elapsedMs = 1;
+  unsigned long wakesX10 = (unsigned long)((uint64_t)dw * 10000 / elapsedMs);
+  unsigned long busyX100 = (unsigned long)((uint64_t)db * 10 / elapsedMs);
+  snprintf(out, cap, "%lu.%lu wakes/s, busy %lu.%02lu%%",
+           wakesX10 / 10, wakesX10 % 10, busyX100 / 100, busyX100 % 100);
+}
@@ -0,0 +1,72 @@
+// ============================================
+// SPSC QUEUE
+// ============================================
+// Fixed-capacity lock-free ring for exactly one producer
+// (the ESP-NOW receive callback on the WiFi task) and one
+// consumer (the receiver's state task). Neither side ever blocks: push() drops
+// and counts when the ring is full, pop() returns false
+// when it is empty.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+public:
+  // Producer side. Returns false (and counts a drop) if full.
+  bool push(const T &item)
+  {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+    if (head - tail >= Capacity)
+    {
+      dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    slots_[head & (Capacity - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+    pushed_.store(pushed_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Consumer side. Returns false if empty.
+  bool pop(T &out)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    uint32_t head = head_.load(std::memory_order_acquire);
+    if (head == tail)
+      return false;
+    out = slots_[tail & (Capacity - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when called from either side; exact from the consumer
+  // while the producer is idle.
+  size_t size() const
+  {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+  static constexpr size_t capacity() { return Capacity; }
+
+  // Counters are written only by the producer, so readers see a
+  // monotonically increasing value without locking.
+  uint32_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+  uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  T slots_[Capacity];
+  std::atomic<uint32_t> head_{0}; // next slot to write (producer-owned)
+  std::atomic<uint32_t> tail_{0}; // next slot to read (consumer-owned)
+  std::atomic<uint32_t> pushed_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
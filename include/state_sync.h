@@ -0,0 +1,522 @@
+// ============================================
+// DASHBOARD STATE SYNC
+// ============================================
+// Acknowledged, versioned alternative to the one-way telemetry stream
+// for a bridge (the Raspberry Pi dashboard) that can write back to the
+// receiver's USB serial.
+//
+// The receiver keeps a board version that goes up by one for every
+// change, and stamps each court (and each field of its record) with
+// the version of its last change. The bridge ACKs the newest version
+// it holds in full; the receiver then sends only the fields that
+// changed after that version. Nothing is resent on a timer once the
+// bridge has caught up, and a lost frame costs one retry, not a wait
+// for the next full snapshot.
+//
+// Frames from the receiver (little-endian, before COBS):
+//
+//     0      magic         SYNC_MAGIC
+//     1      version       SYNC_VERSION
+//     2      type          SYNC_DELTA
+//     3      boardCourts
+//     4-5    epoch         random per boot; a new epoch means start over
+//     6-9    baseVersion   changes after this version are included
+//     10-13  toVersion     board version the frame brings the bridge to
+//     14     part, 15 parts  big deltas are split; all parts share base/to
+//     16-19  boardMs
+//     20-28  waitS, p50S, p90S, nextCourt, nextInS (as in telemetry.h)
+//     29     count
+//     30..   records       courtId, field mask, then the fields present
+//                          in mask order: flags (u8), sinceMs (u32),
+//                          avgS (u16), games (u16)
+//     end    crc           CRC-16
+//
+// Baseline 0 is a full snapshot. ACKs from the bridge are
+// magic, version, SYNC_ACK, 0, epoch (u16), version (u32), CRC-16;
+// an ACK of version 0 (or for another epoch) asks for a snapshot.
+//
+// The bridge applies a frame only if its baseVersion is no newer than
+// what it already holds, and a court record only if the frame is newer
+// than that court's copy, so dropped, duplicated and reordered frames
+// all converge on the receiver's board.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "cobs.h"
+#include "crc.h"
+#include "telemetry.h"
+
+#define SYNC_MAGIC 0x53 // 'S'
+#define SYNC_VERSION 1
+#define SYNC_DELTA 1
+#define SYNC_ACK 2
+
+#define SYNC_F_FLAGS 0x01
+#define SYNC_F_SINCE 0x02
+#define SYNC_F_AVG 0x04
+#define SYNC_F_GAMES 0x08
+#define SYNC_F_ALL 0x0F
+#define SYNC_FIELDS 4
+
+#define SYNC_HEADER_BYTES 30
+#define SYNC_RECORD_MAX_BYTES 11
+#define SYNC_MAX_RECORDS 32 // per part
+#define SYNC_MAX_PAYLOAD (SYNC_HEADER_BYTES + SYNC_MAX_RECORDS * SYNC_RECORD_MAX_BYTES + 2)
+#define SYNC_ACK_BYTES 12
+
+#ifndef SYNC_INTERVAL_MS
+#define SYNC_INTERVAL_MS 500 // changes are batched this long
+#endif
+#ifndef SYNC_RETRY_MS
+#define SYNC_RETRY_MS 1000 // resend while the bridge has not ACKed
+#endif
+#ifndef SYNC_KEEPALIVE_MS
+#define SYNC_KEEPALIVE_MS 10000 // empty delta so the bridge sees the link is up
+#endif
+
+// ============================================
+// FRAMES
+// ============================================
+
+struct SyncRecord
+{
+  uint8_t mask;       // SYNC_F_* fields present
+  TelemetryCourt val; // fields outside mask are not meaningful
+};
+
+struct SyncFrame
+{
+  uint8_t boardCourts;
+  uint16_t epoch;
+  uint32_t baseVersion, toVersion;
+  uint8_t part, parts;
+  uint32_t boardMs;
+  uint16_t waitS, p50S, p90S;
+  uint8_t nextCourt;
+  uint16_t nextInS;
+  uint8_t count;
+  SyncRecord records[SYNC_MAX_RECORDS];
+};
+
+struct SyncAck
+{
+  uint16_t epoch;
+  uint32_t version;
+};
+
+inline size_t encodeSyncPayload(const SyncFrame &f, uint8_t *out)
+{
+  using namespace tlm_detail;
+  out[0] = SYNC_MAGIC;
+  out[1] = SYNC_VERSION;
+  out[2] = SYNC_DELTA;
+  out[3] = f.boardCourts;
+  put16(out + 4, f.epoch);
+  put32(out + 6, f.baseVersion);
+  put32(out + 10, f.toVersion);
+  out[14] = f.part;
+  out[15] = f.parts;
+  put32(out + 16, f.boardMs);
+  put16(out + 20, f.waitS);
+  put16(out + 22, f.p50S);
+  put16(out + 24, f.p90S);
+  out[26] = f.nextCourt;
+  put16(out + 27, f.nextInS);
+  out[29] = f.count;
+  uint8_t *p = out + SYNC_HEADER_BYTES;
+  for (int i = 0; i < f.count; i++)
+  {
+    const SyncRecord &r = f.records[i];
+    *p++ = r.val.courtId;
+    *p++ = r.mask;
+    if (r.mask & SYNC_F_FLAGS)
+      *p++ = r.val.flags;
+    if (r.mask & SYNC_F_SINCE)
+    {
+      put32(p, r.val.sinceMs);
+      p += 4;
+    }
+    if (r.mask & SYNC_F_AVG)
+    {
+      put16(p, r.val.avgS);
+      p += 2;
+    }
+    if (r.mask & SYNC_F_GAMES)
+    {
+      put16(p, r.val.games);
+      p += 2;
+    }
+  }
+  size_t len = (size_t)(p - out);
+  put16(p, crc16(out, len));
+  return len + 2;
+}
+
+inline bool decodeSyncPayload(const uint8_t *in, size_t len, SyncFrame &f)
+{
+  using namespace tlm_detail;
+  if (len < SYNC_HEADER_BYTES + 2 || in[0] != SYNC_MAGIC || in[1] != SYNC_VERSION || in[2] != SYNC_DELTA)
+    return false;
+  if (get16(in + len - 2) != crc16(in, len - 2))
+    return false;
+  f.count = in[29];
+  f.parts = in[15];
+  f.part = in[14];
+  if (f.count > SYNC_MAX_RECORDS || f.parts == 0 || f.parts > 32 || f.part >= f.parts)
+    return false;
+
+  f.boardCourts = in[3];
+  f.epoch = get16(in + 4);
+  f.baseVersion = get32(in + 6);
+  f.toVersion = get32(in + 10);
+  f.boardMs = get32(in + 16);
+  f.waitS = get16(in + 20);
+  f.p50S = get16(in + 22);
+  f.p90S = get16(in + 24);
+  f.nextCourt = in[26];
+  f.nextInS = get16(in + 27);
+
+  const uint8_t *p = in + SYNC_HEADER_BYTES;
+  const uint8_t *end = in + len - 2;
+  for (int i = 0; i < f.count; i++)
+  {
+    if (end - p < 2)
+      return false;
+    SyncRecord &r = f.records[i];
+    r.val = TelemetryCourt{p[0], 0, 0, 0, 0};
+    r.mask = p[1];
+    p += 2;
+    size_t need = ((r.mask & SYNC_F_FLAGS) ? 1 : 0) + ((r.mask & SYNC_F_SINCE) ? 4 : 0) +
+                  ((r.mask & SYNC_F_AVG) ? 2 : 0) + ((r.mask & SYNC_F_GAMES) ? 2 : 0);
+    if ((size_t)(end - p) < need)
+      return false;
+    if (r.mask & SYNC_F_FLAGS)
+      r.val.flags = *p++;
+    if (r.mask & SYNC_F_SINCE)
+    {
+      r.val.sinceMs = get32(p);
+      p += 4;
+    }
+    if (r.mask & SYNC_F_AVG)
+    {
+      r.val.avgS = get16(p);
+      p += 2;
+    }
+    if (r.mask & SYNC_F_GAMES)
+    {
+      r.val.games = get16(p);
+      p += 2;
+    }
+  }
+  return p == end;
+}
+
+inline size_t encodeSyncAck(const SyncAck &a, uint8_t *out)
+{
+  using namespace tlm_detail;
+  out[0] = SYNC_MAGIC;
+  out[1] = SYNC_VERSION;
+  out[2] = SYNC_ACK;
+  out[3] = 0;
+  put16(out + 4, a.epoch);
+  put32(out + 6, a.version);
+  put16(out + 10, crc16(out, 10));
+  return SYNC_ACK_BYTES;
+}
+
+inline bool decodeSyncAck(const uint8_t *in, size_t len, SyncAck &a)
+{
+  using namespace tlm_detail;
+  if (len != SYNC_ACK_BYTES || in[0] != SYNC_MAGIC || in[1] != SYNC_VERSION || in[2] != SYNC_ACK)
+    return false;
+  if (get16(in + 10) != crc16(in, 10))
+    return false;
+  a.epoch = get16(in + 4);
+  a.version = get32(in + 6);
+  return true;
+}
+
+// ============================================
+// PRODUCER (receiver firmware)
+// ============================================
+
+template <size_t N>
+class SyncProducer
+{
+public:
+  // `epoch` must differ between boots (esp_random() on the receiver)
+  explicit SyncProducer(uint16_t epoch = 1) { reset(epoch); }
+
+  void reset(uint16_t epoch)
+  {
+    epoch_ = epoch ? epoch : 1; // 0 is the bridge's "no epoch yet"
+    version_ = 0;
+    acked_ = 0;
+    primed_ = false;
+    resendNow_ = false;
+    lastSentTo_ = 0;
+    lastCaptureMs_ = lastSendMs_ = 0;
+    lastWaitS_ = 0;
+    lastNextCourt_ = 0;
+  }
+
+  // Feed bytes read from the bridge; ACK frames move the baseline
+  void receive(uint8_t b)
+  {
+    const uint8_t *payload;
+    size_t len;
+    SyncAck a;
+    if (!reader_.feed(b, payload, len) || !decodeSyncAck(payload, len, a))
+      return;
+    acks++;
+    uint32_t v = (a.epoch == epoch_ && a.version <= version_) ? a.version : 0;
+    if (v < acked_)
+      resendNow_ = true; // the bridge lost frames or restarted
+    acked_ = v;
+  }
+
+  // Record changes, then send a delta when there is something the
+  // bridge has not ACKed. `write(const uint8_t *, size_t)` gets each
+  // delimited frame.
+  template <typename Write>
+  void service(BasicSystemState<N> &state, const CourtPredictor<N> &predictor, uint32_t now, Write &&write)
+  {
+    if (primed_ && !resendNow_ && now - lastCaptureMs_ < SYNC_INTERVAL_MS)
+      return;
+    lastCaptureMs_ = now;
+
+    SyncFrame f;
+    f.boardCourts = (uint8_t)N;
+    f.epoch = epoch_;
+    f.boardMs = now;
+    f.waitS = tlm_detail::clampS(currentWaitMs(state, now));
+    f.p50S = tlm_detail::clampS(state.allWaits.p50Ms);
+    f.p90S = tlm_detail::clampS(state.allWaits.p90Ms);
+    f.nextCourt = predictor.size() ? (uint8_t)(predictor.courtAt(0) + 1) : 0;
+    f.nextInS = predictor.size() ? tlm_detail::clampS(predictor.remainingMs(0, now)) : 0;
+    capture(state, f, now);
+
+    bool behind = acked_ < version_;
+    bool send = (behind && (version_ != lastSentTo_ || resendNow_ || now - lastSendMs_ >= SYNC_RETRY_MS)) ||
+                now - lastSendMs_ >= SYNC_KEEPALIVE_MS;
+    if (!send)
+      return;
+    resendNow_ = false;
+    lastSendMs_ = now;
+    lastSentTo_ = version_;
+    sendSince(acked_, f, write);
+  }
+
+  uint32_t version() const { return version_; }
+  uint32_t ackedVersion() const { return acked_; }
+  uint32_t courtVersion(int idx) const { return courtVer_[idx]; }
+  const TelemetryCourt &court(int idx) const { return cur_[idx]; }
+
+  uint32_t acks = 0;
+  uint32_t framesSent = 0;
+
+private:
+  // Bump the version of every court (and field) whose record changed
+  void capture(BasicSystemState<N> &state, const SyncFrame &header, uint32_t now)
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      TelemetryCourt c = telemetryCourt(state.courts[i], (int)i + 1, now);
+      uint8_t changed = primed_ ? fieldsChanged(cur_[i], c) : SYNC_F_ALL;
+      if (!changed)
+        continue;
+      uint32_t v = ++version_;
+      courtVer_[i] = v;
+      for (int k = 0; k < SYNC_FIELDS; k++)
+        if (changed & (1 << k))
+          fieldVer_[i][k] = v;
+      cur_[i] = c;
+    }
+    // Board figures ride in every header; a change is still a new version
+    // so an otherwise idle bridge hears about it
+    if (primed_ && (header.waitS != lastWaitS_ || header.nextCourt != lastNextCourt_))
+      ++version_;
+    lastWaitS_ = header.waitS;
+    lastNextCourt_ = header.nextCourt;
+    primed_ = true;
+  }
+
+  static uint8_t fieldsChanged(const TelemetryCourt &a, const TelemetryCourt &b)
+  {
+    return (uint8_t)((a.flags != b.flags ? SYNC_F_FLAGS : 0) | (a.sinceMs != b.sinceMs ? SYNC_F_SINCE : 0) |
+                     (a.avgS != b.avgS ? SYNC_F_AVG : 0) | (a.games != b.games ? SYNC_F_GAMES : 0));
+  }
+
+  template <typename Write>
+  void sendSince(uint32_t base, SyncFrame &f, Write &write)
+  {
+    size_t changed = 0;
+    for (size_t i = 0; i < N; i++)
+      if (courtVer_[i] > base)
+        changed++;
+
+    f.baseVersion = base;
+    f.toVersion = version_;
+    f.parts = (uint8_t)(changed == 0 ? 1 : (changed + SYNC_MAX_RECORDS - 1) / SYNC_MAX_RECORDS);
+    f.part = 0;
+    f.count = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+      if (courtVer_[i] <= base)
+        continue;
+      SyncRecord &r = f.records[f.count++];
+      r.val = cur_[i];
+      r.mask = 0;
+      for (int k = 0; k < SYNC_FIELDS; k++)
+        if (fieldVer_[i][k] > base)
+          r.mask |= (uint8_t)(1 << k);
+      if (f.count == SYNC_MAX_RECORDS)
+      {
+        emit(f, write);
+        f.part++;
+        f.count = 0;
+      }
+    }
+    if (f.count > 0 || changed == 0)
+      emit(f, write);
+  }
+
+  template <typename Write>
+  void emit(const SyncFrame &f, Write &write)
+  {
+    uint8_t payload[SYNC_MAX_PAYLOAD];
+    uint8_t out[COBS_MAX_FRAME(SYNC_MAX_PAYLOAD)];
+    write(out, cobsFrame(payload, encodeSyncPayload(f, payload), out));
+    framesSent++;
+  }
+
+  TelemetryCourt cur_[N];
+  uint32_t courtVer_[N];
+  uint32_t fieldVer_[N][SYNC_FIELDS];
+  uint16_t epoch_;
+  uint32_t version_, acked_, lastSentTo_;
+  bool primed_, resendNow_;
+  uint32_t lastCaptureMs_, lastSendMs_;
+  uint16_t lastWaitS_;
+  uint8_t lastNextCourt_;
+  CobsReader<SYNC_ACK_BYTES> reader_;
+};
+
+// ============================================
+// CONSUMER (dashboard bridge / CLI)
+// ============================================
+
+struct SyncConsumerStats
+{
+  uint32_t frames;   // valid frames seen
+  uint32_t stale;    // frames older than what was already held (reordered, duplicated)
+  uint32_t gaps;     // frames skipped because an earlier change was missing
+  uint32_t resyncs;  // snapshots adopted after an epoch change
+};
+
+class SyncConsumer
+{
+public:
+  // Apply one frame. Returns the ACK to send back; always send it, it
+  // is how the receiver learns what to resend.
+  SyncAck apply(const SyncFrame &f)
+  {
+    stats.frames++;
+    if (f.epoch != epoch_)
+    {
+      if (f.baseVersion != 0)
+      {
+        stats.gaps++;
+        return SyncAck{epoch_, 0}; // unknown receiver boot: ask for a snapshot
+      }
+      start(f.epoch);
+    }
+    else if (f.baseVersion > version_)
+    {
+      stats.gaps++;
+      return SyncAck{epoch_, version_};
+    }
+    else if (f.toVersion < version_)
+      stats.stale++;
+
+    // Records carry the receiver's current values, so each is good as
+    // of toVersion; keep whichever copy of a court is newest
+    for (int i = 0; i < f.count; i++)
+    {
+      const SyncRecord &r = f.records[i];
+      uint8_t id = r.val.courtId;
+      if (f.toVersion <= courtVersion[id])
+        continue;
+      TelemetryCourt &c = board.court[id];
+      c.courtId = id;
+      if (r.mask & SYNC_F_FLAGS)
+        c.flags = r.val.flags;
+      if (r.mask & SYNC_F_SINCE)
+        c.sinceMs = r.val.sinceMs;
+      if (r.mask & SYNC_F_AVG)
+        c.avgS = r.val.avgS;
+      if (r.mask & SYNC_F_GAMES)
+        c.games = r.val.games;
+      courtVersion[id] = f.toVersion;
+      board.known[id] = true;
+    }
+
+    if (f.toVersion >= headerVersion_)
+    {
+      headerVersion_ = f.toVersion;
+      board.courts = f.boardCourts;
+      TelemetryFrame &h = board.last;
+      h.type = f.baseVersion == 0 ? TLM_SNAPSHOT : TLM_DELTA;
+      h.boardCourts = f.boardCourts;
+      h.boardMs = f.boardMs;
+      h.waitS = f.waitS;
+      h.p50S = f.p50S;
+      h.p90S = f.p90S;
+      h.nextCourt = f.nextCourt;
+      h.nextInS = f.nextInS;
+      h.count = 0;
+    }
+
+    // The version only advances once every part of one delta is in
+    if (f.toVersion > pendingTo_ || (f.toVersion == pendingTo_ && f.baseVersion != pendingBase_))
+    {
+      pendingBase_ = f.baseVersion;
+      pendingTo_ = f.toVersion;
+      partsSeen_ = 0;
+    }
+    if (f.toVersion == pendingTo_ && f.baseVersion == pendingBase_)
+      partsSeen_ |= 1u << f.part;
+    if (partsSeen_ == (f.parts == 32 ? 0xFFFFFFFFu : (1u << f.parts) - 1) && pendingTo_ > version_)
+      version_ = pendingTo_;
+    return SyncAck{epoch_, version_};
+  }
+
+  uint16_t epoch() const { return epoch_; }
+  uint32_t version() const { return version_; }
+
+  TelemetryBoard board; // same view as the telemetry reader
+  uint32_t courtVersion[256] = {};
+  SyncConsumerStats stats = {};
+
+private:
+  void start(uint16_t epoch)
+  {
+    if (epoch_ != 0)
+      stats.resyncs++;
+    epoch_ = epoch;
+    version_ = headerVersion_ = 0;
+    pendingBase_ = pendingTo_ = 0;
+    partsSeen_ = 0;
+    for (int i = 0; i < 256; i++)
+    {
+      courtVersion[i] = 0;
+      board.known[i] = false;
+    }
+  }
+
+  uint16_t epoch_ = 0;
+  uint32_t version_ = 0, headerVersion_ = 0;
+  uint32_t pendingBase_ = 0, pendingTo_ = 0, partsSeen_ = 0;
+};
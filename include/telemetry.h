@@ -0,0 +1,349 @@
+// ============================================
+// TELEMETRY STREAM
+// ============================================
+// Binary court-board stream for an external dashboard (the Raspberry
+// Pi plan in future_with_pi.md), sent over the receiver's USB serial.
+//
+// Each frame is COBS-encoded and wrapped in 0x00 delimiters on both
+// sides, so a reader can join mid-stream and the receiver's text log
+// lines can share the port: anything between two delimiters that is
+// not a valid frame (bad CRC, wrong magic) is skipped as noise.
+//
+// Frame payload (little-endian, before COBS):
+//
+//     0      magic         TLM_MAGIC
+//     1      version       TLM_VERSION
+//     2      type          TLM_SNAPSHOT (full board, paged) or
+//                          TLM_DELTA (only courts that changed)
+//     3      boardCourts   court count of the sending receiver
+//     4-5    seq           frame counter, wraps
+//     6-9    boardMs       receiver board clock when sent
+//     10-11  waitS         currentWaitMs() in seconds
+//     12-13  p50S, 14-15 p90S   board-wide game length percentiles
+//     16     nextCourt     predicted next court to free, 0 = none
+//     17-18  nextInS       seconds until it frees
+//     19     count         court records that follow
+//     20..   records       TLM_RECORD_BYTES each:
+//                            courtId, flags, sinceMs (u32), avgS (u16), games (u16)
+//     end    crc           CRC-16 of everything above
+//
+// sinceMs is when the court entered its current state, on the board
+// clock, so elapsed times are boardMs - sinceMs and a court only
+// appears in a delta when something about it actually changed.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "cobs.h"
+#include "crc.h"
+#include "receiver_logic.h"
+#include "court_prediction.h"
+
+#define TLM_MAGIC 0x52 // 'R'
+#define TLM_VERSION 1
+#define TLM_SNAPSHOT 1
+#define TLM_DELTA 2
+
+#define TLM_HEADER_BYTES 20
+#define TLM_RECORD_BYTES 10
+#define TLM_MAX_RECORDS 32 // per frame; larger boards page their snapshots
+#define TLM_MAX_PAYLOAD (TLM_HEADER_BYTES + TLM_MAX_RECORDS * TLM_RECORD_BYTES + 2)
+#define TLM_MAX_ENCODED COBS_MAX_ENCODED(TLM_MAX_PAYLOAD)
+
+#define TLM_FLAG_AVAILABLE 0x01
+#define TLM_FLAG_IN_USE 0x02
+#define TLM_FLAG_FAULT 0x04
+
+#ifndef TELEMETRY_DELTA_MS
+#define TELEMETRY_DELTA_MS 500
+#endif
+#ifndef TELEMETRY_SNAPSHOT_MS
+#define TELEMETRY_SNAPSHOT_MS 10000
+#endif
+
+// ============================================
+// FRAMES
+// ============================================
+
+struct TelemetryCourt
+{
+  uint8_t courtId;
+  uint8_t flags;
+  uint32_t sinceMs;
+  uint16_t avgS;
+  uint16_t games;
+
+  bool operator==(const TelemetryCourt &o) const
+  {
+    return courtId == o.courtId && flags == o.flags && sinceMs == o.sinceMs &&
+           avgS == o.avgS && games == o.games;
+  }
+  bool operator!=(const TelemetryCourt &o) const { return !(*this == o); }
+};
+
+struct TelemetryFrame
+{
+  uint8_t type;
+  uint8_t boardCourts;
+  uint16_t seq;
+  uint32_t boardMs;
+  uint16_t waitS, p50S, p90S;
+  uint8_t nextCourt;
+  uint16_t nextInS;
+  uint8_t count;
+  TelemetryCourt courts[TLM_MAX_RECORDS];
+};
+
+namespace tlm_detail
+{
+  inline void put16(uint8_t *p, uint16_t v)
+  {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+  }
+  inline void put32(uint8_t *p, uint32_t v)
+  {
+    for (int i = 0; i < 4; i++)
+      p[i] = (uint8_t)(v >> (8 * i));
+  }
+  inline uint16_t get16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+  inline uint32_t get32(const uint8_t *p)
+  {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+  inline uint16_t clampS(uint32_t ms)
+  {
+    uint32_t s = (ms + 500) / 1000;
+    return s > 0xFFFF ? 0xFFFF : (uint16_t)s;
+  }
+}
+
+// Payload (CRC included, before COBS). Returns its length.
+inline size_t encodeTelemetryPayload(const TelemetryFrame &f, uint8_t *out)
+{
+  using namespace tlm_detail;
+  out[0] = TLM_MAGIC;
+  out[1] = TLM_VERSION;
+  out[2] = f.type;
+  out[3] = f.boardCourts;
+  put16(out + 4, f.seq);
+  put32(out + 6, f.boardMs);
+  put16(out + 10, f.waitS);
+  put16(out + 12, f.p50S);
+  put16(out + 14, f.p90S);
+  out[16] = f.nextCourt;
+  put16(out + 17, f.nextInS);
+  out[19] = f.count;
+  uint8_t *p = out + TLM_HEADER_BYTES;
+  for (int i = 0; i < f.count; i++, p += TLM_RECORD_BYTES)
+  {
+    const TelemetryCourt &c = f.courts[i];
+    p[0] = c.courtId;
+    p[1] = c.flags;
+    put32(p + 2, c.sinceMs);
+    put16(p + 6, c.avgS);
+    put16(p + 8, c.games);
+  }
+  size_t len = (size_t)(p - out);
+  put16(p, crc16(out, len));
+  return len + 2;
+}
+
+inline bool decodeTelemetryPayload(const uint8_t *in, size_t len, TelemetryFrame &f)
+{
+  using namespace tlm_detail;
+  if (len < TLM_HEADER_BYTES + 2 || in[0] != TLM_MAGIC || in[1] != TLM_VERSION)
+    return false;
+  if (get16(in + len - 2) != crc16(in, len - 2))
+    return false;
+  f.count = in[19];
+  if (f.count > TLM_MAX_RECORDS || len != TLM_HEADER_BYTES + f.count * TLM_RECORD_BYTES + 2u)
+    return false;
+
+  f.type = in[2];
+  f.boardCourts = in[3];
+  f.seq = get16(in + 4);
+  f.boardMs = get32(in + 6);
+  f.waitS = get16(in + 10);
+  f.p50S = get16(in + 12);
+  f.p90S = get16(in + 14);
+  f.nextCourt = in[16];
+  f.nextInS = get16(in + 17);
+  const uint8_t *p = in + TLM_HEADER_BYTES;
+  for (int i = 0; i < f.count; i++, p += TLM_RECORD_BYTES)
+  {
+    TelemetryCourt &c = f.courts[i];
+    c.courtId = p[0];
+    c.flags = p[1];
+    c.sinceMs = get32(p + 2);
+    c.avgS = get16(p + 6);
+    c.games = get16(p + 8);
+  }
+  return true;
+}
+
+// ============================================
+// SENDER (receiver firmware)
+// ============================================
+
+inline TelemetryCourt telemetryCourt(const CourtState &court, int courtNum, uint32_t now)
+{
+  TelemetryCourt c;
+  c.courtId = (uint8_t)courtNum;
+  c.flags = 0;
+  c.sinceMs = 0;
+  if (court.inUse && court.inUseSinceMs > 0)
+  {
+    c.flags |= TLM_FLAG_IN_USE;
+    c.sinceMs = court.inUseSinceMs;
+    if (courtFaulted(court, now))
+      c.flags |= TLM_FLAG_FAULT;
+  }
+  else if (court.available)
+  {
+    c.flags |= TLM_FLAG_AVAILABLE;
+    c.sinceMs = court.availableSinceMs;
+  }
+  c.avgS = tlm_detail::clampS((uint32_t)(court.avgWaitMs + 0.5f));
+  c.games = court.waitSamples > 0xFFFF ? 0xFFFF : (uint16_t)court.waitSamples;
+  return c;
+}
+
+// Periodic full snapshots plus deltas of courts whose record changed
+// since it was last sent. `write(const uint8_t *, size_t)` gets each
+// delimited frame.
+template <size_t N>
+class TelemetryStream
+{
+public:
+  TelemetryStream() { reset(); }
+
+  void reset()
+  {
+    seq_ = 0;
+    primed_ = false;
+  }
+
+  template <typename Write>
+  void service(BasicSystemState<N> &state, const CourtPredictor<N> &predictor, uint32_t now, Write &&write)
+  {
+    bool snapshot = !primed_ || now - lastSnapshotMs_ >= TELEMETRY_SNAPSHOT_MS;
+    if (!snapshot && now - lastDeltaMs_ < TELEMETRY_DELTA_MS)
+      return;
+
+    TelemetryFrame f;
+    f.type = snapshot ? TLM_SNAPSHOT : TLM_DELTA;
+    f.boardCourts = (uint8_t)N;
+    f.boardMs = now;
+    f.waitS = tlm_detail::clampS(currentWaitMs(state, now));
+    f.p50S = tlm_detail::clampS(state.allWaits.p50Ms);
+    f.p90S = tlm_detail::clampS(state.allWaits.p90Ms);
+    f.nextCourt = predictor.size() ? (uint8_t)(predictor.courtAt(0) + 1) : 0;
+    f.nextInS = predictor.size() ? tlm_detail::clampS(predictor.remainingMs(0, now)) : 0;
+    f.count = 0;
+
+    bool headerChanged = f.waitS != lastWaitS_ || f.nextCourt != lastNextCourt_;
+    bool sent = false;
+    for (size_t i = 0; i < N; i++)
+    {
+      TelemetryCourt c = telemetryCourt(state.courts[i], (int)i + 1, now);
+      if (!snapshot && c == last_[i])
+        continue;
+      last_[i] = c;
+      f.courts[f.count++] = c;
+      if (f.count == TLM_MAX_RECORDS)
+      {
+        emit(f, write);
+        sent = true;
+        f.count = 0;
+      }
+    }
+    if (f.count > 0 || (!sent && (snapshot || headerChanged)))
+      emit(f, write);
+
+    lastWaitS_ = f.waitS;
+    lastNextCourt_ = f.nextCourt;
+    lastDeltaMs_ = now;
+    if (snapshot)
+    {
+      lastSnapshotMs_ = now;
+      primed_ = true;
+    }
+  }
+
+  uint16_t framesSent() const { return seq_; }
+
+private:
+  template <typename Write>
+  void emit(TelemetryFrame &f, Write &write)
+  {
+    f.seq = seq_++;
+    uint8_t payload[TLM_MAX_PAYLOAD];
+    uint8_t out[COBS_MAX_FRAME(TLM_MAX_PAYLOAD)];
+    write(out, cobsFrame(payload, encodeTelemetryPayload(f, payload), out));
+  }
+
+  TelemetryCourt last_[N];
+  uint16_t seq_;
+  bool primed_;
+  uint32_t lastSnapshotMs_ = 0, lastDeltaMs_ = 0;
+  uint16_t lastWaitS_ = 0;
+  uint8_t lastNextCourt_ = 0;
+};
+
+// ============================================
+// READER (dashboard / CLI)
+// ============================================
+
+// Byte-at-a-time frame splitter for a serial port or capture file
+class TelemetryDecoder
+{
+public:
+  // Returns true when `b` completed a valid frame, now in `out`
+  bool feed(uint8_t b, TelemetryFrame &out)
+  {
+    const uint8_t *payload;
+    size_t len;
+    if (!reader_.feed(b, payload, len))
+      return false;
+    if (len == 0 || !decodeTelemetryPayload(payload, len, out))
+    {
+      noise++;
+      return false;
+    }
+    frames++;
+    return true;
+  }
+
+  uint32_t frames = 0;
+  uint32_t noise = 0; // delimited chunks that were not frames (text log lines, corruption)
+
+private:
+  CobsReader<TLM_MAX_PAYLOAD> reader_;
+};
+
+// Mirror of the receiver's board, rebuilt from snapshots and deltas
+struct TelemetryBoard
+{
+  uint8_t courts = 0; // 0 until the first frame
+  bool known[256] = {};
+  TelemetryCourt court[256];
+  TelemetryFrame last = {}; // header fields of the newest frame
+  uint32_t seqGaps = 0;
+  bool haveSeq = false;
+
+  void apply(const TelemetryFrame &f)
+  {
+    if (haveSeq && (uint16_t)(f.seq - last.seq) != 1)
+      seqGaps++;
+    haveSeq = true;
+    last = f;
+    courts = f.boardCourts;
+    for (int i = 0; i < f.count; i++)
+    {
+      court[f.courts[i].courtId] = f.courts[i];
+      known[f.courts[i].courtId] = true;
+    }
+  }
+};
@@ -0,0 +1,307 @@
+// ============================================
+// TIMER WHEEL
+// ============================================
+// Hierarchical timing wheel for the receiver's per-court deadlines
+// (Fault timeouts, alert expiry, prediction refresh). Timers are
+// small integer ids into a fixed pool, so there is no allocation and
+// schedule/cancel are O(1) list splices.
+//
+// Four levels of 64 slots at 1 ms per tick cover 2^24 ms (~4.6 h);
+// later deadlines wait on a parked list that is re-filed each time
+// the top level turns. advance() walks level-0 slots, cascades a
+// higher slot down each time the level below wraps, and skips empty
+// stretches via per-level occupancy bitmaps, so the work per tick is
+// O(1) amortized however many courts are scheduled. Time is the
+// 32-bit board clock; all comparisons are wrap-safe.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "receiver_logic.h"
+
+#define TW_LEVELS 4
+#define TW_BITS 6
+#define TW_SLOTS (1u << TW_BITS)
+#define TW_NONE 0xFFFF
+
+template <size_t MaxTimers>
+class TimerWheel
+{
+  static_assert(MaxTimers < TW_NONE, "TimerWheel ids must fit in 16 bits");
+
+public:
+  explicit TimerWheel(uint32_t now = 0) { reset(now); }
+
+  void reset(uint32_t now)
+  {
+    now_ = now;
+    count_ = 0;
+    for (size_t i = 0; i < kLists; i++)
+      head_[i] = TW_NONE;
+    for (int l = 0; l < TW_LEVELS; l++)
+      occupied_[l] = 0;
+    for (size_t i = 0; i < MaxTimers; i++)
+      nodes_[i] = Node{0, TW_NONE, TW_NONE, TW_NONE};
+  }
+
+  // (Re)arm timer `id` to fire at `at`. A deadline at or before the
+  // wheel's time fires on the next advance().
+  void schedule(uint16_t id, uint32_t at)
+  {
+    if (id >= MaxTimers)
+      return;
+    cancel(id);
+    nodes_[id].at = at;
+    file(id);
+    count_++;
+  }
+
+  void cancel(uint16_t id)
+  {
+    if (id >= MaxTimers || nodes_[id].list == TW_NONE)
+      return;
+    unlink(id);
+    count_--;
+  }
+
+  bool pending(uint16_t id) const { return id < MaxTimers && nodes_[id].list != TW_NONE; }
+  uint32_t deadline(uint16_t id) const { return nodes_[id].at; }
+  size_t size() const { return count_; }
+  uint32_t now() const { return now_; }
+
+  // Move the wheel to `now`, calling `fire(id)` for every timer whose
+  // deadline has passed, earliest first. A timer is disarmed before
+  // its callback runs, so the callback may re-schedule it; a deadline
+  // that is already due then fires on the next advance(). Returns the
+  // number fired.
+  template <typename Fire>
+  size_t advance(uint32_t now, Fire &&fire)
+  {
+    // Overdue timers move to a private list first, so a callback that
+    // re-arms one in the past cannot keep this loop going
+    for (uint16_t i = head_[kDueList]; i != TW_NONE; i = nodes_[i].next)
+      nodes_[i].list = kFiringList;
+    head_[kFiringList] = head_[kDueList];
+    head_[kDueList] = TW_NONE;
+    size_t fired = fireList(kFiringList, fire);
+    while ((int32_t)(now - now_) > 0)
+    {
+      if (count_ == 0)
+      {
+        now_ = now;
+        break;
+      }
+
+      // Next tick with work: an occupied level-0 slot or the next
+      // level-0 wrap, whichever comes first
+      uint32_t step = TW_SLOTS - (now_ & (TW_SLOTS - 1));
+      uint64_t occ = occupied_[0];
+      if (occ)
+      {
+        unsigned from = (now_ + 1) & (TW_SLOTS - 1);
+        uint64_t rot = (occ >> from) | (from ? occ << (TW_SLOTS - from) : 0);
+        uint32_t toSlot = (uint32_t)__builtin_ctzll(rot) + 1;
+        if (toSlot < step)
+          step = toSlot;
+      }
+      if (step > now - now_)
+      {
+        now_ = now;
+        break;
+      }
+
+      now_ += step;
+      cascadeAt(now_);
+      fired += fireList(slotList(0, now_), fire);
+    }
+    return fired;
+  }
+
+  // Earliest armed deadline, for sleeping until it. False when empty.
+  bool nextDeadline(uint32_t &at) const
+  {
+    if (count_ == 0)
+      return false;
+    if (head_[kDueList] != TW_NONE)
+    {
+      at = now_;
+      return true;
+    }
+    bool found = false;
+    for (int l = 0; l < TW_LEVELS; l++)
+    {
+      if (!occupied_[l])
+        continue;
+      // The first occupied slot in this level's turning order holds
+      // its earliest deadlines. The current slot comes last: it was
+      // already turned, so anything in it is a full rotation away.
+      unsigned from = (unsigned)((now_ >> (l * TW_BITS)) + 1) & (TW_SLOTS - 1);
+      uint64_t occ = occupied_[l];
+      uint64_t rot = (occ >> from) | (from ? occ << (TW_SLOTS - from) : 0);
+      unsigned slot = (from + (unsigned)__builtin_ctzll(rot)) & (TW_SLOTS - 1);
+      earliestIn((uint16_t)(l * TW_SLOTS + slot), at, found);
+    }
+    earliestIn(kParkedList, at, found);
+    return found;
+  }
+
+private:
+  struct Node
+  {
+    uint32_t at;
+    uint16_t prev, next;
+    uint16_t list; // index into head_, TW_NONE when disarmed
+  };
+
+  static constexpr size_t kDueList = TW_LEVELS * TW_SLOTS; // already overdue
+  static constexpr size_t kFiringList = kDueList + 1;       // overdue, being fired
+  static constexpr size_t kParkedList = kFiringList + 1;    // beyond the top level
+  static constexpr size_t kLists = kParkedList + 1;
+
+  void earliestIn(uint16_t list, uint32_t &at, bool &found) const
+  {
+    for (uint16_t i = head_[list]; i != TW_NONE; i = nodes_[i].next)
+    {
+      if (!found || (int32_t)(nodes_[i].at - at) < 0)
+        at = nodes_[i].at;
+      found = true;
+    }
+  }
+
+  static uint16_t slotList(int level, uint32_t t)
+  {
+    return (uint16_t)(level * TW_SLOTS + ((t >> (level * TW_BITS)) & (TW_SLOTS - 1)));
+  }
+
+  // Pick the level whose span covers the time left, and the slot in
+  // it that turns past the deadline
+  void file(uint16_t id)
+  {
+    int32_t left = (int32_t)(nodes_[id].at - now_);
+    if (left <= 0)
+    {
+      link(id, kDueList);
+      return;
+    }
+    uint32_t d = (uint32_t)left;
+    for (int l = 0; l < TW_LEVELS; l++)
+    {
+      if (d < (1u << ((l + 1) * TW_BITS)))
+      {
+        link(id, slotList(l, nodes_[id].at));
+        return;
+      }
+    }
+    link(id, kParkedList);
+  }
+
+  // Each time a level wraps, re-file the next slot of the level above
+  // (and the parked list when the top level turns). Runs with
+  // now_ == t, before level-0 slot t fires.
+  void cascadeAt(uint32_t t)
+  {
+    for (int l = 1; l < TW_LEVELS; l++)
+    {
+      if (t & ((1u << (l * TW_BITS)) - 1))
+        return;
+      uint16_t list = slotList(l, t);
+      occupied_[l] &= ~(1ull << (list & (TW_SLOTS - 1)));
+      refile(list, t);
+    }
+    refile(kParkedList, t);
+  }
+
+  void refile(uint16_t list, uint32_t t)
+  {
+    uint16_t i = head_[list];
+    head_[list] = TW_NONE;
+    while (i != TW_NONE)
+    {
+      uint16_t next = nodes_[i].next;
+      nodes_[i].list = TW_NONE;
+      if (nodes_[i].at == t)
+        link(i, slotList(0, t)); // due this very tick, fired next
+      else
+        file(i);
+      i = next;
+    }
+  }
+
+  template <typename Fire>
+  size_t fireList(uint16_t list, Fire &fire)
+  {
+    size_t fired = 0;
+    while (head_[list] != TW_NONE)
+    {
+      uint16_t id = head_[list];
+      unlink(id);
+      count_--;
+      fired++;
+      fire(id);
+    }
+    return fired;
+  }
+
+  void link(uint16_t id, uint16_t list)
+  {
+    Node &n = nodes_[id];
+    n.list = list;
+    n.prev = TW_NONE;
+    n.next = head_[list];
+    if (n.next != TW_NONE)
+      nodes_[n.next].prev = id;
+    head_[list] = id;
+    if (list < kDueList)
+      occupied_[list / TW_SLOTS] |= 1ull << (list & (TW_SLOTS - 1));
+  }
+
+  void unlink(uint16_t id)
+  {
+    Node &n = nodes_[id];
+    if (n.prev != TW_NONE)
+      nodes_[n.prev].next = n.next;
+    else
+      head_[n.list] = n.next;
+    if (n.next != TW_NONE)
+      nodes_[n.next].prev = n.prev;
+    if (n.list < kDueList && head_[n.list] == TW_NONE)
+      occupied_[n.list / TW_SLOTS] &= ~(1ull << (n.list & (TW_SLOTS - 1)));
+    n.list = TW_NONE;
+  }
+
+  Node nodes_[MaxTimers];
+  uint16_t head_[kLists];
+  uint64_t occupied_[TW_LEVELS];
+  uint32_t now_;
+  size_t count_;
+};
+
+// ============================================
+// RECEIVER TIMERS
+// ============================================
+// Timer ids 0..N-1 are the courts' fault deadlines; the alert and the
+// prediction refresh follow.
+
+template <size_t N>
+struct CourtTimers
+{
+  static constexpr uint16_t kAlert = (uint16_t)N;       // full-screen alert expiry
+  static constexpr uint16_t kPredict = (uint16_t)N + 1; // next-court estimate goes stale
+  static constexpr size_t kCount = N + 2;
+  using Wheel = TimerWheel<kCount>;
+};
+
+// Arm court `idx`'s (0-based) fault deadline: the first millisecond at
+// which courtFaulted() turns true. Courts never heard from have none.
+template <size_t N>
+void armFaultTimer(typename CourtTimers<N>::Wheel &wheel, const BasicSystemState<N> &state, int idx)
+{
+  const CourtState &c = state.courts[idx];
+  if (c.lastHeardMs == 0)
+  {
+    wheel.cancel((uint16_t)idx);
+    return;
+  }
+  wheel.schedule((uint16_t)idx, c.lastHeardMs + (c.faultTimeoutMs ? c.faultTimeoutMs : FAULT_TIMEOUT_MS) + 1);
+}
@@ -0,0 +1,93 @@
+// ============================================
+// TRANSMITTER RADIO CHANNEL
+// ============================================
+// ESP-NOW only reaches the receiver on the WiFi channel its radio is
+// parked on (ESPNOW_CHANNEL). A transmitter that does not know the
+// channel yet probes for it: it sends its frame on each channel in
+// turn, the configured one first, and keeps the first channel the
+// receiver ACKs in RTC memory, so later wakes go straight to it.
+//
+// One lost ACK says nothing about the channel, so the cached one is
+// only dropped after TX_CHANNEL_RELEARN_FAILS failed sends in a row;
+// the next send then probes again, which finds a receiver that was
+// moved to another channel.
+//
+// A probe that finds nothing usually means the receiver is off or out
+// of range, and probing on every wake would cost 13 sends each time.
+// Failed probes back off: the sends in between go out on
+// ESPNOW_CHANNEL only, 2, 4, 8... of them up to
+// TX_CHANNEL_PROBE_MAX_SKIP, before the next full probe.
+
+#pragma once
+
+#include <cstdint>
+
+#ifndef ESPNOW_CHANNEL
+#define ESPNOW_CHANNEL 1
+#endif
+#ifndef TX_CHANNEL_RELEARN_FAILS
+#define TX_CHANNEL_RELEARN_FAILS 4 // failed sends in a row before the channel is probed again
+#endif
+#ifndef TX_CHANNEL_PROBE_MAX_SKIP
+#define TX_CHANNEL_PROBE_MAX_SKIP 64 // most single-channel sends between two failed probes
+#endif
+
+#define WIFI_CHANNEL_COUNT 13 // 2.4 GHz channels 1-13
+
+static_assert(TX_CHANNEL_PROBE_MAX_SKIP >= 1 && TX_CHANNEL_PROBE_MAX_SKIP <= 255, "probeIn is 8-bit");
+
+struct TxChannel
+{
+  uint8_t channel;      // last channel the receiver ACKed on, 0 = unknown
+  uint8_t failedSends;  // failed sends in a row on it
+  uint8_t failedProbes; // full probes in a row that found nothing
+  uint8_t probeIn;      // sends on ESPNOW_CHANNEL left before the next probe
+};
+
+// Whether the next send should probe every channel
+inline bool channelProbeDue(const TxChannel &c)
+{
+  return c.channel == 0 && c.probeIn == 0;
+}
+
+// Channel tried by probe `n` (0-based): the preferred one, then the
+// channels above it, wrapping round to 1
+inline uint8_t channelProbe(uint8_t n, uint8_t preferred)
+{
+  if (preferred < 1 || preferred > WIFI_CHANNEL_COUNT)
+    preferred = 1;
+  return (uint8_t)((preferred - 1 + n) % WIFI_CHANNEL_COUNT + 1);
+}
+
+// Outcome of a send on `ch`, acked or not; `probed` when it was a full
+// probe of every channel
+inline void channelSent(TxChannel &c, uint8_t ch, bool acked, bool probed = false)
+{
+  if (acked)
+  {
+    c.channel = ch;
+    c.failedSends = 0;
+    c.failedProbes = 0;
+    c.probeIn = 0;
+    return;
+  }
+  if (probed)
+  {
+    if (c.failedProbes < 0xFF)
+      c.failedProbes++;
+    uint32_t skip = c.failedProbes < 8 ? 1u << c.failedProbes : TX_CHANNEL_PROBE_MAX_SKIP;
+    c.probeIn = (uint8_t)(skip < TX_CHANNEL_PROBE_MAX_SKIP ? skip : TX_CHANNEL_PROBE_MAX_SKIP);
+    return;
+  }
+  if (c.channel == 0)
+  {
+    if (c.probeIn > 0)
+      c.probeIn--;
+    return;
+  }
+  if (++c.failedSends >= TX_CHANNEL_RELEARN_FAILS)
+  {
+    c.channel = 0;
+    c.failedSends = 0; // probe right away: the receiver may have moved
+  }
+}
@@ -0,0 +1,140 @@
+// ============================================
+// TRANSMITTER EVENT JOURNAL
+// ============================================
+// Button transitions waiting for the receiver's ACK, kept in RTC
+// memory so they survive deep sleep. Every send carries the whole
+// backlog as one frame, each record aged by how long ago its press
+// happened (PACKET_FLAG_RECORD_AGE), so a game started during an RF
+// burst is still timed from the press once the link returns.
+//
+// Entries always alternate occupied/available. A press undone within
+// TX_COALESCE_MS cancels out before it is ever sent, and a full
+// journal drops its oldest entry: the newest one is the court's
+// current state, which is what matters most.
+//
+// Failed sends back off exponentially with jitter, so several courts
+// that lost the link together do not retry in lockstep.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "court_packet.h"
+
+#ifndef TX_JOURNAL_DEPTH
+#define TX_JOURNAL_DEPTH 8
+#endif
+#ifndef TX_COALESCE_MS
+#define TX_COALESCE_MS 3000 // a press undone this quickly never happened
+#endif
+#ifndef TX_RETRY_BASE_MS
+#define TX_RETRY_BASE_MS 25 // first retry delay, doubled per failure
+#endif
+#ifndef TX_RETRY_MAX_MS
+#define TX_RETRY_MAX_MS 60000
+#endif
+
+static_assert(TX_JOURNAL_DEPTH <= PACKET_MAX_RECORDS, "the backlog must fit one frame");
+
+struct TxJournalEntry
+{
+  uint32_t atMs; // sender clock at the press
+  uint8_t occupied;
+};
+
+struct TxJournal
+{
+  TxJournalEntry entries[TX_JOURNAL_DEPTH]; // oldest first
+  uint8_t count;
+  uint8_t attempts;   // failed sends of the current backlog
+  uint16_t seq;       // frame seq carrying the current backlog, 0 = none yet
+  uint32_t retryAtMs; // earliest next attempt after a failure
+  uint32_t dropped;   // entries lost to a full journal
+};
+
+inline void journalInit(TxJournal &j)
+{
+  j.count = 0;
+  j.attempts = 0;
+  j.seq = 0;
+  j.retryAtMs = 0;
+  j.dropped = 0;
+}
+
+// The court changed to `occupied` at `atMs`. A new backlog is due
+// for sending right away and gets a fresh frame seq.
+inline void journalRecord(TxJournal &j, bool occupied, uint32_t atMs)
+{
+  j.seq = 0;
+  j.attempts = 0;
+  j.retryAtMs = atMs;
+
+  if (j.count > 0)
+  {
+    const TxJournalEntry &last = j.entries[j.count - 1];
+    if (last.occupied == (occupied ? 1 : 0))
+      return; // no change
+    if (atMs - last.atMs < TX_COALESCE_MS)
+    {
+      j.count--; // undone before it was delivered
+      return;
+    }
+  }
+
+  if (j.count == TX_JOURNAL_DEPTH)
+  {
+    for (size_t i = 1; i < TX_JOURNAL_DEPTH; i++)
+      j.entries[i - 1] = j.entries[i];
+    j.count--;
+    j.dropped++;
+  }
+  j.entries[j.count].atMs = atMs;
+  j.entries[j.count].occupied = occupied ? 1 : 0;
+  j.count++;
+}
+
+// Append the backlog to `f` as aged records, oldest first
+inline void journalFill(const TxJournal &j, CourtFrame &f, uint8_t courtId, uint32_t nowMs)
+{
+  for (size_t i = 0; i < j.count; i++)
+    addAgedCourtRecord(f, courtId, j.entries[i].occupied, nowMs - j.entries[i].atMs);
+}
+
+// Delay before retry number `attempts` (1 = first retry): exponential
+// with "equal jitter", i.e. uniformly in [half, full] of the step
+inline uint32_t journalBackoffMs(uint8_t attempts, uint32_t random)
+{
+  unsigned doublings = attempts > 0 ? attempts - 1u : 0u;
+  uint32_t step = doublings < 16 ? (uint32_t)TX_RETRY_BASE_MS << doublings : TX_RETRY_MAX_MS;
+  if (step > TX_RETRY_MAX_MS)
+    step = TX_RETRY_MAX_MS;
+  return step / 2 + random % (step - step / 2 + 1);
+}
+
+// Outcome of a send that carried the backlog
+inline void journalSent(TxJournal &j, bool acked, uint32_t nowMs, uint32_t random)
+{
+  if (acked)
+  {
+    j.count = 0;
+    j.attempts = 0;
+    j.seq = 0;
+    return;
+  }
+  if (j.attempts < 0xFF)
+    j.attempts++;
+  j.retryAtMs = nowMs + journalBackoffMs(j.attempts, random);
+}
+
+inline bool journalPending(const TxJournal &j)
+{
+  return j.count > 0;
+}
+
+// Milliseconds until the backlog should be tried again (0 = now);
+// meaningless when nothing is pending
+inline uint32_t journalRetryInMs(const TxJournal &j, uint32_t nowMs)
+{
+  int32_t left = (int32_t)(j.retryAtMs - nowMs);
+  return left > 0 ? (uint32_t)left : 0;
+}
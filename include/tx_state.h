@@ -0,0 +1,90 @@
+// ============================================
+// TRANSMITTER RETAINED STATE
+// ============================================
+// The court's occupied flag lives in RTC slow memory, which keeps its
+// contents through deep sleep and soft resets, so a press or a wake
+// never has to open NVS. A CRC tells a retained copy from the garbage
+// left after a power loss; then the state comes back from NVS.
+//
+// NVS is written lazily: a changed state is committed once it has
+// stood for TX_NVS_COMMIT_MS, or at once when power is at risk (low
+// battery), and never on the way to the radio. Losing power before
+// a commit rolls the button back to the committed state; the
+// receiver keeps the real one and the next press corrects it.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "crc.h"
+
+#ifndef TX_NVS_COMMIT_MS
+#define TX_NVS_COMMIT_MS 600000 // longest a change stays only in RTC memory
+#endif
+#ifndef TX_NVS_LOW_BATT_PCT
+#define TX_NVS_LOW_BATT_PCT 10 // at or below: commit every change right away
+#endif
+
+#define RETAINED_MAGIC 0x53435252u // "RRCS"
+
+struct RetainedCourtState
+{
+  uint32_t magic;
+  uint32_t changedAtMs; // first change not yet in NVS
+  uint8_t occupied;
+  uint8_t committed; // what NVS holds
+  uint16_t crc;      // CRC-16 of the fields above
+};
+
+inline uint16_t retainedCrc(const RetainedCourtState &s)
+{
+  return crc16((const uint8_t *)&s, offsetof(RetainedCourtState, crc));
+}
+
+inline bool retainedValid(const RetainedCourtState &s)
+{
+  return s.magic == RETAINED_MAGIC && s.crc == retainedCrc(s);
+}
+
+inline void retainedSeal(RetainedCourtState &s)
+{
+  s.magic = RETAINED_MAGIC;
+  s.crc = retainedCrc(s);
+}
+
+// Rebuild from the value read back from NVS (power-on, corrupt copy)
+inline void retainedInit(RetainedCourtState &s, bool nvsOccupied)
+{
+  s.changedAtMs = 0;
+  s.occupied = nvsOccupied ? 1 : 0;
+  s.committed = s.occupied;
+  retainedSeal(s);
+}
+
+inline bool retainedDirty(const RetainedCourtState &s)
+{
+  return s.occupied != s.committed;
+}
+
+inline void retainedSet(RetainedCourtState &s, bool occupied, uint32_t nowMs)
+{
+  uint8_t v = occupied ? 1 : 0;
+  if (v == s.occupied)
+    return;
+  if (!retainedDirty(s))
+    s.changedAtMs = nowMs; // the commit clock starts at the first change
+  s.occupied = v;
+  retainedSeal(s);
+}
+
+inline bool retainedCommitDue(const RetainedCourtState &s, uint32_t nowMs, bool powerAtRisk)
+{
+  return retainedDirty(s) && (powerAtRisk || nowMs - s.changedAtMs >= TX_NVS_COMMIT_MS);
+}
+
+// NVS now holds `occupied`
+inline void retainedCommitted(RetainedCourtState &s)
+{
+  s.committed = s.occupied;
+  retainedSeal(s);
+}
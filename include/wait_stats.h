@@ -0,0 +1,171 @@
+// ============================================
+// STREAMING WAIT STATISTICS
+// ============================================
+// Constant-memory game-length statistics, updated once per finished
+// game so display ticks only read cached numbers:
+//
+//   - EWMA, which follows the current pace of play
+//   - mean over the last 30 and 60 minutes, from a ring of
+//     WAIT_BUCKET_MS buckets keyed by game end time
+//   - p50 / p90 from a fixed-bin histogram, linearly interpolated
+//     inside the bin
+//
+// Windows are bucket-granular: "last 30 min" covers the current
+// bucket plus the five before it.
+
+#pragma once
+
+#include <cstdint>
+
+#ifndef WAIT_EWMA_ALPHA
+#define WAIT_EWMA_ALPHA 0.25f // weight of the newest game
+#endif
+#ifndef WAIT_BUCKET_MS
+#define WAIT_BUCKET_MS 300000UL // 5 min
+#endif
+#define WAIT_WINDOW_BUCKETS 12 // 60 min of buckets
+#define WAIT_SHORT_BUCKETS 6   // 30 min of buckets
+#ifndef WAIT_HIST_BIN_MS
+#define WAIT_HIST_BIN_MS 150000UL // 2.5 min
+#endif
+#define WAIT_HIST_BINS 24 // last bin also takes everything past 60 min
+
+struct WaitBucket
+{
+  uint32_t sumS; // game lengths in seconds
+  uint16_t count;
+};
+
+struct WaitStats
+{
+  float ewmaMs;
+  uint32_t count;
+
+  WaitBucket buckets[WAIT_WINDOW_BUCKETS];
+  uint32_t headBucket; // now / WAIT_BUCKET_MS of the newest bucket
+  uint32_t shortSumS, longSumS;
+  uint16_t shortCount, longCount;
+
+  uint16_t hist[WAIT_HIST_BINS];
+  uint32_t histTotal;
+  uint32_t p50Ms, p90Ms; // cached on every update
+};
+
+inline void initWaitStats(WaitStats &s)
+{
+  s.ewmaMs = 0.0f;
+  s.count = 0;
+  for (int i = 0; i < WAIT_WINDOW_BUCKETS; i++)
+    s.buckets[i] = WaitBucket{0, 0};
+  s.headBucket = 0;
+  s.shortSumS = s.longSumS = 0;
+  s.shortCount = s.longCount = 0;
+  for (int i = 0; i < WAIT_HIST_BINS; i++)
+    s.hist[i] = 0;
+  s.histTotal = 0;
+  s.p50Ms = s.p90Ms = 0;
+}
+
+// Rotate the bucket ring up to `now`, dropping buckets that left each
+// window from the running sums. Usually a no-op; at most
+// WAIT_WINDOW_BUCKETS steps however long it has been.
+inline void advanceWaitStats(WaitStats &s, uint32_t now)
+{
+  uint32_t target = now / WAIT_BUCKET_MS;
+  if (target <= s.headBucket)
+    return;
+
+  uint32_t steps = target - s.headBucket;
+  if (steps >= WAIT_WINDOW_BUCKETS)
+  {
+    for (int i = 0; i < WAIT_WINDOW_BUCKETS; i++)
+      s.buckets[i] = WaitBucket{0, 0};
+    s.shortSumS = s.longSumS = 0;
+    s.shortCount = s.longCount = 0;
+    s.headBucket = target;
+    return;
+  }
+
+  while (s.headBucket < target)
+  {
+    s.headBucket++;
+    // Leaving the 30-min window, still inside the 60-min one
+    const WaitBucket &mid = s.buckets[(s.headBucket + WAIT_WINDOW_BUCKETS - WAIT_SHORT_BUCKETS) % WAIT_WINDOW_BUCKETS];
+    s.shortSumS -= mid.sumS;
+    s.shortCount -= mid.count;
+    // Slot being reused left the 60-min window
+    WaitBucket &old = s.buckets[s.headBucket % WAIT_WINDOW_BUCKETS];
+    s.longSumS -= old.sumS;
+    s.longCount -= old.count;
+    old = WaitBucket{0, 0};
+  }
+}
+
+inline uint32_t waitPercentileMs(const WaitStats &s, float q)
+{
+  if (s.histTotal == 0)
+    return 0;
+  float rank = q * (float)s.histTotal;
+  uint32_t seen = 0;
+  for (int i = 0; i < WAIT_HIST_BINS; i++)
+  {
+    if (s.hist[i] == 0)
+      continue;
+    if ((float)(seen + s.hist[i]) >= rank)
+    {
+      float frac = (rank - (float)seen) / (float)s.hist[i];
+      return (uint32_t)((i + frac) * (float)WAIT_HIST_BIN_MS);
+    }
+    seen += s.hist[i];
+  }
+  return (uint32_t)(WAIT_HIST_BINS * WAIT_HIST_BIN_MS);
+}
+
+// Fold one finished game (ending at `now`) into every statistic
+inline void addWaitSample(WaitStats &s, uint32_t gameMs, uint32_t now)
+{
+  s.count++;
+  if (s.count == 1)
+    s.ewmaMs = (float)gameMs;
+  else
+    s.ewmaMs += WAIT_EWMA_ALPHA * ((float)gameMs - s.ewmaMs);
+
+  advanceWaitStats(s, now);
+  WaitBucket &b = s.buckets[s.headBucket % WAIT_WINDOW_BUCKETS];
+  uint32_t gameS = (gameMs + 500) / 1000;
+  b.sumS += gameS;
+  b.count++;
+  s.shortSumS += gameS;
+  s.shortCount++;
+  s.longSumS += gameS;
+  s.longCount++;
+
+  uint32_t bin = gameMs / WAIT_HIST_BIN_MS;
+  if (bin >= WAIT_HIST_BINS)
+    bin = WAIT_HIST_BINS - 1;
+  if (s.hist[bin] == 0xFFFF)
+  {
+    // Halve everything: keeps the shape, favours recent games slightly
+    s.histTotal = 0;
+    for (int i = 0; i < WAIT_HIST_BINS; i++)
+    {
+      s.hist[i] >>= 1;
+      s.histTotal += s.hist[i];
+    }
+  }
+  s.hist[bin]++;
+  s.histTotal++;
+
+  s.p50Ms = waitPercentileMs(s, 0.5f);
+  s.p90Ms = waitPercentileMs(s, 0.9f);
+}
+
+// Mean game length over the last 30 (shortWindow) or 60 minutes;
+// 0 when no game ended in that window
+inline uint32_t windowMeanMs(WaitStats &s, uint32_t now, bool shortWindow)
+{
+  advanceWaitStats(s, now);
+  uint32_t sumS = shortWindow ? s.shortSumS : s.longSumS;
+  uint16_t n = shortWindow ? s.shortCount : s.longCount;
+  return n ? (uint32_t)((uint64_t)sumS * 1000 / n) : 0;
+}
@@ -0,0 +1,73 @@
+// ============================================
+// WAKE SCHEDULING
+// ============================================
+// The receiver's tasks block on task notifications instead of
+// polling: the radio callback wakes the state task for packets, a
+// snapshot with a visible change wakes the render task, and otherwise
+// each sleeps until the earliest moment something on screen or in its
+// own work is due. These helpers compute those moments from the same
+// state the renderer draws, so a sleep never skips a visible change.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "receiver_logic.h"
+
+#ifndef OLED_REFRESH_MS
+#define OLED_REFRESH_MS 5000
+#endif
+
+// Earliest of several deadlines, wrap-safe against the 32-bit clock.
+// Deadlines already in the past clamp to `now`.
+class WakeDeadline
+{
+public:
+  WakeDeadline(uint32_t now, uint32_t maxSleepMs) : now_(now), at_(now + maxSleepMs) {}
+
+  void at(uint32_t t)
+  {
+    int32_t in = (int32_t)(t - now_);
+    if (in <= 0)
+      at_ = now_;
+    else if (in < (int32_t)(at_ - now_))
+      at_ = t;
+  }
+
+  uint32_t ms() const { return at_; }
+  uint32_t sleepMs() const { return at_ - now_; }
+
+private:
+  uint32_t now_;
+  uint32_t at_;
+};
+
+// Earliest time after `now` at which the court rows of the page
+// starting at `firstCourt` (0-based) draw differently: a running
+// clock's seconds digit, a Fault deadline, or the page flip. Header
+// values that move on a minute scale (Avg:, the Next: estimate) are
+// left to the `maxSleepMs` refresh.
+template <size_t N>
+uint32_t nextTableChangeMs(const CourtState (&courts)[N], uint32_t now, int firstCourt, uint32_t maxSleepMs)
+{
+  WakeDeadline wake(now, maxSleepMs);
+  if (courtPageCount<N>() > 1)
+    wake.at((now / OLED_PAGE_MS + 1) * OLED_PAGE_MS);
+
+  for (int r = 0; r < COURTS_PER_PAGE && firstCourt + r < (int)N; r++)
+  {
+    const CourtState &c = courts[firstCourt + r];
+    if (!c.inUse || c.inUseSinceMs == 0 || courtFaulted(c, now))
+      continue; // Open / --- / Fault ?? rows are static
+    wake.at(now + 1000 - (now - c.inUseSinceMs) % 1000);
+    if (c.lastHeardMs > 0)
+      wake.at(c.lastHeardMs + (c.faultTimeoutMs ? c.faultTimeoutMs : FAULT_TIMEOUT_MS) + 1);
+  }
+  return wake.ms();
+}
+
+template <size_t N>
+uint32_t nextTableChangeMs(const BasicSystemState<N> &state, uint32_t now, int firstCourt, uint32_t maxSleepMs)
+{
+  return nextTableChangeMs(state.courts, now, firstCourt, maxSleepMs);
+}
@@ -16,6 +16,6 @@ env.AddCustomTarget(
     name="run",
     dependencies="$PROGPATH",
     actions=run_program,
-    title="Run OLED preview",
-    description="Run the native OLED preview program",
+    title="Run native program",
+    description="Run the native program built for this environment (preview, bench, ...)",
 )
@@ -0,0 +1,485 @@
+// Receiver logic benchmarks (native build)
+// Times the receiver's per-tick work at different court counts so
+// regressions in scaling show up without hardware.
+//
+//   pio run -e bench -t run
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include "receiver_logic.h"
+#include "court_prediction.h"
+#include "oled_render.h"
+#include "oled_screens.h"
+#include "instrumentation.h"
+#include "timer_wheel.h"
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  volatile uint32_t sink; // keeps the optimizer from discarding work
+
+  uint32_t nextRandom(uint32_t &s)
+  {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+  }
+
+  // One receiver tick: apply one packet, then build the visible page
+  // exactly as updateDisplay() does. Returns nanoseconds per tick.
+  template <size_t N, bool kRescanAverage>
+  double receiverTickNs(uint32_t ticks)
+  {
+    static BasicSystemState<N> state;
+    initSystemState(state);
+    openAllCourts(state, 0);
+
+    uint32_t rng = 0x1234567u;
+    uint32_t now = 1000;
+    auto start = Clock::now();
+
+    for (uint32_t t = 0; t < ticks; t++)
+    {
+      now += 20;
+      uint32_t r = nextRandom(rng);
+      CourtPacket pkt = {(uint8_t)(1 + r % N), (uint8_t)((r >> 8) & 1)};
+      applyPacket(state, pkt, now);
+
+      int first = courtPageAt<N>(now) * COURTS_PER_PAGE;
+      for (int row = 0; row < COURTS_PER_PAGE && first + row < (int)N; row++)
+      {
+        CourtRowFields f;
+        formatCourtRow(state.courts[first + row], first + row + 1, now, f);
+        sink = sink + (uint8_t)f.now[0];
+      }
+      sink = sink + (kRescanAverage ? globalAverageWaitMs(state) : currentWaitMs(state, now));
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return (double)elapsed.count() / ticks;
+  }
+
+  template <size_t N>
+  void benchCourtCount(uint32_t ticks)
+  {
+    double cached = receiverTickNs<N, false>(ticks);
+    double rescan = receiverTickNs<N, true>(ticks);
+    std::printf("%6u %10u %14.1f %14.1f\n", (unsigned)N,
+                (unsigned)sizeof(BasicSystemState<N>), cached, rescan);
+  }
+
+  // Model of the Adafruit GFX + SSD1306 text path updateDisplay() used
+  // before oled_render.h: virtual per-pixel writes with bounds checks,
+  // line wrap, getTextBounds() and snprintf'd row fields. Same font.
+  class GfxModel
+  {
+  public:
+    virtual ~GfxModel() {}
+    virtual void drawPixel(int16_t x, int16_t y)
+    {
+      if (x >= 0 && x < FB_WIDTH && y >= 0 && y < FB_HEIGHT)
+      {
+        switch (rotation_)
+        {
+        case 0:
+          break;
+        default:
+          return;
+        }
+        buf[x + (y / 8) * FB_WIDTH] |= (uint8_t)(1 << (y & 7));
+      }
+    }
+
+    void clearDisplay() { memset(buf, 0, sizeof(buf)); }
+    void setCursor(int16_t x, int16_t y)
+    {
+      cx_ = x;
+      cy_ = y;
+    }
+
+    void print(const char *s)
+    {
+      for (; *s; s++)
+      {
+        if (cx_ + 6 > FB_WIDTH) // wrap
+        {
+          cx_ = 0;
+          cy_ += 8;
+        }
+        drawChar(cx_, cy_, *s);
+        cx_ += 6;
+      }
+    }
+
+    void getTextBounds(const char *s, int16_t *w)
+    {
+      int16_t x = 0, minx = FB_WIDTH, maxx = -1;
+      for (; *s; s++)
+      {
+        if (x + 6 > FB_WIDTH)
+          x = 0;
+        int16_t x2 = x + 5;
+        if (x < minx)
+          minx = x;
+        if (x2 > maxx)
+          maxx = x2;
+        x += 6;
+      }
+      *w = maxx >= minx ? maxx - minx + 1 : 0;
+    }
+
+    void drawFastHLine(int16_t y)
+    {
+      uint8_t *p = &buf[(y / 8) * FB_WIDTH];
+      uint8_t mask = (uint8_t)(1 << (y & 7));
+      for (int w = FB_WIDTH; w--;)
+        *p++ |= mask;
+    }
+
+    uint8_t buf[FB_BYTES];
+
+  private:
+    void drawChar(int16_t x, int16_t y, char c)
+    {
+      if (x >= FB_WIDTH || y >= FB_HEIGHT || x + 5 < 0 || y + 7 < 0)
+        return;
+      const uint8_t *cols = fontGlyph(c);
+      for (int8_t i = 0; i < 5; i++)
+      {
+        uint8_t line = cols[i];
+        for (int8_t j = 0; j < 8; j++, line >>= 1)
+          if (line & 1)
+            drawPixel(x + i, y + j);
+      }
+    }
+
+    int16_t cx_ = 0, cy_ = 0;
+    uint8_t rotation_ = 0;
+  };
+
+  // The pre-oled_render.h body of updateDisplay()'s normal view
+  template <size_t N>
+  void renderTableGfx(GfxModel &d, BasicSystemState<N> &state, uint32_t now)
+  {
+    d.clearDisplay();
+    unsigned long overallMs = currentWaitMs(state, now);
+    d.setCursor(0, 0);
+    d.print("RallyRack");
+    d.setCursor(1, 0);
+    d.print("RallyRack");
+    char ovBuf[26]; // "Avg:" + any unsigned long + "m"
+    snprintf(ovBuf, sizeof(ovBuf), "Avg:%lum", minutesFromMs(overallMs));
+    int16_t w;
+    d.getTextBounds(ovBuf, &w);
+    d.setCursor(FB_WIDTH - w, 0);
+    d.print(ovBuf);
+
+    d.setCursor(0, 10);
+    d.print("#");
+    d.setCursor(18, 10);
+    d.print("Status");
+    d.setCursor(78, 10);
+    d.print("Now");
+    d.setCursor(108, 10);
+    d.print("Avg");
+    d.drawFastHLine(19);
+
+    int first = courtPageAt<N>(now) * COURTS_PER_PAGE;
+    for (int r = 0; r < COURTS_PER_PAGE && first + r < (int)N; r++)
+    {
+      int rowY = 22 + r * 10;
+      CourtRowFields row;
+      formatCourtRow(state.courts[first + r], first + r + 1, now, row);
+      d.setCursor(0, rowY);
+      d.print(row.num);
+      d.setCursor(18, rowY);
+      d.print(row.status);
+      d.setCursor(78, rowY);
+      d.print(row.now);
+      d.setCursor(108, rowY);
+      d.print(row.avg);
+    }
+  }
+
+  // Render the normal view `frames` times through both paths on a
+  // changing board; every frame is compared byte for byte
+  template <size_t N>
+  void benchRender(uint32_t frames)
+  {
+    static BasicSystemState<N> state;
+    static GfxModel gfx;
+    static OledRenderCache cache;
+    static uint8_t fb[FB_BYTES];
+    initSystemState(state);
+    openAllCourts(state, 0);
+
+    uint32_t rng = 0x2468ACEu;
+    uint32_t now = 1000, mismatches = 0;
+    double gfxNs = 0, cachedNs = 0;
+    for (uint32_t f = 0; f < frames; f++)
+    {
+      now += 250; // a few redraws per second
+      uint32_t r = nextRandom(rng);
+      CourtPacket pkt = {(uint8_t)(1 + r % N), (uint8_t)((r >> 8) & 1)};
+      if ((r >> 16) % 8 == 0)
+        applyPacket(state, pkt, now);
+
+      auto t0 = Clock::now();
+      renderTableGfx(gfx, state, now);
+      auto t1 = Clock::now();
+      renderCourtTable(cache, fb, state, nullptr, currentWaitMs(state, now),
+                       courtPageAt<N>(now) * COURTS_PER_PAGE, now);
+      auto t2 = Clock::now();
+      gfxNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+      cachedNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+      mismatches += memcmp(gfx.buf, fb, FB_BYTES) != 0;
+      sink = sink + fb[(r >> 4) % FB_BYTES];
+    }
+
+    std::printf("%6u %12.0f %12.0f %9.1fx %11u\n", (unsigned)N, gfxNs / frames, cachedNs / frames,
+                gfxNs / cachedNs, (unsigned)mismatches);
+  }
+
+  // Per-frame latency distributions for each screen the receiver
+  // draws, plus the dirty-span diff that precedes every flush, through
+  // the same ScopedTimer/histograms the firmware's probes use. Means
+  // hide the tail; these show it.
+  template <size_t N>
+  void benchFrameLatency(uint32_t frames)
+  {
+    static BasicSystemState<N> state;
+    static OledRenderCache cache;
+    static MemoryTarget target;
+    static FrameDiffer differ;
+    LatencyHistogram table, alert, anim, diff;
+    initSystemState(state);
+    openAllCourts(state, 0);
+    differ.invalidate();
+
+    uint32_t rng = 0x13579BDu;
+    uint32_t now = 1000;
+    DirtySpan spans[OLED_MAX_SPANS];
+    for (uint32_t f = 0; f < frames; f++)
+    {
+      now += 250;
+      uint32_t r = nextRandom(rng);
+      CourtPacket pkt = {(uint8_t)(1 + r % N), (uint8_t)((r >> 8) & 1)};
+      applyPacket(state, pkt, now);
+      {
+        ScopedTimer t(table);
+        renderCourtTable(cache, target.buffer(), state, nullptr, currentWaitMs(state, now),
+                         courtPageAt<N>(now) * COURTS_PER_PAGE, now);
+      }
+      {
+        ScopedTimer t(diff);
+        sink = sink + (uint32_t)differ.diff(target.buffer(), spans, OLED_MAX_SPANS);
+      }
+      if (f % 4 == 0)
+      {
+        ScopedTimer t(alert);
+        drawCourtOpenAlert(target, pkt.courtId);
+      }
+      else
+      {
+        ScopedTimer t(anim);
+        drawGameStartedFrame(target, pkt.courtId, (int)(f % ANIM_TOTAL_FRAMES));
+      }
+      sink = sink + target.buffer()[r % FB_BYTES];
+    }
+
+    char line[128];
+    const LatencyHistogram *hists[] = {&table, &alert, &anim, &diff};
+    const char *names[] = {"table", "alert", "anim", "diff"};
+    for (int i = 0; i < 4; i++)
+    {
+      formatHistogramLine(line, sizeof(line), names[i], *hists[i]);
+      std::printf("%6u %s\n", (unsigned)N, line);
+    }
+  }
+
+  // Next-court prediction over `games` simulated games. Each court has
+  // its own lognormal game length (median 12-28 min) and short idle
+  // gaps, so a busy venue is full most of the time. Each game end
+  // scores the prediction made at the previous event against what
+  // actually happened, next to a naive "longest-running court" guess.
+  template <size_t N>
+  void benchPrediction(uint32_t games)
+  {
+    static BasicSystemState<N> state;
+    static CourtPredictor<N> predictor;
+    initSystemState(state);
+    openAllCourts(state, 0);
+    predictor.reset();
+
+    std::mt19937 rng(7);
+    std::vector<std::lognormal_distribution<double>> gameLen;
+    for (size_t c = 0; c < N; c++)
+      gameLen.emplace_back(std::log((12.0 + 16.0 * c / N) * 60000.0), 0.3);
+    std::exponential_distribution<double> idleLen(1.0 / 60000.0);
+
+    using Ev = std::pair<uint64_t, int>; // time, court (+1 start / -1 end)
+    std::priority_queue<Ev, std::vector<Ev>, std::greater<Ev>> q;
+    for (size_t c = 0; c < N; c++)
+      q.push({(uint64_t)idleLen(rng), (int)c + 1});
+
+    uint32_t ended = 0, scored = 0, hits = 0, naiveHits = 0;
+    double absErrMs = 0;
+    int predicted = -1;
+    uint32_t predictedAt = 0;
+    double eventNs = 0;
+
+    while (ended < games && !q.empty())
+    {
+      Ev ev = q.top();
+      q.pop();
+      uint32_t now = (uint32_t)ev.first;
+      int idx = (ev.second > 0 ? ev.second : -ev.second) - 1;
+      CourtPacket pkt = {(uint8_t)(idx + 1), (uint8_t)(ev.second > 0)};
+
+      if (ev.second < 0)
+      {
+        // Naive guess: whichever game has been running longest
+        int naive = -1;
+        for (size_t c = 0; c < N; c++)
+          if (state.courts[c].inUse && (naive < 0 || state.courts[c].inUseSinceMs < state.courts[naive].inUseSinceMs))
+            naive = (int)c;
+        if (predicted >= 0 && ended > games / 10) // let the histograms warm up
+        {
+          scored++;
+          hits += (predicted == idx);
+          naiveHits += (naive == idx);
+          absErrMs += std::fabs((double)now - (double)predictedAt);
+        }
+        ended++;
+      }
+
+      applyPacket(state, pkt, now);
+      auto start = Clock::now();
+      predictor.update(state, idx, now);
+      predictor.refresh(state, now);
+      eventNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+      predicted = predictor.size() ? predictor.courtAt(0) : -1;
+      predictedAt = predicted >= 0 ? now + predictor.remainingMs(0, now) : 0;
+
+      if (ev.second > 0)
+        q.push({ev.first + (uint64_t)gameLen[idx](rng), -(idx + 1)});
+      else
+        q.push({ev.first + (uint64_t)idleLen(rng), idx + 1});
+    }
+
+    std::printf("%6u %8u %12.1f %10.1f%% %10.1f%% %12.1f\n", (unsigned)N, (unsigned)ended,
+                eventNs / (2.0 * ended), 100.0 * hits / scored, 100.0 * naiveHits / scored,
+                absErrMs / scored / 60000.0);
+  }
+
+  // Fault detection over 10 simulated minutes: every court heartbeats
+  // every 15 s and one in 64 goes silent. The linear scan checks every
+  // court on each loop wake (every 20 ms); the wheel re-arms a court
+  // per packet and advances per wake. Returns ns per wake for both.
+  template <size_t N>
+  void benchFaultTimers()
+  {
+    const uint32_t kWakeMs = 20, kRunMs = 600000, kBeatMs = 15000, kTimeoutMs = 45000;
+    static uint32_t lastHeard[N];
+    static bool reported[N];
+    static TimerWheel<N> wheel;
+
+    // Courts heartbeating at each wake slot, staggered
+    std::vector<std::vector<uint16_t>> beats(kBeatMs / kWakeMs);
+    for (size_t c = 0; c < N; c++)
+      if (c % 64 != 63)
+        beats[c * 97 % beats.size()].push_back((uint16_t)c);
+
+    double ns[2] = {0, 0};
+    uint32_t faults[2] = {0, 0};
+    for (int useWheel = 0; useWheel < 2; useWheel++)
+    {
+      wheel.reset(0);
+      for (size_t c = 0; c < N; c++)
+      {
+        lastHeard[c] = 1;
+        reported[c] = false;
+        if (useWheel)
+          wheel.schedule((uint16_t)c, 1 + kTimeoutMs + 1);
+      }
+
+      auto start = Clock::now();
+      for (uint32_t now = kWakeMs; now <= kRunMs; now += kWakeMs)
+      {
+        for (uint16_t c : beats[now / kWakeMs % beats.size()])
+        {
+          lastHeard[c] = now;
+          if (useWheel)
+            wheel.schedule((uint16_t)c, now + kTimeoutMs + 1);
+        }
+
+        if (useWheel)
+        {
+          wheel.advance(now, [&](uint16_t) { faults[1]++; });
+        }
+        else
+        {
+          for (size_t c = 0; c < N; c++)
+          {
+            if (!reported[c] && now - lastHeard[c] > kTimeoutMs)
+            {
+              reported[c] = true;
+              faults[0]++;
+            }
+          }
+        }
+      }
+      ns[useWheel] = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (kRunMs / kWakeMs);
+    }
+
+    std::printf("%6u %14.1f %14.1f %8lu %8lu\n", (unsigned)N, ns[0], ns[1],
+                (unsigned long)faults[0], (unsigned long)faults[1]);
+  }
+}
+
+int main()
+{
+  const uint32_t kTicks = 2000000;
+  receiverTickNs<8, false>(kTicks / 10); // warm-up
+
+  std::printf("== receiver tick (apply packet + render one page) ==\n");
+  std::printf("%6s %10s %14s %14s\n", "courts", "state B", "ns/tick", "ns/tick rescan");
+  benchCourtCount<8>(kTicks);
+  benchCourtCount<24>(kTicks);
+  benchCourtCount<64>(kTicks);
+  benchCourtCount<255>(kTicks);
+
+  std::printf("\n== OLED court table (one 128x64 frame) ==\n");
+  std::printf("%6s %12s %12s %10s %11s\n", "courts", "gfx ns", "cached ns", "speedup", "mismatches");
+  benchRender<8>(200000);
+  benchRender<24>(200000);
+
+  std::printf("\n== OLED frame latency distribution (host us) ==\n");
+  benchFrameLatency<8>(200000);
+  benchFrameLatency<24>(200000);
+
+  std::printf("\n== next-court prediction (per game start/end) ==\n");
+  std::printf("%6s %8s %12s %11s %11s %12s\n", "courts", "games", "ns/event", "next hit", "naive hit", "err min");
+  benchPrediction<8>(20000);
+  benchPrediction<24>(20000);
+  benchPrediction<64>(20000);
+
+  std::printf("\n== fault deadlines (per loop wake, heartbeat work included) ==\n");
+  std::printf("%6s %14s %14s %8s %8s\n", "courts", "scan ns", "wheel ns", "faults", "fired");
+  benchFaultTimers<8>();
+  benchFaultTimers<64>();
+  benchFaultTimers<256>();
+  benchFaultTimers<1024>();
+
+  return 0;
+}
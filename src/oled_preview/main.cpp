@@ -1,6 +1,14 @@
 // OLED display preview tool (native build)
-// Renders the OLED lines to stdout for quick visual checks.
+// Renders the receiver's screens with the same code the firmware runs
+// into an in-memory framebuffer, from the shared fixture state. Prints
+// them to the terminal (two pixel rows per line) or writes PBM files.
+//
+//   pio run -e oled_preview -t run
+//   pio run -e oled_preview -t run -D run_args="--page 2"
+//   pio run -e oled_preview -t run -D run_args="--pbm frames"
+//   pio run -e oled_preview -t run -D run_args="--golden test/golden"
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
@@ -9,58 +17,111 @@
 
 namespace
 {
-  void printPage(const SystemState &state, int page)
+  using Clock = std::chrono::steady_clock;
+
+  // Upper/lower half blocks: one text line per two pixel rows
+  void printFrame(const MemoryTarget &t)
   {
-    unsigned long overallMs = globalAverageWaitMs(state);
+    std::printf("+");
+    for (int x = 0; x < FB_WIDTH; x++)
+      std::printf("-");
+    std::printf("+\n");
+    for (int y = 0; y < FB_HEIGHT; y += 2)
+    {
+      std::printf("|");
+      for (int x = 0; x < FB_WIDTH; x++)
+      {
+        bool top = t.lit(x, y), bottom = t.lit(x, y + 1);
+        std::printf("%s", top ? (bottom ? "█" : "▀") : (bottom ? "▄" : " "));
+      }
+      std::printf("|\n");
+    }
+    std::printf("+");
+    for (int x = 0; x < FB_WIDTH; x++)
+      std::printf("-");
+    std::printf("+\n");
+  }
 
-    // Title row
-    std::printf("RallyRack                Avg:%lum\n", minutesFromMs(overallMs));
-    // Column headers
-    std::printf("#  Status      Now    Avg\n");
-    std::printf("------------------------------\n");
+  // Mean render time of a scene in microseconds
+  template <typename Fn>
+  double renderUs(Fn &&render)
+  {
+    const int kRuns = 2000;
+    auto start = Clock::now();
+    for (int i = 0; i < kRuns; i++)
+      render();
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / kRuns;
+  }
 
-    int baseCourt = page * 4;
-    for (int row = 0; row < 4; row++)
+  bool writeFrame(const char *dir, const char *name, const MemoryTarget &t)
+  {
+    char path[512];
+    std::snprintf(path, sizeof(path), "%s/%s.pbm", dir, name);
+    if (!writePbm(path, t))
     {
-      int courtIndex = baseCourt + row;
-      CourtDisplayText line;
-      line.generate(state.courts[courtIndex], courtIndex + 1, kPreviewNowMs);
-      std::printf("%s\n", line.str());
+      std::fprintf(stderr, "oled_preview: cannot write %s\n", path);
+      return false;
     }
+    std::printf("%s\n", path);
+    return true;
   }
-}
 
-int main(int argc, char **argv)
-{
-  bool printBoth = true;
-  int page = 0;
-
-  if (argc >= 2)
+  // Golden scenes, plus every animation frame when `allFrames`
+  int dumpPbm(const char *dir, bool allFrames)
   {
-    if (std::strcmp(argv[1], "--page") == 0 && argc >= 3)
+    static MemoryTarget t;
+    for (int s = 0; s < kGoldenSceneCount; s++)
     {
-      int requested = std::atoi(argv[2]);
-      if (requested == 1 || requested == 2)
-      {
-        page = requested - 1;
-        printBoth = false;
-      }
+      renderGoldenScene(s, t);
+      if (!writeFrame(dir, kGoldenScenes[s], t))
+        return 1;
     }
+    if (!allFrames)
+      return 0;
+    for (int f = 0; f < ANIM_TOTAL_FRAMES; f++)
+    {
+      char name[16];
+      std::snprintf(name, sizeof(name), "anim_%02d", f);
+      drawGameStartedFrame(t, 6, f);
+      if (!writeFrame(dir, name, t))
+        return 1;
+    }
+    return 0;
   }
+}
 
-  SystemState state;
-  seedPreviewState(state);
+int main(int argc, char **argv)
+{
+  const int pageCount = courtPageCount<NUM_COURTS>();
+  int page = -1; // all
 
-  if (printBoth)
+  if (argc >= 3 && (std::strcmp(argv[1], "--pbm") == 0 || std::strcmp(argv[1], "--golden") == 0))
+    return dumpPbm(argv[2], std::strcmp(argv[1], "--pbm") == 0);
+  if (argc >= 3 && std::strcmp(argv[1], "--page") == 0)
   {
-    printPage(state, 0);
-    std::printf("\n");
-    printPage(state, 1);
+    int requested = std::atoi(argv[2]);
+    if (requested >= 1 && requested <= pageCount)
+      page = requested - 1;
   }
-  else
+
+  static MemoryTarget t;
+  if (page >= 0)
   {
-    printPage(state, page);
+    static OledRenderCache cache;
+    SystemState state;
+    seedPreviewState(state);
+    renderCourtTable(cache, t.buffer(), state, nullptr, currentWaitMs(state, kPreviewNowMs),
+                     page * COURTS_PER_PAGE, kPreviewNowMs);
+    printFrame(t);
+    return 0;
   }
 
+  for (int s = 0; s < kGoldenSceneCount; s++)
+  {
+    double us = renderUs([&]()
+                         { renderGoldenScene(s, t); });
+    std::printf("%s%s (%.1f us/frame)\n", s > 0 ? "\n" : "", kGoldenScenes[s], us);
+    printFrame(t);
+  }
   return 0;
 }
@@ -3,353 +3,667 @@
 // Receives court state (occupied/available) from transmitters via ESP-NOW.
 
 #include <esp_now.h>
+#include <esp_wifi.h>
 #include <WiFi.h>
 #include <Wire.h>
+#include <LittleFS.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include "config.h"
-#include <math.h>
+#include "receiver_logic.h"
+#include "spsc_queue.h"
+#include "link_stats.h"
+#include "court_prediction.h"
+#include "event_log.h"
+#include "telemetry.h"
+#include "state_sync.h"
+#include "oled_render.h"
+#include "oled_screens.h"
+#include "animation.h"
+#include "oled_flush.h"
+#include "instrumentation.h"
+#include "wake_schedule.h"
+#include "timer_wheel.h"
+#include "boot_clock.h"
+#include "render_pipeline.h"
+#include <sys/time.h>
+#if OLED_ASYNC_FLUSH
+#include <driver/i2c.h>
+#endif
 #include <Fonts/FreeMonoBold9pt7b.h>
 
-bool courtAvailable[NUM_COURTS] = {true, true, true, true, true, true, true, true};
-bool courtInUse[NUM_COURTS] = {false};
-unsigned long availableSinceMs[NUM_COURTS] = {0};
-unsigned long inUseSinceMs[NUM_COURTS] = {0};
-float avgWaitMs[NUM_COURTS] = {0};
-uint32_t waitSamples[NUM_COURTS] = {0};
-unsigned long lastHeardMs[NUM_COURTS] = {0}; // last packet time per court (fault detection)
-bool oledReady = false;
-unsigned long lastOledUpdate = 0;
+// Two pinned tasks (see render_pipeline.h). The state task owns the
+// court board and everything that changes it; the render task owns
+// the OLED and its I2C bus.
+TaskHandle_t stateTask = nullptr;        // woken by onReceive() and the BOOT button
+TaskHandle_t renderTask = nullptr;       // woken by each published snapshot
+TaskLoad stateLoad, renderLoad;          // busy time per task, see reportTaskLoad()
+TaskLoadMark stateMark = {0, 0};
+TaskLoadMark renderMark = {0, 0};
+unsigned long lastTaskReportMs = 0;
+bool oledReady = false;                  // set in setup(), read-only afterwards
+
+using Board = BoardSnapshot<NUM_COURTS>;
+SnapshotMailbox<Board> boards;           // state task → render task
+SpscQueue<uint8_t, ANIM_QUEUE_DEPTH> animRequests; // courts whose game-started animation is due
+std::atomic<bool> scanRequested{false};  // serial 'i': the scan runs on the render task's bus
+
+// State task
+SystemState courts; // the radio callback never touches it
+bool boardChanged = true;                // differs visibly from the last published snapshot
+bool boardStale = false;                 // newer than the snapshot, nothing visible changed
+uint32_t boardVersion = 0;
+unsigned long publishedOverallMs = 0;    // "Avg:" in the last snapshot
+uint32_t lastServiceMs = 0;              // background work, every LOOP_SERVICE_MS
 int8_t alertCourtId = -1;                // court showing full-screen alert (-1 = none)
-unsigned long alertUntilMs = 0;          // when to return to normal display
-volatile int8_t gameStartedCourtId = -1; // triggers game-started animation in loop()
-Adafruit_SSD1306 display(OLED_WIDTH, OLED_HEIGHT, &Wire, -1);
+using Timers = CourtTimers<NUM_COURTS>;
+Timers::Wheel timers;                    // fault deadlines, alert expiry, prediction refresh
+SpscQueue<ReceivedFrame, RX_QUEUE_DEPTH> rxQueue; // onReceive() → state task
+volatile uint32_t rxRejected = 0;        // malformed frames dropped in onReceive()
+uint32_t badRecords = 0;                 // records naming a court we don't serve
+LinkTracker<LINK_MAX_SOURCES> links;     // per-transmitter sequence/loss tracking
+CourtPredictor<NUM_COURTS> predictor;    // in-use courts ordered by predicted free time
+EventLog eventLog;                       // court transitions in flash, replayed at boot
+bool eventLogReady = false;
+TelemetryStream<NUM_COURTS> telemetry;  // binary board stream for a dashboard, on Serial
+SyncProducer<NUM_COURTS> dashboardSync; // acked deltas for a bridge that talks back
+uint32_t clockOffsetMs = 0; // board clock = millis() + offset, continues across reboots
+RTC_NOINIT_ATTR RetainedClock retainedClock; // board clock across soft resets
+
+// Board clock used for every court timestamp. Resumes after a reboot
+// so replayed game timers stay valid (see boot_clock.h); time spent
+// powered off is not counted.
+uint32_t boardMillis()
+{
+  return millis() + clockOffsetMs;
+}
+
+// RTC timer: unlike millis() it keeps counting through a soft reset
+uint64_t rtcMicros()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+unsigned long lastLinkReportMs = 0;
+uint32_t lastReportedDrops = 0;
+uint32_t lastReportedRejects = 0;
+
+// Render task
+Adafruit_SSD1306 display(OLED_WIDTH, OLED_HEIGHT, &Wire, -1, OLED_I2C_HZ, OLED_I2C_HZ);
+FramePair frames;            // back: being drawn, front: on the panel
+FrameDiffer frameDiffer;     // shadow of what the panel currently shows
+OledRenderCache renderCache; // pre-rasterized title, headers and digit atlas
+FlushStats flushStats = {};  // bytes/flushes since the last stats report
+unsigned long lastFlushReportMs = 0;
+int8_t pendingInvert = -1;   // panel inversion to send with the next flush (-1 = unchanged)
+bool panelInverted = false;  // inversion the screens asked for
+std::atomic<bool> flushFailed{false}; // a transfer failed: the panel no longer matches frameDiffer
+#if OLED_ASYNC_FLUSH
+TaskHandle_t flushTask = nullptr;      // sends flushJob, see flushTaskMain()
+SemaphoreHandle_t flushIdle = nullptr; // taken while flushJob is on the bus
+FlushJob flushJob;                     // filled only while holding flushIdle
+#endif
+AnimationScheduler animator; // game-started animations, one frame per pass
+bool haveBoard = false;      // a snapshot has been fetched
+bool displayDirty = true;    // new snapshot since the last draw
+bool boardShown = false;     // court table drawn since boot (boot time report)
+uint32_t displayDueMs = 0;   // next scheduled redraw (see wake_schedule.h)
+
+#if INSTRUMENTATION_ENABLED
+// Each histogram is recorded by one task; the dump, the stats page and
+// 'r' read or clear them from the other, which at worst skews a sample
+Instruments probes;              // latency histograms, see serviceStats()
+uint32_t changeStamp = 0;        // receipt of the oldest state change not yet on screen
+bool changePending = false;
+uint32_t changeVersion = 0;      // first snapshot that carried changeStamp, 0 = none yet
+std::atomic<uint32_t> shownVersion{0}; // newest snapshot the render task put on the panel
+uint32_t recordedStamp = 0;      // render task: change already in the RxToScreen probe
+bool statsPageShown = false;     // hidden page in place of the court table
+volatile bool statsButtonPressed = false; // set by the BOOT button interrupt
+bool statsToggleRequested = false;        // 'p' on the serial port
+unsigned long lastStatsToggleMs = 0;
+#endif
+
+// One panel transaction through Wire; the caller is busy until it is
+// out. Wire's buffer limits data to OLED_I2C_CHUNK bytes.
+bool wireTransfer(const uint8_t *head, size_t headLen, const uint8_t *data, size_t len)
+{
+  Wire.beginTransmission(OLED_I2C_ADDR);
+  Wire.write(head, headLen);
+  if (len > 0)
+    Wire.write(data, len);
+  return Wire.endTransmission() == 0;
+}
 
-unsigned long globalAverageWaitMs()
+#if OLED_ASYNC_FLUSH
+// One panel transaction queued to the ESP-IDF I2C driver that Wire
+// installed on its port, data read straight from the framebuffer. The
+// driver's interrupt handler clocks it out while the calling task
+// sleeps, and the driver's bus lock serializes it with Wire users.
+bool idfTransfer(const uint8_t *head, size_t headLen, const uint8_t *data, size_t len)
 {
-  uint64_t weightedSum = 0;
-  uint32_t sampleCount = 0;
+  static uint8_t link[I2C_LINK_RECOMMENDED_SIZE(1)]; // start, address, head, data, stop
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(link, sizeof(link));
+  i2c_master_start(cmd);
+  i2c_master_write_byte(cmd, (OLED_I2C_ADDR << 1) | I2C_MASTER_WRITE, true);
+  i2c_master_write(cmd, head, headLen, true);
+  if (len > 0)
+    i2c_master_write(cmd, data, len, true);
+  i2c_master_stop(cmd);
+  esp_err_t err = i2c_master_cmd_begin(I2C_NUM_0, cmd, pdMS_TO_TICKS(OLED_FLUSH_TIMEOUT_MS));
+  i2c_cmd_link_delete_static(cmd);
+  return err == ESP_OK;
+}
 
-  for (int i = 0; i < NUM_COURTS; i++)
+// Sends each job flushDisplay() hands over, whole spans per
+// transaction, then gives flushIdle back
+void flushTaskMain(void *)
+{
+  for (;;)
   {
-    weightedSum += (uint64_t)avgWaitMs[i] * waitSamples[i];
-    sampleCount += waitSamples[i];
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    {
+      INSTR_SCOPE(probes[Probe::Flush]);
+      if (!forEachFlushTransfer(flushJob, FB_WIDTH, idfTransfer))
+        flushFailed.store(true, std::memory_order_relaxed);
+    }
+    xSemaphoreGive(flushIdle);
   }
-
-  if (sampleCount == 0)
-    return 0;
-
-  return weightedSum / sampleCount;
 }
-
-unsigned long minutesFromMs(unsigned long valueMs)
+#endif
+
+// Push only the regions of `fb` that changed since the last flush.
+// Replaces display.display(), which always sends the whole 1 KB. With
+// OLED_ASYNC_FLUSH this only waits for the previous frame to leave the
+// bus, hands the spans to the flush task and returns; `fb` must then
+// stay untouched until the next call.
+void flushDisplay(const uint8_t *fb)
 {
-  return (valueMs + 30000UL) / 60000UL;
+#if OLED_ASYNC_FLUSH
+  uint32_t waitStart = micros();
+  xSemaphoreTake(flushIdle, portMAX_DELAY);
+  flushStats.waitUs += micros() - waitStart;
+  FlushJob &job = flushJob;
+#else
+  INSTR_SCOPE(probes[Probe::Flush]);
+  FlushJob job;
+#endif
+  // A transfer of the last flush failed part way: resend the whole
+  // frame and the inversion rather than only what changed since
+  if (flushFailed.exchange(false, std::memory_order_relaxed))
+  {
+    flushStats.errors++;
+    frameDiffer.invalidate();
+    pendingInvert = panelInverted ? 1 : 0;
+  }
+  job.fb = fb;
+  job.count = (uint8_t)frameDiffer.diff(fb, job.spans, OLED_MAX_SPANS);
+  job.invert = pendingInvert;
+  pendingInvert = -1;
+  flushStats.flushes++;
+  flushStats.spans += job.count;
+
+#if OLED_ASYNC_FLUSH
+  flushStats.bytes += flushJobBytes(job, FB_WIDTH);
+  xTaskNotifyGive(flushTask);
+#else
+  flushStats.bytes += flushJobBytes(job, OLED_I2C_CHUNK);
+  if (!forEachFlushTransfer(job, OLED_I2C_CHUNK, wireTransfer))
+    flushFailed.store(true, std::memory_order_relaxed);
+#endif
 }
 
-void fmtMMSS(char *buf, size_t sz, unsigned long ms)
+// A frame drawn from snapshot `b` just reached the panel. Transitions
+// always change the screen (alert or animation), so this closes the
+// packet-to-screen probe, once per change.
+void noteFrameShown(const Board &b)
 {
-  unsigned long totalSec = ms / 1000;
-  unsigned long m = totalSec / 60;
-  unsigned long s = totalSec % 60;
-  if (m > 99)
-    m = 99; // cap at 99:59
-  snprintf(buf, sz, "%02lu:%02lu", m, s);
+#if INSTRUMENTATION_ENABLED
+  if (b.changeStamp && b.changeStamp != recordedStamp)
+  {
+    probes[Probe::RxToScreen].record(instrElapsedUs(b.changeStamp));
+    recordedStamp = b.changeStamp;
+  }
+  shownVersion.store(b.version, std::memory_order_release);
+#else
+  (void)b;
+#endif
 }
 
-void animateGameStarted(uint8_t courtNum)
+void reportFlushStats(unsigned long now)
 {
-  display.setFont(NULL); // ensure default font throughout animation
-  char courtLine[12];
-  snprintf(courtLine, sizeof(courtLine), "Court %d", courtNum);
-
-  const int FRAME_MS = 40;
-  const int PHASE1 = 19; // ball-bounce frames
-  const int TOTAL = 37;  // total frames (~1.5 s)
+  unsigned long elapsed = now - lastFlushReportMs;
+  if (elapsed < OLED_STATS_MS)
+    return;
+  Serial.printf("[OLED] %lu B/s, %lu flushes, %lu spans, %lu resent, drawing waited %lums in %lus\n",
+                (unsigned long)((uint64_t)flushStats.bytes * 1000 / elapsed),
+                (unsigned long)flushStats.flushes,
+                (unsigned long)flushStats.spans,
+                (unsigned long)flushStats.errors,
+                (unsigned long)(flushStats.waitUs / 1000),
+                elapsed / 1000);
+  flushStats = {};
+  lastFlushReportMs = now;
+}
 
-  for (int f = 0; f < TOTAL; f++)
+// Panel-backed FrameTarget: screens draw into the back frame and
+// present() swaps it to the front and pushes only the changed spans.
+// The next frame is drawn while this one is still on the bus.
+class PanelTarget : public FrameTarget
+{
+public:
+  uint8_t *buffer() override { return frames.back(); }
+  void present() override
   {
-    int16_t bx, by;
-    uint16_t tw, th;
+    frames.swap();
+    flushDisplay(frames.front());
+  }
+  void setInverted(bool on) override
+  {
+    if (on != panelInverted)
+      pendingInvert = on ? 1 : 0; // ahead of the next frame's data
+    panelInverted = on;
+  }
+};
+PanelTarget panel;
 
-    if (f < PHASE1)
-    {
-      // Phase 1: bouncing ball + text slides in from top
-      display.invertDisplay(false);
-      display.clearDisplay();
-
-      float bt = (float)f / (PHASE1 - 1); // 0 → 1
-      int ballX = 6 + (int)(bt * 116);
-      float bouncePhase = bt * 3.0f * 3.14159f; // 3 arcs
-      float damping = 1.0f - bt * 0.55f;
-      int ballY = 56 - (int)(fabsf(sinf(bouncePhase)) * 30.0f * damping);
-
-      // Filled ball with tiny black holes — pickleball look
-      display.fillCircle(ballX, ballY, 4, SSD1306_WHITE);
-      display.drawPixel(ballX - 1, ballY - 1, SSD1306_BLACK);
-      display.drawPixel(ballX + 1, ballY - 1, SSD1306_BLACK);
-      display.drawPixel(ballX, ballY + 1, SSD1306_BLACK);
-
-      // "Court X" slides down from above the screen
-      int slideY = (f >= 9) ? 2 : (-16 + f * 2);
-      display.setTextSize(2);
-      display.getTextBounds(courtLine, 0, 0, &bx, &by, &tw, &th);
-      display.setCursor((OLED_WIDTH - tw) / 2, slideY);
-      display.print(courtLine);
-
-      // "game started!" fades in halfway through
-      if (f >= 10)
-      {
-        display.setTextSize(1);
-        display.getTextBounds("game started!", 0, 0, &bx, &by, &tw, &th);
-        display.setCursor((OLED_WIDTH - tw) / 2, 26);
-        display.print("game started!");
-      }
-    }
-    else
+// Advance the game-started animation by at most one frame.
+// Returns true while an animation owns the screen.
+bool serviceAnimation(unsigned long now)
+{
+  AnimFrame fr;
+  switch (animator.tick(now, fr))
+  {
+  case AnimTick::Frame:
+    if (oledReady)
     {
-      // Phase 2: static text + double border + 3 invert flashes
-      int p2f = f - PHASE1;
-      bool invert = (p2f < 6) && (p2f % 2 == 0);
-      display.invertDisplay(invert);
-      display.clearDisplay();
-
-      display.setTextSize(2);
-      display.getTextBounds(courtLine, 0, 0, &bx, &by, &tw, &th);
-      display.setCursor((OLED_WIDTH - tw) / 2, 10);
-      display.print(courtLine);
-
-      display.setTextSize(1);
-      display.getTextBounds("game started!", 0, 0, &bx, &by, &tw, &th);
-      display.setCursor((OLED_WIDTH - tw) / 2, 36);
-      display.print("game started!");
-
-      // Double border for a stadium feel
-      display.drawRect(0, 0, OLED_WIDTH, OLED_HEIGHT, SSD1306_WHITE);
-      display.drawRect(2, 2, OLED_WIDTH - 4, OLED_HEIGHT - 4, SSD1306_WHITE);
+      INSTR_SCOPE(probes[Probe::AnimFrame]);
+      drawGameStartedFrame(panel, fr.courtId, fr.frame);
+      panel.present();
+      noteFrameShown(boards.front());
     }
-
-    display.display();
-    delay(FRAME_MS);
+    return true;
+  case AnimTick::Hold:
+    return true;
+  case AnimTick::Done:
+    panel.setInverted(false);
+    displayDirty = true; // restore the normal view right away
+    return false;
+  case AnimTick::Idle:
+  default:
+    return false;
   }
-
-  display.invertDisplay(false);
-  display.setFont(NULL);
 }
 
-void updateDisplay()
+// Redraw when a new snapshot arrived or the scheduled change is due
+void updateDisplay(uint32_t now)
 {
-  if (!oledReady)
+  if (!oledReady || !haveBoard || (!displayDirty && (int32_t)(now - displayDueMs) < 0))
     return;
+  displayDirty = false;
+  const Board &b = boards.front();
 
-  unsigned long now = millis();
-  if (now - lastOledUpdate < OLED_UPDATE_MS)
+  // Full-screen alert: "Court X open!" until its timer fires
+  if (b.alertCourtId >= 0)
+  {
+    {
+      INSTR_SCOPE(probes[Probe::Render]);
+      drawCourtOpenAlert(panel, b.alertCourtId);
+    }
+    panel.present();
+    noteFrameShown(b);
+    displayDueMs = now + OLED_REFRESH_MS;
     return;
+  }
 
-  lastOledUpdate = now;
+#if INSTRUMENTATION_ENABLED
+  if (b.statsPage)
+  {
+    drawStatsPage(panel, probes);
+    panel.present();
+    displayDueMs = now + 1000;
+    return;
+  }
+#endif
 
-  display.clearDisplay();
-  display.setTextColor(SSD1306_WHITE);
+  // Normal view: COURTS_PER_PAGE courts, rotating every OLED_PAGE_MS,
+  // drawn straight into the framebuffer from cached glyphs (oled_render.h)
 
-  // Full-screen alert: "Court X open!"
-  if (alertCourtId >= 0 && now < alertUntilMs)
+  // With every court in use the title becomes the next-court estimate
+  char title[16];
+  const char *titleText = snapshotTitle(title, sizeof(title), b, now);
+  int firstCourt = courtPageAt<NUM_COURTS>(now) * COURTS_PER_PAGE;
   {
-    int16_t x1, y1;
-    uint16_t w, h;
-    char line1[12];
-    snprintf(line1, sizeof(line1), "Court %d", alertCourtId);
-    // "Court X" — large, centered, baseline at y=26
-    display.setFont(&FreeMonoBold9pt7b);
-    display.setTextSize(2);
-    display.getTextBounds(line1, 0, 0, &x1, &y1, &w, &h);
-    display.setCursor((OLED_WIDTH - w) / 2 - x1, 26);
-    display.print(line1);
-    // "open!" — smaller, centered, baseline at y=54
-    display.setTextSize(1);
-    display.getTextBounds("open!", 0, 0, &x1, &y1, &w, &h);
-    display.setCursor((OLED_WIDTH - w) / 2 - x1, 54);
-    display.print("open!");
-    display.setFont(NULL);
-    display.display();
-    return;
+    INSTR_SCOPE(probes[Probe::Render]);
+    renderCourtTable(renderCache, panel.buffer(), b.courts, titleText, b.overallMs, firstCourt, now);
   }
-  else
+  panel.present();
+  noteFrameShown(b);
+  if (!boardShown)
   {
-    alertCourtId = -1;
+    boardShown = true;
+    Serial.printf("[BOOT] first frame of the board %lums after start\n", (unsigned long)millis());
   }
+  displayDueMs = nextTableChangeMs(b.courts, now, firstCourt, OLED_REFRESH_MS);
+}
 
-  // Normal view: courts 1-4
-  // Column x positions (px): # @ 0, Status @ 18, Now @ 78, Avg @ 108
-  unsigned long overallMs = globalAverageWaitMs();
-  display.setTextSize(1);
+// Called when an ESP-NOW packet arrives (WiFi task).
+// Only decodes and enqueues — all state changes and logging
+// happen in the state task via processFrame().
+void onReceive(const uint8_t *mac, const uint8_t *data, int len)
+{
+  (void)mac;
 
-  // Row 1: title (bold via double-print) + overall avg right-aligned
-  display.setCursor(0, 0);
-  display.print("RallyRack");
-  display.setCursor(1, 0);
-  display.print("RallyRack");
+  ReceivedFrame rx;
+  if (len <= 0 || !decodeCourtFrame(data, (size_t)len, rx.frame))
   {
-    char ovBuf[10];
-    snprintf(ovBuf, sizeof(ovBuf), "Avg:%lum", minutesFromMs(overallMs));
-    int16_t x1, y1;
-    uint16_t w, h;
-    display.getTextBounds(ovBuf, 0, 0, &x1, &y1, &w, &h);
-    display.setCursor(OLED_WIDTH - w, 0);
-    display.print(ovBuf);
+    rxRejected = rxRejected + 1;
+    return;
   }
 
-  // Row 2: column headers aligned to data columns
-  display.setCursor(0, 10);
-  display.print("#");
-  display.setCursor(18, 10);
-  display.print("Status");
-  display.setCursor(78, 10);
-  display.print("Now");
-  display.setCursor(108, 10);
-  display.print("Avg");
-  display.drawFastHLine(0, 19, OLED_WIDTH, SSD1306_WHITE);
+  rx.rxMs = boardMillis();
+  rx.rxStamp = INSTR_STAMP();
+  rxQueue.push(rx); // counts a drop if the state task has fallen behind
+  if (stateTask)
+    xTaskNotifyGive(stateTask);
+}
+
+// Keep the refresh timer on the head of the prediction queue, the
+// next moment an estimate runs out
+void armPredictTimer(uint32_t now)
+{
+  if (predictor.size() > 0)
+    timers.schedule(Timers::kPredict, now + predictor.remainingMs(0, now));
+  else
+    timers.cancel(Timers::kPredict);
+}
 
-  // Court rows
-  for (int i = 0; i < 4; i++)
+// Apply one court record to the court state machine. `now` dates the
+// change (the button press); `heardMs` is when it arrived.
+PacketResult processPacket(const CourtPacket &pkt, uint32_t now, uint32_t heardMs)
+{
+  if (pkt.courtId < 1 || pkt.courtId > SystemState::kCourts)
   {
-    int rowY = 22 + (i * 10);
-    unsigned long avgMin = minutesFromMs((unsigned long)(avgWaitMs[i] + 0.5f));
+    badRecords++;
+    return PacketResult::Rejected;
+  }
 
-    char numStr[4];
-    char statusStr[8];
-    char nowStr[7]; // MM:SS + null
-    char avgStr[6]; // "99m" + null
+  const CourtState &court = courts.courts[pkt.courtId - 1];
+  uint32_t startedMs = court.inUseSinceMs; // before applyPacket clears it
 
-    snprintf(numStr, sizeof(numStr), "%d", i + 1);
-    snprintf(avgStr, sizeof(avgStr), "%2lum", avgMin);
+  PacketResult result = applyPacket(courts, pkt, now, heardMs);
+  armFaultTimer<NUM_COURTS>(timers, courts, pkt.courtId - 1);
+  if (result == PacketResult::Occupied || result == PacketResult::Freed)
+  {
+    if (eventLogReady)
+      eventLog.append(result == PacketResult::Occupied ? EV_OCCUPIED : EV_FREED, pkt.courtId, now);
+    predictor.update(courts, pkt.courtId - 1, heardMs);
+    predictor.refresh(courts, heardMs);
+    armPredictTimer(heardMs);
+    if (predictor.size() > 0)
+      Serial.printf("[NEXT] Court %d likely next, ~%lum (%u in use)\n",
+                    predictor.courtAt(0) + 1, minutesFromMs(predictor.remainingMs(0, heardMs)),
+                    (unsigned)predictor.size());
+  }
 
-    if (courtInUse[i] && inUseSinceMs[i] > 0)
+  switch (result)
+  {
+  case PacketResult::Occupied:
+    if (heardMs != now)
+      Serial.printf("[OCCUPIED] Court %d in use since %lus ago\n", pkt.courtId,
+                    (unsigned long)((heardMs - now) / 1000));
+    else
+      Serial.printf("[OCCUPIED] Court %d now in use\n", pkt.courtId);
+    animRequests.push(pkt.courtId); // with the next snapshot
+    break;
+
+  case PacketResult::Freed:
+    if (startedMs > 0)
     {
-      bool fault = (lastHeardMs[i] > 0) &&
-                   (now - lastHeardMs[i] > FAULT_TIMEOUT_MS);
-      if (fault)
-      {
-        snprintf(statusStr, sizeof(statusStr), "Fault");
-        snprintf(nowStr, sizeof(nowStr), "  ??");
-      }
-      else
-      {
-        snprintf(statusStr, sizeof(statusStr), "Started");
-        fmtMMSS(nowStr, sizeof(nowStr), now - inUseSinceMs[i]);
-      }
+      Serial.printf("[AVAILABLE] Court %d open after %lum, avg game=%lum\n",
+                    pkt.courtId,
+                    minutesFromMs(now - startedMs),
+                    minutesFromMs((unsigned long)(court.avgWaitMs + 0.5f)));
+      WaitStats &all = courts.allWaits;
+      Serial.printf("[STATS] all courts: ewma=%lum 30m=%lum 60m=%lum p50=%lum p90=%lum n=%lu\n",
+                    minutesFromMs((unsigned long)(all.ewmaMs + 0.5f)),
+                    minutesFromMs(windowMeanMs(all, now, true)),
+                    minutesFromMs(windowMeanMs(all, now, false)),
+                    minutesFromMs(all.p50Ms), minutesFromMs(all.p90Ms),
+                    (unsigned long)all.count);
     }
-    else if (courtAvailable[i])
+    else
     {
-      snprintf(statusStr, sizeof(statusStr), "Open");
-      snprintf(nowStr, sizeof(nowStr), "  --");
+      Serial.printf("[AVAILABLE] Court %d now open\n", pkt.courtId);
     }
-    else
+    // Trigger full-screen alert
+    alertCourtId = pkt.courtId;
+    timers.schedule(Timers::kAlert, heardMs + ALERT_MS);
+    break;
+
+  case PacketResult::Heartbeat:
+#if LOG_HEARTBEATS
+    Serial.printf("[HEARTBEAT] Court %d still %s\n", pkt.courtId,
+                  court.inUse ? "in use" : "available");
+#endif
+    break;
+
+  case PacketResult::Rejected:
+  default:
+    break;
+  }
+  return result;
+}
+
+#if INSTRUMENTATION_ENABLED
+// Start the packet-to-screen probe for a transition, unless an older
+// one is still waiting for the render task
+void noteBoardChange(uint32_t stamp)
+{
+  if (changePending && changeVersion != 0 &&
+      (int32_t)(shownVersion.load(std::memory_order_acquire) - changeVersion) >= 0)
+    changePending = false; // already on the panel
+  if (changePending)
+    return;
+  changeStamp = stamp;
+  changePending = true;
+  changeVersion = 0;
+}
+#endif
+
+// Drop duplicate/out-of-order frames, then apply every court record
+void processFrame(const ReceivedFrame &rx)
+{
+  if (links.observe(rx.frame, rx.rxMs) != SeqResult::Fresh)
+    return;
+  // A frame from a court shown as Fault clears it; otherwise only a
+  // transition changes what the screens draw. Plain heartbeats just
+  // refresh the snapshot for the render task's next wake.
+  if (frameClearsFault(courts, rx.frame, rx.rxMs))
+    boardChanged = true;
+  boardStale = true;
+  noteHeartbeatInterval(courts, rx.frame);
+  for (int i = 0; i < rx.frame.count; i++)
+  {
+    // Journaled records are dated from the press, not the delivery
+    uint32_t at = recordTimeMs(courts, rx.frame, i, rx.rxMs);
+    PacketResult result = processPacket(rx.frame.records[i], at, rx.rxMs);
+    if (result == PacketResult::Occupied || result == PacketResult::Freed)
     {
-      snprintf(statusStr, sizeof(statusStr), "---");
-      snprintf(nowStr, sizeof(nowStr), " --");
+      boardChanged = true;
+#if INSTRUMENTATION_ENABLED
+      noteBoardChange(rx.rxStamp);
+#endif
     }
+  }
+  INSTR_RECORD(probes[Probe::RxToState], instrElapsedUs(rx.rxStamp));
+}
 
-    display.setCursor(0, rowY);
-    display.print(numStr);
-    display.setCursor(18, rowY);
-    display.print(statusStr);
-    display.setCursor(78, rowY);
-    display.print(nowStr);
-    display.setCursor(108, rowY);
-    display.print(avgStr);
+// A court, alert or prediction deadline passed
+void onTimer(uint16_t id)
+{
+  uint32_t now = timers.now();
+  if (id < NUM_COURTS)
+  {
+    const CourtState &c = courts.courts[id];
+    Serial.printf("[FAULT] Court %u silent for %lus\n", (unsigned)id + 1,
+                  (unsigned long)((now - c.lastHeardMs) / 1000));
+  }
+  else if (id == Timers::kAlert)
+  {
+    alertCourtId = -1;
   }
+  else if (id == Timers::kPredict)
+  {
+    predictor.refresh(courts, now);
+    armPredictTimer(now);
+  }
+  boardChanged = true;
+}
 
-  display.display();
+// Periodic per-source link summary: loss, duplicates, reboots, battery
+void reportLinkStats(unsigned long now)
+{
+  if (now - lastLinkReportMs < LINK_STATS_MS)
+    return;
+  lastLinkReportMs = now;
+
+  for (size_t id = 1; id <= links.maxSources(); id++)
+  {
+    const LinkState &l = links.link((uint8_t)id);
+    if (!l.seen)
+      continue;
+    Serial.printf("[LINK] src %u: rx=%lu lost=%lu dup=%lu stale=%lu reboots=%lu batt=%u%% last=%lus ago\n",
+                  (unsigned)id, (unsigned long)l.received, (unsigned long)l.lost,
+                  (unsigned long)l.duplicates, (unsigned long)l.stale,
+                  (unsigned long)l.reboots, (unsigned)l.batteryPct,
+                  (unsigned long)((now - l.lastRxMs) / 1000));
+    if (l.awakeReports > 0)
+      Serial.printf("[LINK] src %u: awake last=%ums avg=%lums\n",
+                    (unsigned)id, (unsigned)l.awakeMs,
+                    (unsigned long)(l.awakeTotalMs / l.awakeReports));
+    if (l.pressReports > 0)
+      Serial.printf("[LINK] src %u: press to send last=%ums avg=%lums\n",
+                    (unsigned)id, (unsigned)l.pressMs,
+                    (unsigned long)(l.pressTotalMs / l.pressReports));
+  }
 }
 
-// Called when an ESP-NOW packet arrives
-void onReceive(const uint8_t *mac, const uint8_t *data, int len)
+#if INSTRUMENTATION_ENABLED
+// Every probe's histogram as one [PROBE] line
+void dumpProbes()
 {
-  (void)mac;
+  char line[128];
+  for (size_t i = 0; i < (size_t)Probe::Count; i++)
+  {
+    formatHistogramLine(line, sizeof(line), probeName((Probe)i), probes[(Probe)i]);
+    Serial.printf("[PROBE] %s\n", line);
+  }
+}
 
-  if (len < (int)sizeof(CourtPacket))
-    return;
+// Stats page toggles from the BOOT button and the 'p' command
+void serviceStats(unsigned long now)
+{
+  bool toggle = statsToggleRequested;
+  statsToggleRequested = false;
+
+  if (statsButtonPressed)
+  {
+    statsButtonPressed = false;
+    toggle = now - lastStatsToggleMs >= DEBOUNCE_MS; // contact bounce re-fires the edge
+  }
 
-  CourtPacket pkt;
-  memcpy(&pkt, data, sizeof(pkt));
+  if (toggle)
+  {
+    statsPageShown = !statsPageShown;
+    lastStatsToggleMs = now;
+    boardChanged = true;
+  }
+}
 
-  if (pkt.courtId < 1 || pkt.courtId > NUM_COURTS)
-    return;
+void IRAM_ATTR onStatsButton()
+{
+  statsButtonPressed = true;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(stateTask, &woken);
+  if (woken)
+    portYIELD_FROM_ISR();
+}
+#endif
 
-  int i = pkt.courtId - 1;
-  unsigned long now = millis();
-  lastHeardMs[i] = now; // stamp on every packet — used for fault detection
+// Drain everything the radio callback queued since the last pass
+void drainPackets()
+{
+  ReceivedFrame rx;
+  while (rxQueue.pop(rx))
+    processFrame(rx);
 
-  if (pkt.occupied)
+  uint32_t drops = rxQueue.dropped();
+  uint32_t rejects = rxRejected + badRecords;
+  if (drops != lastReportedDrops || rejects != lastReportedRejects)
   {
-    if (!courtInUse[i])
-    {
-      // Transition: available → occupied
-      Serial.printf("[OCCUPIED] Court %d now in use\n", pkt.courtId);
-      courtAvailable[i] = false;
-      availableSinceMs[i] = 0;
-      courtInUse[i] = true;
-      inUseSinceMs[i] = now;
-      gameStartedCourtId = (int8_t)pkt.courtId;
-    }
-    else
+    Serial.printf("[RX] queue drops=%lu rejected=%lu\n",
+                  (unsigned long)drops, (unsigned long)rejects);
+    lastReportedDrops = drops;
+    lastReportedRejects = rejects;
+  }
+}
+
+// Rebuild court state from the flash event log, or start every court
+// open as of boot when there is no log
+void restoreCourts()
+{
+  initSystemState(courts);
+
+  eventLogReady = LittleFS.begin(true) && eventLog.open(EVENT_LOG_DIR);
+  uint32_t replayed = 0;
+  if (eventLogReady)
+  {
+    unsigned long t0 = micros();
+    replayed = eventLog.replay(courts);
+    if (replayed > 0)
     {
-      Serial.printf("[HEARTBEAT] Court %d still in use\n", pkt.courtId);
+      Serial.printf("[LOG] replayed %lu events in %lu us (%lu torn segments)\n",
+                    (unsigned long)replayed, micros() - t0,
+                    (unsigned long)eventLog.stats().tornSegments);
     }
   }
   else
   {
-    if (!courtAvailable[i])
-    {
-      // Transition: occupied → available
-      // Record how long the game lasted and update rolling average
-      if (inUseSinceMs[i] > 0)
-      {
-        unsigned long gameMs = now - inUseSinceMs[i];
-        waitSamples[i]++;
-        avgWaitMs[i] += (gameMs - avgWaitMs[i]) / waitSamples[i];
-        Serial.printf("[AVAILABLE] Court %d open after %lum, avg game=%lum\n",
-                      pkt.courtId,
-                      minutesFromMs(gameMs),
-                      minutesFromMs((unsigned long)(avgWaitMs[i] + 0.5f)));
-      }
-      else
-      {
-        Serial.printf("[AVAILABLE] Court %d now open\n", pkt.courtId);
-      }
-      courtInUse[i] = false;
-      inUseSinceMs[i] = 0;
-      courtAvailable[i] = true;
-      availableSinceMs[i] = now;
-      // Trigger full-screen alert
-      alertCourtId = pkt.courtId;
-      alertUntilMs = now + 5000;
-    }
-    else
-    {
-      Serial.printf("[HEARTBEAT] Court %d still available\n", pkt.courtId);
-    }
+    Serial.println("[LOG] LittleFS unavailable, state will not survive a reboot");
   }
-}
 
-void setup()
-{
-  Serial.begin(115200);
-
-  // Init WiFi + ESP-NOW
-  WiFi.mode(WIFI_STA);
-  WiFi.disconnect();
+  uint32_t resumedMs;
+  ClockSource clock = bootBoardMs(retainedClock, rtcMicros(), replayed > 0, eventLog.lastTimeMs(),
+                                  millis(), resumedMs);
+  clockOffsetMs = resumedMs - millis();
+  if (clock != ClockSource::Fresh)
+    Serial.printf("[BOOT] board clock resumed from %s\n", clockSourceName(clock));
 
-  if (esp_now_init() != ESP_OK)
+  uint32_t now = boardMillis();
+  timers.reset(now);
+  if (replayed == 0)
   {
-    Serial.println("ESP-NOW init failed");
+    openAllCourts(courts, now);
     return;
   }
 
-  esp_now_register_recv_cb(onReceive);
+  // Give restored games one fault timeout to hear from their transmitters
+  for (int i = 0; i < SystemState::kCourts; i++)
+  {
+    if (courts.courts[i].inUse)
+      courts.courts[i].lastHeardMs = now;
+    predictor.update(courts, i, now);
+    armFaultTimer<NUM_COURTS>(timers, courts, i);
+  }
+  armPredictTimer(now);
+}
 
-  // I2C scan
-  Wire.begin(OLED_SDA, OLED_SCL);
+// Every address that ACKs on the OLED bus. A diagnostic only: the
+// panel is always at OLED_I2C_ADDR, and 126 probes cost boot time.
+void scanI2C()
+{
   Serial.println("Scanning I2C bus...");
   for (uint8_t addr = 1; addr < 127; addr++)
   {
@@ -359,64 +673,328 @@ void setup()
       Serial.printf("  Found device at 0x%02X\n", addr);
     }
   }
+}
 
-  // Init OLED
-  oledReady = display.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDR);
-  if (oledReady)
-  {
-    Serial.println("OLED init OK");
-    display.ssd1306_command(SSD1306_DISPLAYON);
-    display.dim(false);
-    display.clearDisplay();
-    display.setTextColor(SSD1306_WHITE);
-    // "RallyRack" in FreeMonoBold9pt7b, centered, baseline y=22
-    display.setFont(&FreeMonoBold9pt7b);
-    display.setTextSize(1);
+void drawSplash()
+{
+  display.clearDisplay();
+  display.setTextColor(SSD1306_WHITE);
+  // "RallyRack" in FreeMonoBold9pt7b, centered, baseline y=22
+  display.setFont(&FreeMonoBold9pt7b);
+  display.setTextSize(1);
+  {
+    int16_t x1, y1;
+    uint16_t w, h;
+    display.getTextBounds("RallyRack", 0, 0, &x1, &y1, &w, &h);
+    display.setCursor((OLED_WIDTH - w) / 2 - x1, 22);
+  }
+  display.print("RallyRack");
+  display.setFont(NULL);
+  display.setTextSize(1);
+  // "Wait time tracker" default font, centered below
+  {
+    int16_t x1, y1;
+    uint16_t w, h;
+    display.getTextBounds("Wait time tracker", 0, 0, &x1, &y1, &w, &h);
+    display.setCursor((OLED_WIDTH - w) / 2, 38);
+  }
+  display.print("Wait time tracker");
+  flushDisplay(display.getBuffer());
+  Serial.println("OLED splash drawn");
+}
+
+#if !SYNC_ENABLED
+// Single-letter commands on the USB serial port. With SYNC_ENABLED the
+// port carries the bridge's ACKs, so there are none.
+void serviceCommands()
+{
+  while (Serial.available() > 0)
+  {
+    switch (Serial.read())
     {
-      int16_t x1, y1;
-      uint16_t w, h;
-      display.getTextBounds("RallyRack", 0, 0, &x1, &y1, &w, &h);
-      display.setCursor((OLED_WIDTH - w) / 2 - x1, 22);
+    case 'i':
+      scanRequested = true;
+      if (renderTask)
+        xTaskNotifyGive(renderTask);
+      break;
+#if INSTRUMENTATION_ENABLED
+    case 's':
+      dumpProbes();
+      break;
+    case 'r':
+      probes.reset();
+      Serial.println("[PROBE] reset");
+      break;
+    case 'p':
+      statsToggleRequested = true;
+      break;
+#endif
+    default:
+      break;
     }
-    display.print("RallyRack");
-    display.setFont(NULL);
-    display.setTextSize(1);
-    // "Wait time tracker" default font, centered below
+  }
+}
+#endif
+
+#if OLED_I2C_FMP
+// Fast-mode Plus when the panel keeps ACKing at OLED_I2C_FMP_HZ,
+// otherwise back to OLED_I2C_HZ
+void selectBusClock()
+{
+  static const uint8_t kNop[] = {OLED_CTRL_COMMANDS, OLED_CMD_NOP};
+  Wire.setClock(OLED_I2C_FMP_HZ);
+  bool ok = true;
+  for (int i = 0; i < 8 && ok; i++)
+    ok = wireTransfer(kNop, sizeof(kNop), nullptr, 0);
+  if (!ok)
+    Wire.setClock(OLED_I2C_HZ);
+  Serial.printf("[OLED] I2C at %lu kHz%s\n", (unsigned long)(ok ? OLED_I2C_FMP_HZ : OLED_I2C_HZ) / 1000,
+                ok ? "" : " (panel does not ACK at Fast-mode Plus)");
+}
+#endif
+
+void initDisplay()
+{
+  Wire.begin(OLED_SDA, OLED_SCL);
+#if !FAST_BOOT
+  scanI2C();
+#endif
+
+  oledReady = display.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDR);
+  Wire.setClock(OLED_I2C_HZ);
+  frameDiffer.invalidate(); // panel RAM contents unknown after init
+  if (!oledReady)
+  {
+    Serial.println("OLED init failed");
+    return;
+  }
+  Serial.println("OLED init OK");
+  display.ssd1306_command(SSD1306_DISPLAYON);
+  display.dim(false);
+  // From here on all panel traffic goes through flushDisplay(); the
+  // Adafruit calls above would reset the bus clock
+#if OLED_I2C_FMP
+  selectBusClock();
+#endif
+#if OLED_ASYNC_FLUSH
+  flushIdle = xSemaphoreCreateBinary();
+  xSemaphoreGive(flushIdle);
+  xTaskCreatePinnedToCore(flushTaskMain, "flush", FLUSH_TASK_STACK, nullptr,
+                          FLUSH_TASK_PRIORITY, &flushTask, RENDER_TASK_CORE);
+#endif
+#if !FAST_BOOT
+  drawSplash();
+#endif
+}
+
+// Hand the render task an immutable copy of everything it draws
+// Hand the render task a copy of the board. `wake` when something
+// visible changed; otherwise it picks the copy up on its next wake,
+// before drawing anything (a Fault deadline it planned from an older
+// copy, say).
+void publishBoard(uint32_t now, bool wake)
+{
+  Board &b = boards.back();
+  publishedOverallMs = currentWaitMs(courts, now);
+  takeBoardSnapshot(b, courts, predictor, publishedOverallMs, now);
+  b.version = ++boardVersion;
+  b.alertCourtId = alertCourtId;
+#if INSTRUMENTATION_ENABLED
+  b.statsPage = statsPageShown;
+  b.changeStamp = changePending ? changeStamp : 0;
+  if (changePending && changeVersion == 0)
+    changeVersion = b.version;
+#else
+  b.statsPage = false;
+  b.changeStamp = 0;
+#endif
+  boards.publish();
+  boardChanged = false;
+  boardStale = false;
+  if (wake && renderTask)
+    xTaskNotifyGive(renderTask);
+}
+
+// Busy share and wake rate of both tasks since the last report
+void reportTaskLoad(unsigned long now)
+{
+  unsigned long elapsed = now - lastTaskReportMs;
+  if (elapsed < OLED_STATS_MS)
+    return;
+  char line[48];
+  formatTaskLoad(line, sizeof(line), stateLoad, stateMark, elapsed);
+  Serial.printf("[TASK] state (core %d) %s\n", STATE_TASK_CORE, line);
+  formatTaskLoad(line, sizeof(line), renderLoad, renderMark, elapsed);
+  Serial.printf("[TASK] render (core %d) %s\n", RENDER_TASK_CORE, line);
+  lastTaskReportMs = now;
+}
+
+// Everything that is not on the packet-to-screen path, every
+// LOOP_SERVICE_MS
+void serviceBackground(uint32_t now)
+{
+  reportLinkStats(now);
+  reportTaskLoad(now);
+  retainClock(retainedClock, now, rtcMicros());
+  if (currentWaitMs(courts, now) != publishedOverallMs)
+    boardChanged = true; // "Avg:" moved as old games left the window
+  if (eventLogReady)
+    eventLog.service(now, predictor.size() > 0);
+#if SYNC_ENABLED
+  while (Serial.available() > 0)
+    dashboardSync.receive((uint8_t)Serial.read());
+  dashboardSync.service(courts, predictor, now, [](const uint8_t *frame, size_t len)
+                        { Serial.write(frame, len); });
+#elif TELEMETRY_ENABLED
+  telemetry.service(courts, predictor, now, [](const uint8_t *frame, size_t len)
+                    { Serial.write(frame, len); });
+#endif
+}
+
+// One pass of the state task: packets, timers, commands, background
+// work, then a snapshot if the board changed. Returns how long it may
+// sleep before the next timer or background slot.
+uint32_t statePass()
+{
+  drainPackets();
+
+  uint32_t now = boardMillis();
+  timers.advance(now, onTimer);
+#if !SYNC_ENABLED
+  serviceCommands();
+#endif
+#if INSTRUMENTATION_ENABLED
+  serviceStats(now);
+#endif
+  if (now - lastServiceMs >= LOOP_SERVICE_MS)
+  {
+    lastServiceMs = now;
+    serviceBackground(now);
+  }
+  if (boardChanged || boardStale)
+    publishBoard(now, boardChanged);
+
+  WakeDeadline wake(now, LOOP_SERVICE_MS - (now - lastServiceMs));
+  uint32_t timerAt;
+  if (timers.nextDeadline(timerAt))
+    wake.at(timerAt);
+  return wake.sleepMs();
+}
+
+// One pass of the render task: the newest snapshot, queued animations,
+// then at most one frame. Returns how long it may sleep before the
+// next animation frame or scheduled redraw.
+uint32_t renderPass()
+{
+  if (boards.fetch())
+  {
+    haveBoard = true;
+    displayDirty = true;
+  }
+  uint8_t courtId;
+  while (animRequests.pop(courtId))
+    animator.enqueue(courtId);
+  if (scanRequested.exchange(false))
+    scanI2C();
+
+  uint32_t now = boardMillis();
+  if (!serviceAnimation(now))
+    updateDisplay(now);
+  reportFlushStats(now);
+
+  WakeDeadline wake(now, OLED_REFRESH_MS);
+  if (animator.active())
+    wake.at(animator.nextFrameMs());
+  else if (oledReady && haveBoard)
+    wake.at(displayDirty ? now : displayDueMs);
+  return wake.sleepMs();
+}
+
+// Sleeps until a timer or background slot is due; onReceive() and the
+// BOOT button cut it short
+void stateTaskMain(void *)
+{
+  for (;;)
+  {
+    uint32_t wokeUs = micros();
+    uint32_t sleepMs = statePass();
+    stateLoad.add(micros() - wokeUs);
+
+    uint32_t sleepStamp = INSTR_STAMP();
+    bool notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs)) > 0;
+#if INSTRUMENTATION_ENABLED
+    if (!notified)
     {
-      int16_t x1, y1;
-      uint16_t w, h;
-      display.getTextBounds("Wait time tracker", 0, 0, &x1, &y1, &w, &h);
-      display.setCursor((OLED_WIDTH - w) / 2, 38);
+      uint32_t slept = instrElapsedUs(sleepStamp);
+      probes[Probe::LoopLate].record(slept > sleepMs * 1000 ? slept - sleepMs * 1000 : 0);
     }
-    display.print("Wait time tracker");
-    display.display();
-    Serial.println("OLED splash drawn");
+#else
+    (void)sleepStamp;
+    (void)notified;
+#endif
   }
-  else
+}
+
+// Sleeps until the next animation frame or scheduled redraw; a new
+// snapshot cuts it short
+void renderTaskMain(void *)
+{
+  for (;;)
   {
-    Serial.println("OLED init failed");
+    uint32_t wokeUs = micros();
+    uint32_t sleepMs = renderPass();
+    renderLoad.add(micros() - wokeUs);
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs));
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  uint32_t t0 = millis();
+  restoreCourts(); // before ESP-NOW starts stamping packets with the board clock
+  uint32_t t1 = millis();
+  initDisplay();
+  Serial.printf("[BOOT] restore %lums, OLED init %lums\n",
+                (unsigned long)(t1 - t0), (unsigned long)(millis() - t1));
+  publishBoard(boardMillis(), true);
+#if FAST_BOOT
+  // The restored board is the first thing on the panel, before the
+  // radio comes up
+  renderPass();
+#endif
+
+  dashboardSync.reset((uint16_t)esp_random()); // new epoch: the bridge resyncs after a reboot
+
+  xTaskCreatePinnedToCore(stateTaskMain, "state", RECEIVER_TASK_STACK, nullptr,
+                          STATE_TASK_PRIORITY, &stateTask, STATE_TASK_CORE);
+  xTaskCreatePinnedToCore(renderTaskMain, "render", RECEIVER_TASK_STACK, nullptr,
+                          RENDER_TASK_PRIORITY, &renderTask, RENDER_TASK_CORE);
+
+  // Init WiFi + ESP-NOW, parked on the channel transmitters look for
+  WiFi.mode(WIFI_STA);
+  WiFi.disconnect();
+  esp_wifi_set_channel(ESPNOW_CHANNEL, WIFI_SECOND_CHAN_NONE);
+
+  if (esp_now_init() != ESP_OK)
+  {
+    Serial.println("ESP-NOW init failed");
+    return;
   }
 
+  esp_now_register_recv_cb(onReceive);
+#if INSTRUMENTATION_ENABLED
+  pinMode(STATS_BUTTON_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(STATS_BUTTON_PIN), onStatsButton, FALLING);
+#endif
+
   Serial.println("Rack controller ready");
   Serial.print("MAC: ");
   Serial.println(WiFi.macAddress());
-
-  // Seed open timestamps so "Now" shows time-since-boot for default-open courts
-  unsigned long bootMs = millis();
-  for (int i = 0; i < NUM_COURTS; i++)
-    availableSinceMs[i] = bootMs;
 }
 
+// Everything runs in the state and render tasks
 void loop()
 {
-  if (gameStartedCourtId >= 0)
-  {
-    uint8_t courtId = (uint8_t)gameStartedCourtId;
-    gameStartedCourtId = -1;
-    if (oledReady)
-      animateGameStarted(courtId);
-    lastOledUpdate = 0; // force display refresh after animation
-  }
-  updateDisplay();
-  delay(20);
+  vTaskDelete(nullptr);
 }
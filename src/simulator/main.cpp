@@ -0,0 +1,420 @@
+// Venue simulator (native build)
+// Discrete-event model of a venue full of court transmitters feeding
+// the real receiver pipeline (encode → decode → link tracking →
+// applyPacket) faster than real time. Used to size heartbeat
+// intervals and fault timeouts without a gym full of hardware.
+//
+//   pio run -e simulator -t run
+//   pio run -e simulator -t run -D run_args="--courts 64 --loss 0.1 --sweep"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <vector>
+#include "receiver_logic.h"
+#include "link_stats.h"
+#include "heartbeat_policy.h"
+
+namespace
+{
+  struct SimConfig
+  {
+    int courts = 8;
+    double hours = 8.0;
+    uint32_t heartbeatMs = 15000;
+    uint32_t jitterMs = 500;    // uniform ± jitter on every heartbeat
+    uint32_t faultMs = FAULT_TIMEOUT_MS;
+    double loss = 0.02;         // independent per-frame loss probability
+    double gameMedianMin = 18;  // lognormal game length
+    double gameSigma = 0.35;
+    double idleMeanMin = 3;     // exponential gap between games
+    double rebootsPerHour = 0.05;
+    uint32_t rebootDownMs = 4000;
+    uint32_t sampleMs = 1000;   // how often the display is "looked at"
+    uint32_t seed = 1;
+    bool sweep = false;
+    bool adaptive = false;      // HeartbeatPolicy + per-court fault deadlines
+  };
+
+  enum class EvType : uint8_t
+  {
+    Heartbeat,
+    Toggle,
+    Reboot,
+    RebootDone,
+    Sample
+  };
+
+  struct Event
+  {
+    uint64_t atMs;
+    EvType type;
+    int court; // 0-based, unused for Sample
+    uint32_t gen; // heartbeat generation, stale heartbeats are skipped
+
+    bool operator>(const Event &o) const { return atMs > o.atMs; }
+  };
+
+  struct Transmitter
+  {
+    bool occupied = false;
+    bool up = true;
+    uint16_t seq = 0;
+    uint64_t bootMs = 0;
+    uint64_t gameStartMs = 0;
+    uint32_t hbGen = 0;
+    HeartbeatPolicy hb;
+  };
+
+  struct SimResult
+  {
+    uint64_t events = 0;
+    uint64_t framesSent = 0;
+    uint64_t framesLost = 0;
+    uint64_t gamesPlayed = 0;
+    uint64_t faultSamples = 0;     // in-use court shown Fault while its unit was up
+    uint64_t liveSamples = 0;      // in-use court samples while its unit was up
+    uint64_t outageSamples = 0;    // in-use court samples while its unit was down
+    uint64_t outageFaultSamples = 0;
+    double avgErrorPct = 0;        // mean |receiver avg - true avg| per court
+    double overallErrorPct = 0;
+    uint64_t linkLost = 0;
+    uint64_t linkReboots = 0;
+    double wallSec = 0;
+  };
+
+  template <size_t N>
+  SimResult runSimulation(const SimConfig &cfg)
+  {
+    static BasicSystemState<N> state;
+    static LinkTracker<N> links;
+    initSystemState(state);
+    links.reset();
+
+    const int courts = cfg.courts;
+    std::mt19937 rng(cfg.seed);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::lognormal_distribution<double> gameLen(std::log(cfg.gameMedianMin * 60000.0), cfg.gameSigma);
+    std::exponential_distribution<double> idleLen(1.0 / (cfg.idleMeanMin * 60000.0));
+    std::exponential_distribution<double> rebootGap(cfg.rebootsPerHour > 0 ? cfg.rebootsPerHour / 3600000.0 : 1e-12);
+
+    std::vector<Transmitter> tx(courts);
+    std::vector<double> trueSum(courts, 0.0);
+    std::vector<uint32_t> trueCount(courts, 0);
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> q;
+
+    const uint64_t endMs = (uint64_t)(cfg.hours * 3600000.0);
+    SimResult res;
+
+    auto jittered = [&](uint32_t base) -> uint64_t
+    {
+      double j = (uni(rng) * 2.0 - 1.0) * cfg.jitterMs;
+      double v = base + j;
+      return v < 1 ? 1 : (uint64_t)v;
+    };
+
+    // Transmitter → air → receiver, through the same code the firmware runs
+    auto send = [&](int c, uint64_t now)
+    {
+      Transmitter &t = tx[c];
+      CourtFrame f;
+      initCourtFrame(f, (uint8_t)(c + 1), ++t.seq);
+      f.uptimeS = (uint32_t)((now - t.bootMs) / 1000);
+      addCourtRecord(f, (uint8_t)(c + 1), t.occupied);
+      if (cfg.adaptive)
+        setFrameExt(f, PACKET_EXT_INTERVAL_S, heartbeatNextIfAcked(t.hb));
+      uint8_t buf[PACKET_MAX_BYTES];
+      size_t len = encodeCourtFrame(f, buf, sizeof(buf));
+      res.framesSent++;
+      bool lost = uni(rng) < cfg.loss;
+      heartbeatAfterSend(t.hb, !lost); // ESP-NOW ACK ⇔ frame reached the receiver
+      if (lost)
+      {
+        res.framesLost++;
+        return;
+      }
+      CourtFrame rx;
+      if (!decodeCourtFrame(buf, len, rx))
+        return;
+      if (links.observe(rx, (uint32_t)now) != SeqResult::Fresh)
+        return;
+      noteHeartbeatInterval(state, rx);
+      for (int i = 0; i < rx.count; i++)
+        applyPacket(state, rx.records[i], (uint32_t)now);
+    };
+
+    auto scheduleHeartbeat = [&](int c, uint64_t now)
+    {
+      tx[c].hbGen++;
+      uint32_t interval = cfg.adaptive ? tx[c].hb.intervalS * 1000u : cfg.heartbeatMs;
+      q.push({now + jittered(interval), EvType::Heartbeat, c, tx[c].hbGen});
+    };
+
+    for (int c = 0; c < courts; c++)
+    {
+      // Stagger power-on so heartbeats don't start in lockstep
+      uint64_t on = (uint64_t)(uni(rng) * cfg.heartbeatMs);
+      tx[c].bootMs = on;
+      q.push({on, EvType::RebootDone, c, 0});
+      q.push({on + (uint64_t)idleLen(rng), EvType::Toggle, c, 0});
+      if (cfg.rebootsPerHour > 0)
+        q.push({on + (uint64_t)rebootGap(rng), EvType::Reboot, c, 0});
+    }
+    q.push({cfg.sampleMs, EvType::Sample, 0, 0});
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    while (!q.empty() && q.top().atMs < endMs)
+    {
+      Event ev = q.top();
+      q.pop();
+      res.events++;
+      uint64_t now = ev.atMs;
+
+      switch (ev.type)
+      {
+      case EvType::Heartbeat:
+        if (ev.gen != tx[ev.court].hbGen || !tx[ev.court].up)
+          break;
+        send(ev.court, now);
+        scheduleHeartbeat(ev.court, now);
+        break;
+
+      case EvType::Toggle:
+      {
+        Transmitter &t = tx[ev.court];
+        if (!t.up)
+        {
+          // Button pressed while the unit is rebooting — try again shortly
+          q.push({now + cfg.rebootDownMs, EvType::Toggle, ev.court, 0});
+          break;
+        }
+        t.occupied = !t.occupied;
+        heartbeatStateChanged(t.hb);
+        if (t.occupied)
+        {
+          t.gameStartMs = now;
+          q.push({now + (uint64_t)gameLen(rng), EvType::Toggle, ev.court, 0});
+        }
+        else
+        {
+          trueSum[ev.court] += (double)(now - t.gameStartMs);
+          trueCount[ev.court]++;
+          res.gamesPlayed++;
+          q.push({now + (uint64_t)idleLen(rng), EvType::Toggle, ev.court, 0});
+        }
+        send(ev.court, now);
+        scheduleHeartbeat(ev.court, now);
+        break;
+      }
+
+      case EvType::Reboot:
+        tx[ev.court].up = false;
+        q.push({now + cfg.rebootDownMs, EvType::RebootDone, ev.court, 0});
+        q.push({now + (uint64_t)rebootGap(rng), EvType::Reboot, ev.court, 0});
+        break;
+
+      case EvType::RebootDone:
+      {
+        // Power-on: sequence and uptime restart, state comes back from NVS
+        Transmitter &t = tx[ev.court];
+        t.up = true;
+        t.seq = 0;
+        t.bootMs = now;
+        initHeartbeat(t.hb);
+        send(ev.court, now);
+        scheduleHeartbeat(ev.court, now);
+        break;
+      }
+
+      case EvType::Sample:
+        for (int c = 0; c < courts; c++)
+        {
+          const CourtState &court = state.courts[c];
+          if (!court.inUse)
+            continue;
+          bool shownFault = cfg.adaptive ? courtFaulted(court, (uint32_t)now)
+                                         : courtFaulted(court, (uint32_t)now, cfg.faultMs);
+          if (tx[c].up)
+          {
+            res.liveSamples++;
+            res.faultSamples += shownFault;
+          }
+          else
+          {
+            res.outageSamples++;
+            res.outageFaultSamples += shownFault;
+          }
+        }
+        q.push({now + cfg.sampleMs, EvType::Sample, 0, 0});
+        break;
+      }
+    }
+
+    res.wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    double errSum = 0;
+    int errCourts = 0;
+    double allTrue = 0;
+    uint64_t allCount = 0;
+    for (int c = 0; c < courts; c++)
+    {
+      allTrue += trueSum[c];
+      allCount += trueCount[c];
+      const LinkState &l = links.link((uint8_t)(c + 1));
+      res.linkLost += l.lost;
+      res.linkReboots += l.reboots;
+      if (trueCount[c] == 0 || state.courts[c].waitSamples == 0)
+        continue; // no finished game to compare averages on
+      double truth = trueSum[c] / trueCount[c];
+      errSum += std::fabs(state.courts[c].avgWaitMs - truth) / truth;
+      errCourts++;
+    }
+    res.avgErrorPct = errCourts ? 100.0 * errSum / errCourts : 0;
+    if (allCount > 0)
+    {
+      double truth = allTrue / allCount;
+      res.overallErrorPct = 100.0 * std::fabs((double)overallAverageMs(state) - truth) / truth;
+    }
+    return res;
+  }
+
+  SimResult runForCourtCount(const SimConfig &cfg)
+  {
+    // Smallest compiled board that fits, like a firmware build would pick
+    if (cfg.courts <= 8)
+      return runSimulation<8>(cfg);
+    if (cfg.courts <= 24)
+      return runSimulation<24>(cfg);
+    if (cfg.courts <= 64)
+      return runSimulation<64>(cfg);
+    return runSimulation<255>(cfg);
+  }
+
+  double pct(uint64_t num, uint64_t den)
+  {
+    return den ? 100.0 * (double)num / (double)den : 0.0;
+  }
+
+  void printReport(const SimConfig &cfg, const SimResult &r)
+  {
+    double simSec = cfg.hours * 3600.0;
+    if (cfg.adaptive)
+      std::printf("courts=%d hours=%.1f heartbeat=adaptive %d-%ds±%lums fault=%dx loss=%.1f%% reboots/h=%.2f seed=%lu\n",
+                  cfg.courts, cfg.hours, HEARTBEAT_MIN_SEC, HEARTBEAT_MAX_SEC, (unsigned long)cfg.jitterMs,
+                  FAULT_HEARTBEAT_MULT, cfg.loss * 100.0, cfg.rebootsPerHour, (unsigned long)cfg.seed);
+    else
+      std::printf("courts=%d hours=%.1f heartbeat=%lums±%lu fault=%lums loss=%.1f%% reboots/h=%.2f seed=%lu\n",
+                  cfg.courts, cfg.hours, (unsigned long)cfg.heartbeatMs, (unsigned long)cfg.jitterMs,
+                  (unsigned long)cfg.faultMs, cfg.loss * 100.0, cfg.rebootsPerHour, (unsigned long)cfg.seed);
+    std::printf("  throughput     %.0f events/s (%.0fx real time, %llu events in %.3fs)\n",
+                r.events / r.wallSec, simSec / r.wallSec, (unsigned long long)r.events, r.wallSec);
+    std::printf("  frames         %llu sent, %llu lost on air, %llu gaps seen by receiver\n",
+                (unsigned long long)r.framesSent, (unsigned long long)r.framesLost,
+                (unsigned long long)r.linkLost);
+    std::printf("  games          %llu played, %llu transmitter reboots seen\n",
+                (unsigned long long)r.gamesPlayed, (unsigned long long)r.linkReboots);
+    std::printf("  false Fault    %.3f%% of in-use samples with a live transmitter\n",
+                pct(r.faultSamples, r.liveSamples));
+    std::printf("  outage caught  %.1f%% of in-use samples while transmitter was down\n",
+                pct(r.outageFaultSamples, r.outageSamples));
+    std::printf("  avg error      %.2f%% per court, %.2f%% overall\n", r.avgErrorPct, r.overallErrorPct);
+  }
+
+  // Grid of heartbeat intervals × fault timeout multiples
+  void runSweep(SimConfig cfg)
+  {
+    const uint32_t heartbeats[] = {5000, 10000, 15000, 30000, 60000};
+    const uint32_t multiples[] = {2, 3, 4, 6};
+    std::printf("courts=%d hours=%.1f loss=%.1f%% — false Fault %% (frames/court/hour)\n",
+                cfg.courts, cfg.hours, cfg.loss * 100.0);
+    std::printf("%10s", "hb \\ fault");
+    for (uint32_t m : multiples)
+      std::printf("%16ux", (unsigned)m);
+    std::printf("\n");
+    for (uint32_t hb : heartbeats)
+    {
+      std::printf("%9lus ", (unsigned long)(hb / 1000));
+      for (uint32_t m : multiples)
+      {
+        cfg.heartbeatMs = hb;
+        cfg.faultMs = hb * m;
+        SimResult r = runForCourtCount(cfg);
+        double perHour = r.framesSent / (cfg.hours * cfg.courts);
+        std::printf("%9.3f (%4.0f)", pct(r.faultSamples, r.liveSamples), perHour);
+      }
+      std::printf("\n");
+    }
+  }
+
+  bool parseArgs(int argc, char **argv, SimConfig &cfg)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      const char *a = argv[i];
+      const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+      if (std::strcmp(a, "--sweep") == 0)
+      {
+        cfg.sweep = true;
+        continue;
+      }
+      if (std::strcmp(a, "--adaptive") == 0)
+      {
+        cfg.adaptive = true;
+        continue;
+      }
+      if (!v)
+        return false;
+      if (std::strcmp(a, "--courts") == 0)
+        cfg.courts = std::atoi(v);
+      else if (std::strcmp(a, "--hours") == 0)
+        cfg.hours = std::atof(v);
+      else if (std::strcmp(a, "--heartbeat-ms") == 0)
+        cfg.heartbeatMs = (uint32_t)std::atol(v);
+      else if (std::strcmp(a, "--jitter-ms") == 0)
+        cfg.jitterMs = (uint32_t)std::atol(v);
+      else if (std::strcmp(a, "--fault-ms") == 0)
+        cfg.faultMs = (uint32_t)std::atol(v);
+      else if (std::strcmp(a, "--loss") == 0)
+        cfg.loss = std::atof(v);
+      else if (std::strcmp(a, "--game-min") == 0)
+        cfg.gameMedianMin = std::atof(v);
+      else if (std::strcmp(a, "--game-sigma") == 0)
+        cfg.gameSigma = std::atof(v);
+      else if (std::strcmp(a, "--idle-min") == 0)
+        cfg.idleMeanMin = std::atof(v);
+      else if (std::strcmp(a, "--reboots-per-hour") == 0)
+        cfg.rebootsPerHour = std::atof(v);
+      else if (std::strcmp(a, "--seed") == 0)
+        cfg.seed = (uint32_t)std::atol(v);
+      else
+        return false;
+      i++;
+    }
+    return cfg.courts >= 1 && cfg.courts <= 255 && cfg.hours > 0 && cfg.heartbeatMs > cfg.jitterMs;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  SimConfig cfg;
+  if (!parseArgs(argc, argv, cfg))
+  {
+    std::fprintf(stderr,
+                 "usage: simulator [--courts N] [--hours H] [--heartbeat-ms MS] [--jitter-ms MS]\n"
+                 "                 [--fault-ms MS] [--loss P] [--game-min M] [--game-sigma S]\n"
+                 "                 [--idle-min M] [--reboots-per-hour R] [--seed S] [--sweep]\n"
+                 "                 [--adaptive]\n");
+    return 2;
+  }
+
+  if (cfg.sweep)
+    runSweep(cfg);
+  else
+    printReport(cfg, runForCourtCount(cfg));
+  return 0;
+}
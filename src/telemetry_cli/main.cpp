@@ -0,0 +1,237 @@
+// Telemetry reader (native build)
+// Tails the receiver's binary telemetry stream from a serial device,
+// a capture file or stdin, and prints the court board as a table or
+// as one JSON object per frame for a dashboard to consume.
+//
+// Also the reference consumer for the acknowledged state sync
+// (state_sync.h, SYNC_ENABLED on the receiver): sync frames are
+// applied as deltas and, on a serial device, ACKed back so the
+// receiver only sends what changed.
+//
+//   pio run -e telemetry -t run -D run_args="/dev/ttyACM0"
+//   pio run -e telemetry -t run -D run_args="--json capture.bin"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "telemetry.h"
+#include "state_sync.h"
+
+namespace
+{
+  struct CliConfig
+  {
+    const char *path = nullptr;
+    bool json = false;
+    long baud = 115200;
+  };
+
+  const char *stateName(uint8_t flags)
+  {
+    if (flags & TLM_FLAG_FAULT)
+      return "fault";
+    if (flags & TLM_FLAG_IN_USE)
+      return "in_use";
+    if (flags & TLM_FLAG_AVAILABLE)
+      return "open";
+    return "idle";
+  }
+
+  unsigned long elapsedS(const TelemetryBoard &b, const TelemetryCourt &c)
+  {
+    return c.sinceMs ? (unsigned long)((b.last.boardMs - c.sinceMs) / 1000) : 0;
+  }
+
+  void printJson(const TelemetryBoard &b)
+  {
+    std::printf("{\"board_ms\":%lu,\"seq\":%u,\"type\":\"%s\",\"wait_s\":%u,\"p50_s\":%u,\"p90_s\":%u,",
+                (unsigned long)b.last.boardMs, (unsigned)b.last.seq,
+                b.last.type == TLM_SNAPSHOT ? "snapshot" : "delta",
+                (unsigned)b.last.waitS, (unsigned)b.last.p50S, (unsigned)b.last.p90S);
+    if (b.last.nextCourt)
+      std::printf("\"next\":{\"court\":%u,\"in_s\":%u},", (unsigned)b.last.nextCourt, (unsigned)b.last.nextInS);
+    else
+      std::printf("\"next\":null,");
+    std::printf("\"courts\":[");
+    bool first = true;
+    for (int id = 1; id <= b.courts; id++)
+    {
+      if (!b.known[id])
+        continue;
+      const TelemetryCourt &c = b.court[id];
+      std::printf("%s{\"id\":%d,\"state\":\"%s\",\"elapsed_s\":%lu,\"avg_s\":%u,\"games\":%u}",
+                  first ? "" : ",", id, stateName(c.flags), elapsedS(b, c),
+                  (unsigned)c.avgS, (unsigned)c.games);
+      first = false;
+    }
+    std::printf("]}\n");
+  }
+
+  void printCourt(const TelemetryBoard &b, const TelemetryCourt &c)
+  {
+    unsigned long e = elapsedS(b, c);
+    std::printf("%3u  %-7s %3lu:%02lu  %4um  %5u\n", (unsigned)c.courtId, stateName(c.flags),
+                e / 60, e % 60, (unsigned)((c.avgS + 30) / 60), (unsigned)c.games);
+  }
+
+  void printTable(const TelemetryBoard &b, const TelemetryFrame &f)
+  {
+    if (f.type == TLM_DELTA)
+    {
+      for (int i = 0; i < f.count; i++)
+        printCourt(b, b.court[f.courts[i].courtId]);
+      return;
+    }
+    std::printf("\n[%lus] wait %um (p50 %um, p90 %um)", (unsigned long)(f.boardMs / 1000),
+                (unsigned)((f.waitS + 30) / 60), (unsigned)((f.p50S + 30) / 60), (unsigned)((f.p90S + 30) / 60));
+    if (f.nextCourt)
+      std::printf(", court %u likely next in ~%um", (unsigned)f.nextCourt, (unsigned)((f.nextInS + 30) / 60));
+    std::printf("\n  #  state     time   avg  games\n");
+    // Paged snapshots: print the page that just arrived
+    for (int i = 0; i < f.count; i++)
+      printCourt(b, f.courts[i]);
+  }
+
+  // Sync deltas shown the same way as telemetry frames
+  TelemetryFrame syncView(const TelemetryBoard &b, const SyncFrame &f)
+  {
+    TelemetryFrame v = b.last;
+    v.type = f.baseVersion == 0 ? TLM_SNAPSHOT : TLM_DELTA;
+    v.count = f.count;
+    for (int i = 0; i < f.count; i++)
+      v.courts[i] = b.court[f.records[i].val.courtId];
+    return v;
+  }
+
+  void sendAck(int fd, const SyncAck &ack)
+  {
+    uint8_t payload[SYNC_ACK_BYTES], out[COBS_MAX_FRAME(SYNC_ACK_BYTES)];
+    size_t n = cobsFrame(payload, encodeSyncAck(ack, payload), out);
+    if (write(fd, out, n) != (ssize_t)n)
+      std::fprintf(stderr, "telemetry: ack write failed: %s\n", std::strerror(errno));
+  }
+
+  speed_t baudConstant(long baud)
+  {
+    switch (baud)
+    {
+    case 9600: return B9600;
+    case 57600: return B57600;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default: return B115200;
+    }
+  }
+
+  // Raw mode for serial devices; files and pipes are read as-is
+  void configureTty(int fd, long baud)
+  {
+    if (!isatty(fd))
+      return;
+    termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+      return;
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, baudConstant(baud));
+    cfsetospeed(&tio, baudConstant(baud));
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+
+  bool parseArgs(int argc, char **argv, CliConfig &cfg)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      const char *a = argv[i];
+      if (std::strcmp(a, "--json") == 0)
+        cfg.json = true;
+      else if (std::strcmp(a, "--baud") == 0 && i + 1 < argc)
+        cfg.baud = std::atol(argv[++i]);
+      else if (a[0] == '-' && a[1] != '\0')
+        return false;
+      else
+        cfg.path = a;
+    }
+    return cfg.path != nullptr;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  CliConfig cfg;
+  if (!parseArgs(argc, argv, cfg))
+  {
+    std::fprintf(stderr, "usage: telemetry [--json] [--baud N] <serial device | capture file | ->\n");
+    return 2;
+  }
+
+  bool isStdin = std::strcmp(cfg.path, "-") == 0;
+  int fd = isStdin ? STDIN_FILENO : open(cfg.path, O_RDWR | O_NOCTTY);
+  if (fd < 0 && !isStdin)
+    fd = open(cfg.path, O_RDONLY | O_NOCTTY);
+  if (fd < 0)
+  {
+    std::fprintf(stderr, "telemetry: %s: %s\n", cfg.path, std::strerror(errno));
+    return 1;
+  }
+  configureTty(fd, cfg.baud);
+  bool canAck = !isStdin && isatty(fd); // captures are replayed without ACKs
+
+  static TelemetryBoard board;
+  static SyncConsumer sync;
+  static TelemetryFrame frame;
+  static SyncFrame delta;
+  CobsReader<SYNC_MAX_PAYLOAD> reader;
+  uint32_t frames = 0, noise = 0;
+  const uint8_t *payload;
+  size_t len;
+  uint8_t buf[512];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0 || (n < 0 && errno == EINTR))
+  {
+    for (ssize_t i = 0; i < n; i++)
+    {
+      if (!reader.feed(buf[i], payload, len))
+        continue;
+      const TelemetryBoard *shown;
+      if (len > 0 && decodeTelemetryPayload(payload, len, frame))
+      {
+        board.apply(frame);
+        shown = &board;
+      }
+      else if (len > 0 && decodeSyncPayload(payload, len, delta))
+      {
+        SyncAck ack = sync.apply(delta);
+        if (canAck)
+          sendAck(fd, ack);
+        frame = syncView(sync.board, delta);
+        shown = &sync.board;
+      }
+      else
+      {
+        noise++; // text log lines, corruption
+        continue;
+      }
+      frames++;
+      if (cfg.json)
+        printJson(*shown);
+      else
+        printTable(*shown, frame);
+    }
+    std::fflush(stdout);
+  }
+
+  std::fprintf(stderr, "telemetry: %lu frames, %lu noise chunks, %lu sequence gaps\n",
+               (unsigned long)frames, (unsigned long)noise, (unsigned long)board.seqGaps);
+  if (sync.stats.frames > 0)
+    std::fprintf(stderr, "telemetry: sync version %lu, %lu stale, %lu gaps, %lu resyncs\n",
+                 (unsigned long)sync.version(), (unsigned long)sync.stats.stale,
+                 (unsigned long)sync.stats.gaps, (unsigned long)sync.stats.resyncs);
+  return 0;
+}
@@ -1,19 +1,58 @@
 // Pickleball Court Button - Transmitter
 // ESP32-C3 DevKitM-01 + arcade button + LED
 // Toggles court occupied/available state on button press.
-// Persists state in NVS across reboots.
-// When available: stays awake, pulses LED, polls button.
+// Keeps state in RTC memory across deep sleep and commits it to NVS
+// lazily, off the press-to-send path.
+// When available: LED pulses from the LEDC fade engine while the CPU
+//                 light-sleeps; wakes for fade reversals, heartbeats
+//                 and the button.
 // When occupied:  LED solid at 100%, deep sleeps with heartbeat + GPIO wakeup.
+// Heartbeats back off from 15 s to 2 min while the link is healthy.
+// Presses the receiver has not ACKed are journaled in RTC memory and
+// resent with backoff, dated from the press.
 
 #include <esp_now.h>
 #include <esp_sleep.h>
+#include <esp_wifi.h>
+#include <driver/gpio.h>
+#include <driver/ledc.h>
 #include <WiFi.h>
 #include <Preferences.h>
+#include <sys/time.h>
 #include "config.h"
+#include "power_budget.h"
+#include "heartbeat_policy.h"
+#include "tx_journal.h"
+#include "tx_state.h"
+#include "tx_channel.h"
+
+#define LED_MODE LEDC_LOW_SPEED_MODE
+#define LED_CHANNEL LEDC_CHANNEL_0
 
 volatile bool sendDone = false;
 volatile bool sendOk = false;
 Preferences prefs;
+RTC_DATA_ATTR uint16_t txSeq = 0; // survives deep sleep; restarts on power-on
+
+// Fast-wake radio cache: the channel the receiver last ACKed on,
+// reused on every wake until sends there keep failing
+RTC_DATA_ATTR TxChannel radioChannel = {0, 0, 0, 0};
+RTC_DATA_ATTR uint16_t lastAwakeMs = 0; // previous heartbeat's wake-to-sleep time, 0 = none
+RTC_DATA_ATTR HeartbeatPolicy heartbeat;
+RTC_DATA_ATTR TxJournal journal; // unACKed transitions; reset on power-on
+RTC_NOINIT_ATTR RetainedCourtState retained; // court state; CRC-checked, kept across soft resets
+
+// Press-to-send latency: from the wake that saw the press to the
+// first esp_now_send() carrying it; reported until ACKed
+RTC_DATA_ATTR uint32_t pressAtMs = 0;
+RTC_DATA_ATTR bool pressUnsent = false;
+RTC_DATA_ATTR uint16_t lastPressMs = 0; // 0 = nothing to report
+
+// Power accounting across deep sleep cycles
+RTC_DATA_ATTR PowerBudget power;
+RTC_DATA_ATTR bool powerValid = false;
+RTC_DATA_ATTR uint32_t deepSleepStartMs = 0;
+RTC_DATA_ATTR uint16_t occupiedWakes = 0;
 
 void onSent(const uint8_t *mac, esp_now_send_status_t status)
 {
@@ -22,9 +61,51 @@ void onSent(const uint8_t *mac, esp_now_send_status_t status)
   sendDone = true;
 }
 
+// Milliseconds since power-on from the RTC-backed system clock.
+// Unlike millis() it keeps counting through light and deep sleep.
+uint32_t rtcMillis()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (uint32_t)(tv.tv_sec * 1000UL + tv.tv_usec / 1000);
+}
+
+// LEDC timer on the RC_FAST clock so the fade engine keeps running
+// while the CPU is in light sleep.
+void initLED()
+{
+  ledc_timer_config_t timer = {};
+  timer.speed_mode = LED_MODE;
+  timer.duty_resolution = LEDC_TIMER_8_BIT;
+  timer.timer_num = LEDC_TIMER_0;
+  timer.freq_hz = LED_PWM_HZ;
+  timer.clk_cfg = LEDC_USE_RTC8M_CLK;
+  ledc_timer_config(&timer);
+
+  ledc_channel_config_t channel = {};
+  channel.gpio_num = LED_PIN;
+  channel.speed_mode = LED_MODE;
+  channel.channel = LED_CHANNEL;
+  channel.intr_type = LEDC_INTR_DISABLE;
+  channel.timer_sel = LEDC_TIMER_0;
+  channel.duty = 0;
+  channel.hpoint = 0;
+  ledc_channel_config(&channel);
+
+  ledc_fade_func_install(0);
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RTC8M, ESP_PD_OPTION_ON);
+}
+
+// Safe to call while a hardware fade is running; it takes over the channel
 void setLED(uint8_t brightness)
 {
-  ledcWrite(0, brightness);
+  ledc_set_duty_and_update(LED_MODE, LED_CHANNEL, brightness, 0);
+}
+
+// Start a hardware fade to `target` over `ms`; returns immediately
+void fadeLED(uint8_t target, uint32_t ms)
+{
+  ledc_set_fade_time_and_start(LED_MODE, LED_CHANNEL, target, ms, LEDC_FADE_NO_WAIT);
 }
 
 void ledError()
@@ -38,10 +119,63 @@ void ledError()
   }
 }
 
-bool initEspNow()
+void logPower(PowerMode mode)
+{
+#if POWER_LOG
+  const char *name = (mode == PWR_MODE_AVAILABLE) ? "available" : "occupied";
+  Serial.printf("[POWER] %s: avg %.2f mA over %lus (active %lums, radio %lums, light %lums, deep %lums)\n",
+                name, averageCurrentMa(power, mode),
+                (unsigned long)(modeTotalMs(power, mode) / 1000),
+                (unsigned long)power.ms[mode][PWR_ACTIVE],
+                (unsigned long)power.ms[mode][PWR_RADIO],
+                (unsigned long)power.ms[mode][PWR_LIGHT_SLEEP],
+                (unsigned long)power.ms[mode][PWR_DEEP_SLEEP]);
+#else
+  (void)mode;
+#endif
+}
+
+// Channel to park the radio on: the cached one, else the configured one
+uint8_t homeChannel()
+{
+  return radioChannel.channel ? radioChannel.channel : channelProbe(0, ESPNOW_CHANNEL);
+}
+
+// Full bring-up through the Arduino WiFi layer (netif, event loop,
+// NVS-backed config). Only needed once per power-on.
+bool startWifiFull()
 {
   WiFi.mode(WIFI_STA);
   WiFi.disconnect();
+  return esp_wifi_set_channel(homeChannel(), WIFI_SECOND_CHAN_NONE) == ESP_OK;
+}
+
+// Minimal bring-up for deep-sleep wakes: just the WiFi driver in STA
+// mode with RAM-only config, which is all ESP-NOW needs
+bool startWifiFast()
+{
+  wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+  if (esp_wifi_init(&cfg) != ESP_OK)
+    return false;
+  esp_wifi_set_storage(WIFI_STORAGE_RAM);
+  esp_wifi_set_mode(WIFI_MODE_STA);
+  if (esp_wifi_start() != ESP_OK)
+    return false;
+  return esp_wifi_set_channel(homeChannel(), WIFI_SECOND_CHAN_NONE) == ESP_OK;
+}
+
+// Restart the radio after esp_wifi_stop(); the driver forgets the
+// channel across a stop, so pin it again
+void resumeRadio()
+{
+  esp_wifi_start();
+  esp_wifi_set_channel(homeChannel(), WIFI_SECOND_CHAN_NONE);
+}
+
+bool initEspNow(bool fromDeepSleep)
+{
+  if (!(fromDeepSleep ? startWifiFast() : startWifiFull()))
+    return false;
 
   if (esp_now_init() != ESP_OK)
     return false;
@@ -50,113 +184,361 @@ bool initEspNow()
 
   esp_now_peer_info_t peer = {};
   memcpy(peer.peer_addr, RECEIVER_MAC, 6);
-  peer.channel = 0;
+  peer.channel = 0; // whatever channel the radio is on, so probing can move it
+  peer.ifidx = WIFI_IF_STA;
   peer.encrypt = false;
   esp_now_add_peer(&peer);
   return true;
 }
 
-bool sendState(bool occupied)
+// Seconds since power-on. System time is kept by the RTC across deep
+// sleep, unlike millis(), so the receiver can spot real reboots.
+uint32_t uptimeSeconds()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (uint32_t)tv.tv_sec;
+}
+
+uint8_t batteryPercent()
 {
-  CourtPacket pkt;
-  pkt.courtId = COURT_ID;
-  pkt.occupied = occupied ? 1 : 0;
+#ifdef BATTERY_ADC_PIN
+  // LiPo through a 1:2 divider: 3.3 V = empty, 4.2 V = full
+  uint32_t mv = analogReadMilliVolts(BATTERY_ADC_PIN) * 2;
+  if (mv <= 3300)
+    return 0;
+  if (mv >= 4200)
+    return 100;
+  return (uint8_t)((mv - 3300) * 100 / 900);
+#else
+  return PACKET_BATTERY_UNKNOWN;
+#endif
+}
+
+// One frame: the journaled backlog if there is one, else just the
+// current state. Returns whether the receiver ACKed it.
+bool transmitOnce(bool occupied)
+{
+  // Resends of an unchanged backlog reuse its seq, so a copy whose ACK
+  // was lost is dropped by the receiver as a duplicate
+  bool backlog = journalPending(journal);
+  if (backlog && journal.seq == 0)
+    journal.seq = ++txSeq;
+
+  CourtFrame frame;
+  initCourtFrame(frame, COURT_ID, backlog ? journal.seq : ++txSeq);
+  frame.uptimeS = uptimeSeconds();
+  frame.batteryPct = batteryPercent();
+  if (backlog)
+    journalFill(journal, frame, COURT_ID, rtcMillis());
+  else
+    addCourtRecord(frame, COURT_ID, occupied);
+  if (lastAwakeMs > 0)
+    setFrameExt(frame, PACKET_EXT_AWAKE_MS, lastAwakeMs);
+  setFrameExt(frame, PACKET_EXT_INTERVAL_S, heartbeatNextIfAcked(heartbeat));
+  if (pressUnsent)
+  {
+    uint32_t ms = rtcMillis() - pressAtMs;
+    lastPressMs = ms > 0xFFFF ? 0xFFFF : (ms == 0 ? 1 : (uint16_t)ms);
+    pressUnsent = false;
+#if POWER_LOG
+    Serial.printf("[WAKE] press to send %ums\n", (unsigned)lastPressMs);
+#endif
+  }
+  if (lastPressMs > 0)
+    setFrameExt(frame, PACKET_EXT_PRESS_MS, lastPressMs);
+
+  uint8_t buf[PACKET_MAX_BYTES];
+  size_t len = encodeCourtFrame(frame, buf, sizeof(buf));
 
   sendDone = false;
   sendOk = false;
-  esp_now_send(RECEIVER_MAC, (uint8_t *)&pkt, sizeof(pkt));
+  esp_now_send(RECEIVER_MAC, buf, len);
 
+  // Poll tightly: the ACK usually lands within a few ms and the
+  // caller goes straight back to sleep once it does
   unsigned long start = millis();
   while (!sendDone && (millis() - start < SEND_TIMEOUT_MS))
-    delay(10);
-
+    delay(1);
   return sendOk;
 }
 
-// Stay awake, pulse LED, poll button. Returns when button pressed.
-void availableLoop()
+// No channel cached and a probe due (channelProbeDue()): send the
+// frame on each channel in turn, the configured one first, until the
+// receiver ACKs, and cache that one. Failed probes reuse the seq, so
+// the receiver sees resends, not loss.
+bool probeChannels(bool occupied)
+{
+  for (uint8_t n = 0; n < WIFI_CHANNEL_COUNT; n++)
+  {
+    uint8_t ch = channelProbe(n, ESPNOW_CHANNEL);
+    if (esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE) != ESP_OK)
+      continue;
+    uint16_t seq = txSeq;
+    if (transmitOnce(occupied))
+    {
+      channelSent(radioChannel, ch, true);
+#if POWER_LOG
+      Serial.printf("[RADIO] receiver on channel %u\n", (unsigned)ch);
+#endif
+      return true;
+    }
+    txSeq = seq;
+  }
+  esp_wifi_set_channel(homeChannel(), WIFI_SECOND_CHAN_NONE);
+  return false;
+}
+
+// Send the state (and any backlog). A failed backlog is retried with
+// jittered backoff while the waits are short; after that it stays in
+// the journal for the next wake (see journalRetryInMs()).
+bool sendState(bool occupied)
+{
+  bool probed = channelProbeDue(radioChannel);
+  bool ok = probed ? probeChannels(occupied) : transmitOnce(occupied);
+  while (!ok && journalPending(journal))
+  {
+    uint32_t now = rtcMillis();
+    journalSent(journal, false, now, esp_random());
+    uint32_t wait = journalRetryInMs(journal, now);
+    if (wait > TX_RETRY_INLINE_MS)
+      break;
+    delay(wait);
+    ok = transmitOnce(occupied);
+  }
+
+  if (ok)
+  {
+    journalSent(journal, true, rtcMillis(), 0);
+    lastAwakeMs = 0; // reported
+    lastPressMs = 0;
+  }
+  // A run of failed sends may mean the receiver moved: probe again then
+  channelSent(radioChannel, homeChannel(), ok, probed);
+  heartbeatAfterSend(heartbeat, ok);
+  return ok;
+}
+
+// Deep/light sleep length: the next heartbeat, or sooner when a
+// journaled press is waiting for its retry
+uint32_t nextSendInMs(uint32_t heartbeatInMs, uint32_t now)
+{
+  if (!journalPending(journal))
+    return heartbeatInMs;
+  uint32_t retry = journalRetryInMs(journal, now);
+  return retry < heartbeatInMs ? retry : heartbeatInMs;
+}
+
+// Write the retained state to NVS (the slow part: flash erase/program)
+void commitState()
+{
+  unsigned long t0 = micros();
+  prefs.begin("court", false);
+  prefs.putBool("occupied", retained.occupied);
+  prefs.end();
+  retainedCommitted(retained);
+#if POWER_LOG
+  Serial.printf("[NVS] committed %s in %luus\n", retained.occupied ? "occupied" : "available", micros() - t0);
+#else
+  (void)t0;
+#endif
+}
+
+// Called after the radio work of each wake: commit a change that has
+// stood long enough, or any change once the battery is nearly flat
+void serviceCommit()
+{
+  uint8_t batt = batteryPercent();
+  bool lowBattery = batt != PACKET_BATTERY_UNKNOWN && batt <= TX_NVS_LOW_BATT_PCT;
+  if (retainedCommitDue(retained, rtcMillis(), lowBattery))
+    commitState();
+}
+
+// A button press changed the court to `occupied` at `atMs`
+void setState(bool occupied, uint32_t atMs)
+{
+  retainedSet(retained, occupied, atMs);
+#if !TX_NVS_LAZY
+  commitState(); // before the send, as the firmware used to
+#endif
+  heartbeatStateChanged(heartbeat);
+  journalRecord(journal, occupied, atMs);
+  pressAtMs = atMs;
+  pressUnsent = true;
+}
+
+// Available mode. The LED pulse is a pair of hardware fades (up, down)
+// and the radio is stopped between heartbeats, so the CPU spends almost
+// all of its time in light sleep. Wakes on: fade reversal, heartbeat
+// or journal retry due, or button (GPIO low). Returns the time of the
+// button press.
+uint32_t availableLoop()
 {
   pinMode(BUTTON_PIN, INPUT_PULLUP);
-  unsigned long lastHeartbeat = millis();
-  unsigned long lastPress = 0;
+  gpio_wakeup_enable(BUTTON_PIN, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  esp_wifi_stop();
+
+  uint32_t lastHeartbeat = rtcMillis();
+  uint32_t lastLog = lastHeartbeat;
+  bool fadingUp = true;
+  uint32_t fadeEndMs = lastHeartbeat + LED_PULSE_HALF_MS;
+  fadeLED(255, LED_PULSE_HALF_MS);
+  uint32_t pressMs = 0;
 
   while (true)
   {
-    // Triangle wave pulse: 0→255→0 over ~2 seconds
-    uint16_t phase = (millis() / 4) % 510;
-    uint8_t brightness = (phase > 255) ? (510 - phase) : phase;
-    setLED(brightness);
+    uint32_t awakeStart = rtcMillis();
+    uint32_t heartbeatMs = (uint32_t)heartbeat.intervalS * 1000;
 
-    // Heartbeat re-broadcast while waiting
-    if (millis() - lastHeartbeat >= (uint32_t)HEARTBEAT_SEC * 1000)
+    if (digitalRead(BUTTON_PIN) == LOW)
     {
+      setLED(255); // instant feedback
+      pressMs = awakeStart;
+      break; // caller will handle toggle + send
+    }
+
+    bool retryDue = journalPending(journal) && journalRetryInMs(journal, awakeStart) == 0;
+    if (awakeStart - lastHeartbeat >= heartbeatMs || retryDue)
+    {
+      uint32_t radioStart = rtcMillis();
+      resumeRadio();
       sendState(false);
-      lastHeartbeat = millis();
+      esp_wifi_stop();
+      serviceCommit();
+      lastHeartbeat = rtcMillis();
+      addPowerTime(power, PWR_MODE_AVAILABLE, PWR_RADIO, lastHeartbeat - radioStart);
     }
 
-    // Poll button with debounce
-    if (digitalRead(BUTTON_PIN) == LOW && millis() - lastPress > DEBOUNCE_MS)
+    uint32_t now = rtcMillis();
+    if ((int32_t)(now - fadeEndMs) >= 0)
     {
-      lastPress = millis();
-      setLED(255); // instant feedback
-      return;      // caller will handle toggle + send
+      fadingUp = !fadingUp;
+      fadeLED(fadingUp ? 255 : 0, LED_PULSE_HALF_MS);
+      fadeEndMs = now + LED_PULSE_HALF_MS;
     }
 
-    delay(10);
+#if POWER_LOG
+    if (now - lastLog >= POWER_LOG_MS)
+    {
+      logPower(PWR_MODE_AVAILABLE);
+      lastLog = now;
+    }
+#endif
+
+    // Sleep until the next fade reversal, heartbeat or retry, whichever is first
+    heartbeatMs = (uint32_t)heartbeat.intervalS * 1000; // may have changed above
+    uint32_t sinceHeartbeat = now - lastHeartbeat;
+    uint32_t untilHeartbeat = nextSendInMs(sinceHeartbeat < heartbeatMs ? heartbeatMs - sinceHeartbeat : 0, now);
+    uint32_t untilFade = fadeEndMs - now;
+    uint32_t sleepMs = untilHeartbeat < untilFade ? untilHeartbeat : untilFade;
+    addPowerTime(power, PWR_MODE_AVAILABLE, PWR_ACTIVE, now - awakeStart);
+
+    if (sleepMs > 0)
+    {
+      esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+      uint32_t sleepStart = rtcMillis();
+      esp_light_sleep_start();
+      uint32_t slept = rtcMillis() - sleepStart;
+      addPowerTime(power, PWR_MODE_AVAILABLE, PWR_LIGHT_SLEEP, slept);
+      addLedTime(power, PWR_MODE_AVAILABLE, slept, 50); // triangle wave averages 50%
+    }
   }
+
+  gpio_wakeup_disable(BUTTON_PIN);
+  resumeRadio(); // caller sends the occupied state next
+  logPower(PWR_MODE_AVAILABLE);
+  return pressMs;
 }
 
 void setup()
 {
-  ledcSetup(0, 5000, 8);
-  ledcAttachPin(LED_PIN, 0);
-  setLED(0);
+  uint32_t bootRtcMs = rtcMillis();
+  bool heartbeatWake = false;
+  uint32_t bootMillis = millis(); // time already spent starting up
+#if POWER_LOG
+  Serial.begin(115200);
+#endif
 
-  // Load persisted state
-  prefs.begin("court", false);
-  bool occupied = prefs.getBool("occupied", false); // default: available
+  initLED();
+  setLED(0);
 
   // Check what woke us up
   esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
   bool isButtonPress = (cause == ESP_SLEEP_WAKEUP_GPIO);
+  bool fromDeepSleep = (cause == ESP_SLEEP_WAKEUP_TIMER || isButtonPress);
+
+  if (!powerValid || !fromDeepSleep)
+  {
+    initPowerBudget(power);
+    powerValid = true;
+    initHeartbeat(heartbeat);
+    journalInit(journal);
+  }
+  else
+  {
+    // Deep sleep is only ever entered from the occupied state
+    uint32_t sleptMs = bootRtcMs - deepSleepStartMs;
+    addPowerTime(power, PWR_MODE_OCCUPIED, PWR_DEEP_SLEEP, sleptMs > bootMillis ? sleptMs - bootMillis : 0);
+    addPowerTime(power, PWR_MODE_OCCUPIED, PWR_ACTIVE, bootMillis);
+  }
+
+  // Court state: the RTC copy when it survived, else NVS (power loss)
+  if (!retainedValid(retained))
+  {
+    prefs.begin("court", true);
+    retainedInit(retained, prefs.getBool("occupied", false)); // default: available
+    prefs.end();
+  }
+  bool occupied = retained.occupied;
 
   if (isButtonPress)
   {
     // Woke from sleep via button — only happens when occupied, so toggle to available
     occupied = false;
-    prefs.putBool("occupied", occupied);
+    setState(false, bootRtcMs - bootMillis); // pressed as the chip woke
   }
 
-  prefs.end();
-
-  if (!initEspNow())
+  uint32_t radioStart = rtcMillis();
+  if (!initEspNow(fromDeepSleep))
   {
     ledError();
+    heartbeatAfterSend(heartbeat, false);
+    if (journalPending(journal))
+      journalSent(journal, false, rtcMillis(), esp_random());
     goto sleep;
   }
 
   if (occupied)
   {
-    // Court in use: LED solid, broadcast, sleep
+    // Court in use: LED on while transmitting, broadcast, sleep
     setLED(255);
     sendState(true);
-    // Stay lit briefly so user sees confirmation, then sleep
-    delay(500);
+    addPowerTime(power, PWR_MODE_OCCUPIED, PWR_RADIO, rtcMillis() - radioStart);
+    if (!fromDeepSleep)
+    {
+      // Power-on: stay lit briefly so user sees confirmation. Heartbeat
+      // wakes go straight back to sleep once the ACK is in.
+      delay(500);
+      addPowerTime(power, PWR_MODE_OCCUPIED, PWR_ACTIVE, 500);
+      addLedTime(power, PWR_MODE_OCCUPIED, 500, 100);
+    }
+    if (++occupiedWakes % POWER_LOG_EVERY_WAKES == 0)
+      logPower(PWR_MODE_OCCUPIED);
+    heartbeatWake = (cause == ESP_SLEEP_WAKEUP_TIMER);
     goto sleep;
   }
   else
   {
     // Court available: broadcast initial state, then enter pulse loop
     sendState(false);
+    addPowerTime(power, PWR_MODE_AVAILABLE, PWR_RADIO, rtcMillis() - radioStart);
 
     // Pulse loop blocks until button pressed
-    availableLoop();
+    uint32_t pressMs = availableLoop();
 
     // Button was pressed — toggle to occupied
-    prefs.begin("court", false);
-    prefs.putBool("occupied", true);
-    prefs.end();
-
+    setState(true, pressMs);
     sendState(true);
     // LED already at 255 from availableLoop, hold briefly
     delay(500);
@@ -165,10 +547,18 @@ void setup()
 
 sleep:
   setLED(0);
+  serviceCommit();
   // When occupied: wake on heartbeat timer OR button press (to toggle back to available)
   // When available: we never reach sleep — we're in the pulse loop
-  esp_sleep_enable_timer_wakeup((uint64_t)HEARTBEAT_SEC * 1000000ULL);
+  esp_sleep_enable_timer_wakeup((uint64_t)nextSendInMs((uint32_t)heartbeat.intervalS * 1000, rtcMillis()) * 1000ULL);
   esp_deep_sleep_enable_gpio_wakeup(1ULL << BUTTON_PIN, ESP_GPIO_WAKEUP_GPIO_LOW);
+  if (heartbeatWake)
+  {
+    // Wake-to-sleep time of this heartbeat, sent with the next frame
+    unsigned long awake = millis();
+    lastAwakeMs = awake > 0xFFFF ? 0xFFFF : (awake == 0 ? 1 : (uint16_t)awake);
+  }
+  deepSleepStartMs = rtcMillis();
   esp_deep_sleep_start();
 }
 
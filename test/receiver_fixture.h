@@ -3,6 +3,10 @@
 #pragma once
 
 #include "receiver_logic.h"
+#include "court_prediction.h"
+#include "framebuffer.h"
+#include "oled_render.h"
+#include "oled_screens.h"
 
 constexpr unsigned long kPreviewNowMs = 1000000UL;
 
@@ -53,4 +57,87 @@ inline void seedPreviewState(SystemState &state)
   // Court 8: idle, avg 3 min
   state.courts[7].avgWaitMs = 3UL * 60UL * 1000UL;
   state.courts[7].waitSamples = 1;
-}
\ No newline at end of file
+}
+
+// Deterministic probe histograms for the stats page: a spread of
+// samples per probe, scaled so each lands in a different unit
+inline void seedPreviewProbes(Instruments &ins)
+{
+  static const uint32_t kBaseUs[(size_t)Probe::Count] = {40, 180000, 300, 9000, 12000, 700};
+  ins.reset();
+  for (size_t p = 0; p < (size_t)Probe::Count; p++)
+    for (uint32_t i = 1; i <= 100; i++)
+      ins[(Probe)p].record(kBaseUs[p] * (50 + i) / 100 + (i == 100 ? kBaseUs[p] * 2 : 0));
+}
+
+// ============================================
+// GOLDEN SCREENS
+// ============================================
+// Frames the receiver draws, rendered from the fixture state. The
+// tests compare them with test/golden/<name>.pbm; regenerate those
+// with `oled_preview --golden test/golden` after an intended change.
+
+constexpr const char *kGoldenScenes[] = {
+    "table_page1",    // courts 1-4
+    "table_page2",    // courts 5-8
+    "table_all_busy", // every court in use: Next: title
+    "alert_court3",   // "Court 3 open!"
+    "anim_phase1",    // ball mid-bounce, text sliding in
+    "anim_phase2",    // bordered, inverted flash
+    "stats_page",     // hidden latency page, fixed samples
+};
+constexpr int kGoldenSceneCount = sizeof(kGoldenScenes) / sizeof(kGoldenScenes[0]);
+
+inline void renderGoldenScene(int scene, MemoryTarget &t)
+{
+  static OledRenderCache cache;
+  SystemState state;
+  seedPreviewState(state);
+  uint32_t now = kPreviewNowMs;
+  t.setInverted(false);
+
+  switch (scene)
+  {
+  case 0:
+  case 1:
+    renderCourtTable(cache, t.buffer(), state, nullptr, currentWaitMs(state, now), scene * COURTS_PER_PAGE, now);
+    break;
+  case 2:
+  {
+    CourtPredictor<NUM_COURTS> predictor;
+    for (int i = 0; i < NUM_COURTS; i++)
+    {
+      CourtState &c = state.courts[i];
+      if (!c.inUse)
+      {
+        c.available = false;
+        c.inUse = true;
+        c.inUseSinceMs = now - (uint32_t)(i + 1) * 90000UL;
+        c.lastHeardMs = now - 5000;
+      }
+      predictor.update(state, i, now);
+    }
+    char title[16];
+    renderCourtTable(cache, t.buffer(), state, nextCourtTitle(title, sizeof(title), predictor, now),
+                     currentWaitMs(state, now), 0, now);
+    break;
+  }
+  case 3:
+    drawCourtOpenAlert(t, 3);
+    break;
+  case 4:
+    drawGameStartedFrame(t, 6, 7);
+    break;
+  case 5:
+    drawGameStartedFrame(t, 6, ANIM_PHASE1_FRAMES + 2);
+    break;
+  default:
+  {
+    static Instruments ins;
+    seedPreviewProbes(ins);
+    drawStatsPage(t, ins);
+    break;
+  }
+  }
+  t.present();
+}
@@ -1,6 +1,33 @@
 #include <unity.h>
+#include <thread>
 #include "receiver_logic.h"
 #include "receiver_fixture.h"
+#include "court_packet.h"
+#include "spsc_queue.h"
+#include "link_stats.h"
+#include "animation.h"
+#include "oled_flush.h"
+#include "power_budget.h"
+#include "heartbeat_policy.h"
+#include "wait_stats.h"
+#include "court_prediction.h"
+#include "event_log.h"
+#include "telemetry.h"
+#include "state_sync.h"
+#include "oled_render.h"
+#include "instrumentation.h"
+#include "wake_schedule.h"
+#include "timer_wheel.h"
+#include "tx_journal.h"
+#include "tx_state.h"
+#include "tx_channel.h"
+#include "boot_clock.h"
+#include "render_pipeline.h"
+#include <chrono>
+#include <cstdlib>
+#include <dirent.h>
+#include <unistd.h>
+#include <vector>
 
 // ============================================
 // TIME CONVERSION TESTS
@@ -92,6 +119,61 @@ void test_global_average_uniform()
   TEST_ASSERT_EQUAL_UINT32(120000, globalAverageWaitMs(state));
 }
 
+void test_overall_average_tracks_recorded_games()
+{
+  SystemState state;
+  initSystemState(state);
+  TEST_ASSERT_EQUAL_UINT32(0, overallAverageMs(state));
+
+  simulateCourtOccupied(state, 1, 1000, 0);
+  simulateCourtFreed(state, 1, 1000 + 120000);
+  simulateCourtOccupied(state, 2, 2000, 0);
+  simulateCourtFreed(state, 2, 2000 + 240000);
+  simulateCourtOccupied(state, 2, 300000, 0);
+  simulateCourtFreed(state, 2, 300000 + 180000);
+
+  // (120000 + 240000 + 180000) / 3 — same as the per-court weighted mean
+  TEST_ASSERT_EQUAL_UINT32(180000, overallAverageMs(state));
+  TEST_ASSERT_EQUAL_UINT32(globalAverageWaitMs(state), overallAverageMs(state));
+}
+
+// ============================================
+// COURT COUNT SCALING TESTS
+// ============================================
+
+void test_large_board_accepts_all_court_ids()
+{
+  static BasicSystemState<64> big;
+  initSystemState(big);
+
+  TEST_ASSERT_TRUE(applyPacket(big, {64, 1}, 1000) == PacketResult::Occupied);
+  TEST_ASSERT_TRUE(big.courts[63].inUse);
+  TEST_ASSERT_TRUE(applyPacket(big, {65, 1}, 1000) == PacketResult::Rejected);
+  TEST_ASSERT_TRUE(applyPacket(big, {64, 0}, 61000) == PacketResult::Freed);
+  TEST_ASSERT_EQUAL_UINT32(60000, overallAverageMs(big));
+}
+
+void test_storage_is_sized_by_court_count()
+{
+  TEST_ASSERT_EQUAL_UINT32(8 * sizeof(CourtState), sizeof(BasicSystemState<8>::courts));
+  TEST_ASSERT_EQUAL_UINT32(64 * sizeof(CourtState), sizeof(BasicSystemState<64>::courts));
+}
+
+void test_pager_covers_every_court()
+{
+  TEST_ASSERT_EQUAL_INT(2, courtPageCount<8>());
+  TEST_ASSERT_EQUAL_INT(6, courtPageCount<24>());
+  TEST_ASSERT_EQUAL_INT(3, courtPageCount<9>()); // partial last page
+
+  TEST_ASSERT_EQUAL_INT(0, courtPageAt<8>(0));
+  TEST_ASSERT_EQUAL_INT(0, courtPageAt<8>(OLED_PAGE_MS - 1));
+  TEST_ASSERT_EQUAL_INT(1, courtPageAt<8>(OLED_PAGE_MS));
+  TEST_ASSERT_EQUAL_INT(0, courtPageAt<8>(2 * OLED_PAGE_MS)); // wraps
+
+  TEST_ASSERT_EQUAL_INT(5, courtPageAt<24>(5 * OLED_PAGE_MS));
+  TEST_ASSERT_EQUAL_INT(0, courtPageAt<24>(6 * OLED_PAGE_MS));
+}
+
 // ============================================
 // STATE MACHINE TESTS
 // ============================================
@@ -385,6 +467,54 @@ void test_fault_clears_on_recovery()
   TEST_ASSERT_NOT_NULL(strstr(d.buffer, "Started"));
 }
 
+void test_fault_deadline_follows_advertised_interval()
+{
+  SystemState state;
+  initSystemState(state);
+  CourtFrame f;
+  initCourtFrame(f, 2, 1);
+  addCourtRecord(f, 2, true);
+  setFrameExt(f, PACKET_EXT_INTERVAL_S, 60);
+
+  noteHeartbeatInterval(state, f);
+  applyPacket(state, f.records[0], 1000);
+  const CourtState &court = state.courts[1];
+  TEST_ASSERT_FALSE(courtFaulted(court, 1000 + FAULT_TIMEOUT_MS + 1000)); // 3 × 60 s, not 45 s
+  TEST_ASSERT_TRUE(courtFaulted(court, 1000 + 60000 * FAULT_HEARTBEAT_MULT + 1));
+
+  // A sender without the field falls back to the global timeout
+  initCourtFrame(f, 2, 2);
+  addCourtRecord(f, 2, true);
+  noteHeartbeatInterval(state, f);
+  TEST_ASSERT_TRUE(courtFaulted(court, 1000 + FAULT_TIMEOUT_MS + 1));
+}
+
+void test_only_frames_from_faulted_courts_clear_a_fault()
+{
+  SystemState state;
+  initSystemState(state);
+  simulateCourtOccupied(state, 1, 1000, 0);
+  simulateCourtOccupied(state, 2, 1000, 0);
+  uint32_t t = 1000 + FAULT_TIMEOUT_MS / 2;
+  state.courts[1].lastHeardMs = t; // court 2 kept talking, court 1 went silent
+
+  CourtFrame f;
+  initCourtFrame(f, 2, 1);
+  addCourtRecord(f, 2, true);
+  TEST_ASSERT_FALSE(frameClearsFault(state, f, t + 1000)); // plain heartbeat: nothing to redraw
+
+  uint32_t late = 1000 + FAULT_TIMEOUT_MS + 1;
+  initCourtFrame(f, 1, 1);
+  addCourtRecord(f, 1, true);
+  TEST_ASSERT_TRUE(frameClearsFault(state, f, late));
+  applyPacket(state, f.records[0], late);
+  TEST_ASSERT_FALSE(frameClearsFault(state, f, late + 1000)); // cleared, back to plain heartbeats
+
+  initCourtFrame(f, 99, 1);
+  addCourtRecord(f, 99, true); // unknown court
+  TEST_ASSERT_FALSE(frameClearsFault(state, f, late));
+}
+
 // ============================================
 // BOUNDARY & EDGE CASE TESTS
 // ============================================
@@ -473,8 +603,2192 @@ void test_realistic_scenario_full_day()
   TEST_ASSERT_NOT_EQUAL(state.courts[0].avgWaitMs, state.courts[1].avgWaitMs);
 }
 
+// ============================================
+// PACKET ENGINE TESTS
+// ============================================
+
+void test_apply_packet_game_lifecycle()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 1000);
+
+  TEST_ASSERT_TRUE(applyPacket(state, {2, 1}, 5000) == PacketResult::Occupied);
+  TEST_ASSERT_TRUE(state.courts[1].inUse);
+  TEST_ASSERT_FALSE(state.courts[1].available);
+  TEST_ASSERT_EQUAL_UINT32(5000, state.courts[1].inUseSinceMs);
+
+  // Heartbeat keeps the game running but refreshes lastHeardMs
+  TEST_ASSERT_TRUE(applyPacket(state, {2, 1}, 20000) == PacketResult::Heartbeat);
+  TEST_ASSERT_EQUAL_UINT32(5000, state.courts[1].inUseSinceMs);
+  TEST_ASSERT_EQUAL_UINT32(20000, state.courts[1].lastHeardMs);
+
+  TEST_ASSERT_TRUE(applyPacket(state, {2, 0}, 5000 + 600000) == PacketResult::Freed);
+  TEST_ASSERT_TRUE(state.courts[1].available);
+  TEST_ASSERT_EQUAL_UINT32(1, state.courts[1].waitSamples);
+  TEST_ASSERT_EQUAL_FLOAT(600000.0f, state.courts[1].avgWaitMs);
+
+  TEST_ASSERT_TRUE(applyPacket(state, {2, 0}, 700000) == PacketResult::Heartbeat);
+  TEST_ASSERT_EQUAL_UINT32(1, state.courts[1].waitSamples);
+}
+
+void test_apply_packet_rejects_unknown_court()
+{
+  SystemState state;
+  initSystemState(state);
+
+  TEST_ASSERT_TRUE(applyPacket(state, {0, 1}, 1000) == PacketResult::Rejected);
+  TEST_ASSERT_TRUE(applyPacket(state, {NUM_COURTS + 1, 1}, 1000) == PacketResult::Rejected);
+  for (int i = 0; i < NUM_COURTS; i++)
+    TEST_ASSERT_EQUAL_UINT32(0, state.courts[i].lastHeardMs);
+}
+
+void test_apply_packet_idle_court_freed_without_sample()
+{
+  SystemState state;
+  initSystemState(state);
+
+  // Court never seen: an "available" packet opens it but records no game
+  TEST_ASSERT_TRUE(applyPacket(state, {4, 0}, 1000) == PacketResult::Freed);
+  TEST_ASSERT_TRUE(state.courts[3].available);
+  TEST_ASSERT_EQUAL_UINT32(0, state.courts[3].waitSamples);
+}
+
+void test_court_row_fields_are_column_padded()
+{
+  SystemState state;
+  seedPreviewState(state);
+  CourtRowFields row;
+
+  formatCourtRow(state.courts[0], 1, kPreviewNowMs, row);
+  TEST_ASSERT_EQUAL_STRING("1", row.num);
+  TEST_ASSERT_EQUAL_STRING("Started", row.status);
+  TEST_ASSERT_EQUAL_STRING("04:00", row.now);
+  TEST_ASSERT_EQUAL_STRING(" 2m", row.avg);
+
+  formatCourtRow(state.courts[1], 2, kPreviewNowMs, row);
+  TEST_ASSERT_EQUAL_STRING("Open", row.status);
+  TEST_ASSERT_EQUAL_STRING("  --", row.now);
+
+  formatCourtRow(state.courts[2], 3, kPreviewNowMs, row);
+  TEST_ASSERT_EQUAL_STRING("---", row.status);
+  TEST_ASSERT_EQUAL_STRING(" --", row.now);
+}
+
+// ============================================
+// PACKET FORMAT TESTS
+// ============================================
+
+void test_frame_decodes_legacy_two_byte_packet()
+{
+  const uint8_t legacy[] = {5, 1};
+  CourtFrame f;
+  TEST_ASSERT_TRUE(decodeCourtFrame(legacy, sizeof(legacy), f));
+  TEST_ASSERT_EQUAL_UINT8(1, f.version);
+  TEST_ASSERT_EQUAL_UINT8(1, f.count);
+  TEST_ASSERT_EQUAL_UINT8(5, f.records[0].courtId);
+  TEST_ASSERT_EQUAL_UINT8(1, f.records[0].occupied);
+}
+
+void test_frame_round_trips_batched_records()
+{
+  CourtFrame out;
+  initCourtFrame(out, 42, 0xBEEF);
+  out.uptimeS = 123456;
+  out.batteryPct = 87;
+  setFrameExt(out, 0, 0x1234);
+  setFrameExt(out, 3, 0x00AB);
+  for (uint8_t c = 1; c <= 5; c++)
+    TEST_ASSERT_TRUE(addCourtRecord(out, c, c % 2));
+
+  uint8_t buf[PACKET_MAX_BYTES];
+  size_t len = encodeCourtFrame(out, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT32(PACKET_HEADER_BYTES + 2 * 2 + 5 * 2, len);
+
+  CourtFrame in;
+  TEST_ASSERT_TRUE(decodeCourtFrame(buf, len, in));
+  TEST_ASSERT_EQUAL_UINT8(PACKET_VERSION, in.version);
+  TEST_ASSERT_EQUAL_UINT8(42, in.srcId);
+  TEST_ASSERT_EQUAL_UINT16(0xBEEF, in.seq);
+  TEST_ASSERT_EQUAL_UINT32(123456, in.uptimeS);
+  TEST_ASSERT_EQUAL_UINT8(87, in.batteryPct);
+  TEST_ASSERT_TRUE(hasFrameExt(in, 0));
+  TEST_ASSERT_FALSE(hasFrameExt(in, 1));
+  TEST_ASSERT_EQUAL_UINT16(0x1234, in.ext[0]);
+  TEST_ASSERT_EQUAL_UINT16(0x00AB, in.ext[3]);
+  TEST_ASSERT_EQUAL_UINT8(5, in.count);
+  for (uint8_t c = 1; c <= 5; c++)
+  {
+    TEST_ASSERT_EQUAL_UINT8(c, in.records[c - 1].courtId);
+    TEST_ASSERT_EQUAL_UINT8(c % 2, in.records[c - 1].occupied);
+  }
+}
+
+void test_frame_rejects_malformed_input()
+{
+  CourtFrame f;
+  initCourtFrame(f, 1, 1);
+  addCourtRecord(f, 1, true);
+  addCourtRecord(f, 2, false);
+  uint8_t buf[PACKET_MAX_BYTES];
+  size_t len = encodeCourtFrame(f, buf, sizeof(buf));
+
+  CourtFrame in;
+  TEST_ASSERT_FALSE(decodeCourtFrame(buf, len - 1, in)); // truncated record
+  TEST_ASSERT_FALSE(decodeCourtFrame(buf, 1, in));       // runt
+
+  uint8_t bad[PACKET_MAX_BYTES];
+  memcpy(bad, buf, len);
+  bad[0] = 0x00; // wrong magic
+  TEST_ASSERT_FALSE(decodeCourtFrame(bad, len, in));
+
+  memcpy(bad, buf, len);
+  bad[11] = PACKET_MAX_RECORDS + 1; // impossible record count
+  TEST_ASSERT_FALSE(decodeCourtFrame(bad, len, in));
+
+  memcpy(bad, buf, len);
+  bad[3] = 0x80; // unknown record-layout flag
+  TEST_ASSERT_FALSE(decodeCourtFrame(bad, len, in));
+
+  TEST_ASSERT_EQUAL_UINT32(0, encodeCourtFrame(f, buf, PACKET_HEADER_BYTES)); // no room
+}
+
+void test_link_tracker_suppresses_duplicates_and_counts_loss()
+{
+  LinkTracker<8> links;
+  CourtFrame f;
+  initCourtFrame(f, 3, 10);
+  f.uptimeS = 100;
+  addCourtRecord(f, 3, true);
+
+  TEST_ASSERT_TRUE(links.observe(f, 1000) == SeqResult::Fresh);
+  TEST_ASSERT_TRUE(links.observe(f, 1001) == SeqResult::Duplicate);
+
+  f.seq = 14; // 11, 12, 13 never arrived
+  f.uptimeS = 160;
+  TEST_ASSERT_TRUE(links.observe(f, 61000) == SeqResult::Fresh);
+
+  f.seq = 12; // late arrival after a newer frame
+  TEST_ASSERT_TRUE(links.observe(f, 61010) == SeqResult::Stale);
+
+  const LinkState &l = links.link(3);
+  TEST_ASSERT_EQUAL_UINT32(2, l.received);
+  TEST_ASSERT_EQUAL_UINT32(1, l.duplicates);
+  TEST_ASSERT_EQUAL_UINT32(1, l.stale);
+  TEST_ASSERT_EQUAL_UINT32(3, l.lost);
+}
+
+void test_link_tracker_handles_wrap_and_reboot()
+{
+  LinkTracker<8> links;
+  CourtFrame f;
+  initCourtFrame(f, 1, 0xFFFF);
+  f.uptimeS = 5000;
+  addCourtRecord(f, 1, false);
+  links.observe(f, 0);
+
+  f.seq = 0x0000; // wrapped, still the next frame
+  f.uptimeS = 5015;
+  TEST_ASSERT_TRUE(links.observe(f, 15000) == SeqResult::Fresh);
+  TEST_ASSERT_EQUAL_UINT32(0, links.link(1).lost);
+
+  // Power cycle: sequence restarts and uptime goes backwards
+  f.seq = 0;
+  f.uptimeS = 3;
+  TEST_ASSERT_TRUE(links.observe(f, 20000) == SeqResult::Fresh);
+  TEST_ASSERT_EQUAL_UINT32(1, links.link(1).reboots);
+  TEST_ASSERT_EQUAL_UINT32(0, links.link(1).duplicates);
+}
+
+void test_link_tracker_passes_legacy_frames()
+{
+  LinkTracker<8> links;
+  const uint8_t legacy[] = {2, 1};
+  CourtFrame f;
+  decodeCourtFrame(legacy, sizeof(legacy), f);
+  TEST_ASSERT_TRUE(links.observe(f, 0) == SeqResult::Fresh);
+  TEST_ASSERT_TRUE(links.observe(f, 1) == SeqResult::Fresh); // no seq to compare
+  TEST_ASSERT_FALSE(links.link(2).seen);
+}
+
+void test_link_tracker_records_reported_awake_time()
+{
+  LinkTracker<8> links;
+  CourtFrame f;
+  initCourtFrame(f, 3, 1);
+  addCourtRecord(f, 3, true);
+  links.observe(f, 0);
+  TEST_ASSERT_EQUAL_UINT32(0, links.link(3).awakeReports);
+
+  uint8_t buf[PACKET_MAX_BYTES];
+  CourtFrame rx;
+  initCourtFrame(f, 3, 2);
+  addCourtRecord(f, 3, true);
+  setFrameExt(f, PACKET_EXT_AWAKE_MS, 140);
+  TEST_ASSERT_TRUE(decodeCourtFrame(buf, encodeCourtFrame(f, buf, sizeof(buf)), rx));
+  links.observe(rx, 15000);
+
+  f.seq = 3;
+  f.ext[PACKET_EXT_AWAKE_MS] = 60;
+  setFrameExt(f, PACKET_EXT_PRESS_MS, 38); // a press rode along
+  TEST_ASSERT_TRUE(decodeCourtFrame(buf, encodeCourtFrame(f, buf, sizeof(buf)), rx));
+  links.observe(rx, 30000);
+  links.observe(rx, 30001); // duplicate is not counted again
+
+  TEST_ASSERT_EQUAL_UINT16(60, links.link(3).awakeMs);
+  TEST_ASSERT_EQUAL_UINT32(2, links.link(3).awakeReports);
+  TEST_ASSERT_EQUAL_UINT32(200, links.link(3).awakeTotalMs);
+  TEST_ASSERT_EQUAL_UINT16(38, links.link(3).pressMs);
+  TEST_ASSERT_EQUAL_UINT32(1, links.link(3).pressReports);
+}
+
+// ============================================
+// PACKET QUEUE TESTS
+// ============================================
+
+void test_spsc_queue_fifo_and_empty()
+{
+  SpscQueue<ReceivedFrame, 4> q;
+  ReceivedFrame out;
+  TEST_ASSERT_FALSE(q.pop(out));
+
+  for (uint8_t i = 1; i <= 3; i++)
+  {
+    ReceivedFrame rx;
+    initCourtFrame(rx.frame, i, i);
+    addCourtRecord(rx.frame, i, i & 1);
+    rx.rxMs = 1000u * i;
+    TEST_ASSERT_TRUE(q.push(rx));
+  }
+  TEST_ASSERT_EQUAL_UINT32(3, q.size());
+
+  for (uint8_t i = 1; i <= 3; i++)
+  {
+    TEST_ASSERT_TRUE(q.pop(out));
+    TEST_ASSERT_EQUAL_UINT8(i, out.frame.records[0].courtId);
+    TEST_ASSERT_EQUAL_UINT32(1000u * i, out.rxMs);
+  }
+  TEST_ASSERT_TRUE(q.empty());
+}
+
+void test_spsc_queue_drops_when_full()
+{
+  SpscQueue<ReceivedFrame, 4> q;
+  ReceivedFrame rx;
+  initCourtFrame(rx.frame, 1, 0);
+  addCourtRecord(rx.frame, 1, true);
+  rx.rxMs = 0;
+  for (int i = 0; i < 4; i++)
+    TEST_ASSERT_TRUE(q.push(rx));
+
+  // Ring full — producer must not block or overwrite
+  TEST_ASSERT_FALSE(q.push(rx));
+  TEST_ASSERT_FALSE(q.push(rx));
+  TEST_ASSERT_EQUAL_UINT32(2, q.dropped());
+  TEST_ASSERT_EQUAL_UINT32(4, q.pushed());
+
+  // Draining one slot makes room again
+  ReceivedFrame out;
+  TEST_ASSERT_TRUE(q.pop(out));
+  TEST_ASSERT_TRUE(q.push(rx));
+  TEST_ASSERT_EQUAL_UINT32(2, q.dropped());
+}
+
+void test_spsc_queue_wraps_index()
+{
+  SpscQueue<uint32_t, 8> q;
+  uint32_t out = 0;
+  // Many more items than capacity, interleaved, to exercise index wrap
+  for (uint32_t i = 0; i < 1000; i++)
+  {
+    TEST_ASSERT_TRUE(q.push(i));
+    TEST_ASSERT_TRUE(q.pop(out));
+    TEST_ASSERT_EQUAL_UINT32(i, out);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, q.dropped());
+}
+
+void test_spsc_queue_two_thread_hammer()
+{
+  // Producer plays the WiFi task, consumer plays loop(). Every item the
+  // producer managed to push must come out exactly once and in order.
+  static SpscQueue<uint32_t, 16> q;
+  const uint32_t kItems = 200000;
+  uint32_t accepted = 0;
+
+  std::thread producer([&]()
+                       {
+    for (uint32_t i = 0; i < kItems; i++)
+    {
+      if (q.push(i))
+        accepted++;
+    } });
+
+  uint32_t received = 0;
+  uint32_t last = 0;
+  bool ordered = true;
+  bool first = true;
+  auto drain = [&]()
+  {
+    uint32_t v;
+    while (q.pop(v))
+    {
+      if (!first && v <= last)
+        ordered = false;
+      first = false;
+      last = v;
+      received++;
+    }
+  };
+
+  while (received + q.dropped() < kItems)
+    drain();
+  producer.join();
+  drain();
+
+  TEST_ASSERT_TRUE(ordered);
+  TEST_ASSERT_EQUAL_UINT32(accepted, received);
+  TEST_ASSERT_EQUAL_UINT32(kItems, received + q.dropped());
+  TEST_ASSERT_EQUAL_UINT32(accepted, q.pushed());
+}
+
+// ============================================
+// ANIMATION SCHEDULER TESTS
+// ============================================
+
+void test_animation_idle_without_events()
+{
+  AnimationScheduler anim;
+  AnimFrame fr;
+  TEST_ASSERT_TRUE(anim.tick(1000, fr) == AnimTick::Idle);
+  TEST_ASSERT_FALSE(anim.active());
+}
+
+void test_animation_frames_follow_clock()
+{
+  AnimationScheduler anim;
+  AnimFrame fr;
+  unsigned long t0 = 5000;
+  TEST_ASSERT_TRUE(anim.enqueue(3));
+
+  TEST_ASSERT_TRUE(anim.tick(t0, fr) == AnimTick::Frame);
+  TEST_ASSERT_EQUAL_UINT8(3, fr.courtId);
+  TEST_ASSERT_EQUAL_UINT8(0, fr.frame);
+
+  // Same frame slot — nothing new to draw
+  TEST_ASSERT_TRUE(anim.tick(t0 + ANIM_FRAME_MS - 1, fr) == AnimTick::Hold);
+
+  TEST_ASSERT_TRUE(anim.tick(t0 + ANIM_FRAME_MS, fr) == AnimTick::Frame);
+  TEST_ASSERT_EQUAL_UINT8(1, fr.frame);
+
+  // A late loop() skips ahead instead of replaying missed frames
+  TEST_ASSERT_TRUE(anim.tick(t0 + 10 * ANIM_FRAME_MS + 7, fr) == AnimTick::Frame);
+  TEST_ASSERT_EQUAL_UINT8(10, fr.frame);
+
+  // Runs for the full length, then reports Done exactly once
+  TEST_ASSERT_TRUE(anim.tick(t0 + (ANIM_TOTAL_FRAMES - 1) * ANIM_FRAME_MS, fr) == AnimTick::Frame);
+  TEST_ASSERT_EQUAL_UINT8(ANIM_TOTAL_FRAMES - 1, fr.frame);
+  TEST_ASSERT_TRUE(anim.tick(t0 + ANIM_TOTAL_FRAMES * ANIM_FRAME_MS, fr) == AnimTick::Done);
+  TEST_ASSERT_TRUE(anim.tick(t0 + ANIM_TOTAL_FRAMES * ANIM_FRAME_MS + 1, fr) == AnimTick::Idle);
+}
+
+void test_animation_coalesces_duplicate_courts()
+{
+  AnimationScheduler anim;
+  AnimFrame fr;
+  TEST_ASSERT_TRUE(anim.enqueue(2));
+  TEST_ASSERT_FALSE(anim.enqueue(2)); // already queued
+  anim.tick(0, fr);
+  TEST_ASSERT_FALSE(anim.enqueue(2)); // already playing
+  TEST_ASSERT_EQUAL_UINT8(0, anim.pending());
+}
+
+void test_animation_queues_back_to_back_courts()
+{
+  AnimationScheduler anim;
+  AnimFrame fr;
+  anim.enqueue(1);
+  anim.tick(0, fr);
+  anim.enqueue(4);
+
+  // With a court waiting, the first animation is cut short
+  unsigned long rushEnd = ANIM_RUSH_FRAMES * ANIM_FRAME_MS;
+  TEST_ASSERT_TRUE(anim.tick(rushEnd - 1, fr) == AnimTick::Frame);
+  TEST_ASSERT_EQUAL_UINT8(1, fr.courtId);
+
+  // ...and the next one starts on the same tick, from frame 0
+  TEST_ASSERT_TRUE(anim.tick(rushEnd, fr) == AnimTick::Frame);
+  TEST_ASSERT_EQUAL_UINT8(4, fr.courtId);
+  TEST_ASSERT_EQUAL_UINT8(0, fr.frame);
+
+  // Last in line plays its full length
+  TEST_ASSERT_TRUE(anim.tick(rushEnd + (ANIM_TOTAL_FRAMES - 1) * ANIM_FRAME_MS, fr) == AnimTick::Frame);
+  TEST_ASSERT_TRUE(anim.tick(rushEnd + ANIM_TOTAL_FRAMES * ANIM_FRAME_MS, fr) == AnimTick::Done);
+}
+
+// ============================================
+// OLED DIRTY-REGION TESTS
+// ============================================
+
+void test_frame_diff_first_flush_is_full_frame()
+{
+  static uint8_t fb[FB_BYTES] = {0};
+  static FrameDiffer differ;
+  differ.invalidate();
+  DirtySpan spans[OLED_MAX_SPANS];
+
+  size_t n = differ.diff(fb, spans, OLED_MAX_SPANS);
+  TEST_ASSERT_EQUAL_UINT32(FB_PAGES, n);
+  for (size_t i = 0; i < n; i++)
+  {
+    TEST_ASSERT_EQUAL_UINT8(i, spans[i].page);
+    TEST_ASSERT_EQUAL_UINT8(0, spans[i].x0);
+    TEST_ASSERT_EQUAL_UINT8(FB_WIDTH - 1, spans[i].x1);
+  }
+
+  // Nothing changed since — nothing to send
+  TEST_ASSERT_EQUAL_UINT32(0, differ.diff(fb, spans, OLED_MAX_SPANS));
+}
+
+void test_frame_diff_reports_only_changed_columns()
+{
+  static uint8_t fb[FB_BYTES] = {0};
+  static FrameDiffer differ;
+  differ.invalidate();
+  DirtySpan spans[OLED_MAX_SPANS];
+  differ.diff(fb, spans, OLED_MAX_SPANS);
+
+  // Seconds digits of a MM:SS timer on page 3
+  fb[3 * FB_WIDTH + 100] = 0x3E;
+  fb[3 * FB_WIDTH + 104] = 0x41;
+  // Unrelated change far away on page 6
+  fb[6 * FB_WIDTH + 2] = 0x01;
+
+  size_t n = differ.diff(fb, spans, OLED_MAX_SPANS);
+  TEST_ASSERT_EQUAL_UINT32(2, n);
+  TEST_ASSERT_EQUAL_UINT8(3, spans[0].page);
+  TEST_ASSERT_EQUAL_UINT8(100, spans[0].x0); // small gap merged
+  TEST_ASSERT_EQUAL_UINT8(104, spans[0].x1);
+  TEST_ASSERT_EQUAL_UINT8(6, spans[1].page);
+  TEST_ASSERT_EQUAL_UINT8(2, spans[1].x0);
+  TEST_ASSERT_EQUAL_UINT8(2, spans[1].x1);
+}
+
+void test_frame_diff_splits_distant_changes()
+{
+  static uint8_t fb[FB_BYTES] = {0};
+  static FrameDiffer differ;
+  differ.invalidate();
+  DirtySpan spans[OLED_MAX_SPANS];
+  differ.diff(fb, spans, OLED_MAX_SPANS);
+
+  fb[10] = 0xFF;
+  fb[10 + OLED_SPAN_MERGE_GAP + 1] = 0xFF;
+  size_t n = differ.diff(fb, spans, OLED_MAX_SPANS);
+  TEST_ASSERT_EQUAL_UINT32(2, n);
+  TEST_ASSERT_EQUAL_UINT8(10, spans[0].x1);
+  TEST_ASSERT_EQUAL_UINT8(10 + OLED_SPAN_MERGE_GAP + 1, spans[1].x0);
+}
+
+void test_frame_diff_out_of_spans_keeps_pending_bytes()
+{
+  static uint8_t fb[FB_BYTES] = {0};
+  static FrameDiffer differ;
+  differ.invalidate();
+  DirtySpan spans[2];
+  DirtySpan big[OLED_MAX_SPANS];
+  differ.diff(fb, big, OLED_MAX_SPANS);
+
+  fb[0 * FB_WIDTH] = 1;
+  fb[0 * FB_WIDTH + 64] = 1; // second span on page 0
+  fb[5 * FB_WIDTH + 7] = 1;  // no slot left for page 5
+
+  size_t n = differ.diff(fb, spans, 2);
+  TEST_ASSERT_EQUAL_UINT32(2, n);
+  TEST_ASSERT_EQUAL_UINT8(0, spans[1].page);
+
+  // The page-5 byte was not sent, so it must still be reported
+  n = differ.diff(fb, spans, 2);
+  TEST_ASSERT_EQUAL_UINT32(1, n);
+  TEST_ASSERT_EQUAL_UINT8(5, spans[0].page);
+  TEST_ASSERT_EQUAL_UINT8(7, spans[0].x0);
+}
+
+// ============================================
+// TRANSMITTER POWER BUDGET TESTS
+// ============================================
+
+void test_power_budget_weights_states_by_time()
+{
+  PowerBudget b;
+  initPowerBudget(b);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, averageCurrentMa(b, PWR_MODE_AVAILABLE));
+
+  addPowerTime(b, PWR_MODE_AVAILABLE, PWR_ACTIVE, 1000);
+  addPowerTime(b, PWR_MODE_AVAILABLE, PWR_LIGHT_SLEEP, 3000);
+  TEST_ASSERT_EQUAL_UINT32(4000, modeTotalMs(b, PWR_MODE_AVAILABLE));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, (PWR_ACTIVE_MA + 3 * PWR_LIGHT_SLEEP_MA) / 4,
+                           averageCurrentMa(b, PWR_MODE_AVAILABLE));
+
+  // Modes are accounted separately
+  TEST_ASSERT_EQUAL_UINT32(0, modeTotalMs(b, PWR_MODE_OCCUPIED));
+}
+
+void test_power_budget_led_scales_with_duty()
+{
+  PowerBudget b;
+  initPowerBudget(b);
+  addPowerTime(b, PWR_MODE_OCCUPIED, PWR_DEEP_SLEEP, 2000);
+  addLedTime(b, PWR_MODE_OCCUPIED, 2000, 50);
+  TEST_ASSERT_EQUAL_UINT32(1000, b.ledFullMs[PWR_MODE_OCCUPIED]);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, PWR_DEEP_SLEEP_MA + PWR_LED_FULL_MA / 2,
+                           averageCurrentMa(b, PWR_MODE_OCCUPIED));
+}
+
+// ============================================
+// ADAPTIVE HEARTBEAT TESTS
+// ============================================
+
+void test_heartbeat_backs_off_while_acked()
+{
+  HeartbeatPolicy p;
+  initHeartbeat(p);
+  TEST_ASSERT_EQUAL_UINT16(HEARTBEAT_MIN_SEC, p.intervalS);
+
+  uint16_t advertised = 0;
+  for (int i = 0; i < 32; i++)
+  {
+    advertised = heartbeatNextIfAcked(p);
+    uint16_t next = heartbeatAfterSend(p, true);
+    TEST_ASSERT_EQUAL_UINT16(advertised, next); // frame always tells the truth
+    TEST_ASSERT_TRUE(next <= HEARTBEAT_MAX_SEC);
+  }
+  TEST_ASSERT_EQUAL_UINT16(HEARTBEAT_MAX_SEC, p.intervalS);
+}
+
+void test_heartbeat_tightens_on_failure_and_state_change()
+{
+  HeartbeatPolicy p;
+  initHeartbeat(p);
+  for (int i = 0; i < 8; i++)
+    heartbeatAfterSend(p, true);
+  TEST_ASSERT_TRUE(p.intervalS > HEARTBEAT_MIN_SEC);
+
+  TEST_ASSERT_EQUAL_UINT16(HEARTBEAT_MIN_SEC, heartbeatAfterSend(p, false));
+
+  for (int i = 0; i < 8; i++)
+    heartbeatAfterSend(p, true);
+  heartbeatStateChanged(p);
+  TEST_ASSERT_EQUAL_UINT16(HEARTBEAT_MIN_SEC, p.intervalS);
+  TEST_ASSERT_EQUAL_UINT16(HEARTBEAT_MIN_SEC, heartbeatNextIfAcked(p)); // needs a streak first
+}
+
+// ============================================
+// STREAMING WAIT STATISTICS TESTS
+// ============================================
+
+void test_wait_stats_ewma_tracks_recent_games()
+{
+  WaitStats s;
+  initWaitStats(s);
+  addWaitSample(s, 600000, 0); // 10 min
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 600000.0f, s.ewmaMs);
+  for (int i = 0; i < 20; i++)
+    addWaitSample(s, 1800000, 1000 * i); // pace slows to 30 min
+  TEST_ASSERT_FLOAT_WITHIN(10000.0f, 1800000.0f, s.ewmaMs);
+  TEST_ASSERT_EQUAL_UINT32(21, s.count);
+}
+
+void test_wait_stats_windows_expire_old_games()
+{
+  WaitStats s;
+  initWaitStats(s);
+  uint32_t t0 = 10 * WAIT_BUCKET_MS;
+  addWaitSample(s, 40 * 60000UL, t0);                // slow morning game
+  addWaitSample(s, 10 * 60000UL, t0 + 40 * 60000UL); // 40 min later
+  TEST_ASSERT_EQUAL_UINT32(10 * 60000UL, windowMeanMs(s, t0 + 40 * 60000UL, true));
+  TEST_ASSERT_EQUAL_UINT32(25 * 60000UL, windowMeanMs(s, t0 + 40 * 60000UL, false));
+
+  // An hour after the first game it is out of both windows
+  TEST_ASSERT_EQUAL_UINT32(10 * 60000UL, windowMeanMs(s, t0 + 65 * 60000UL, false));
+  // Long idle: everything expires
+  TEST_ASSERT_EQUAL_UINT32(0, windowMeanMs(s, t0 + 300 * 60000UL, false));
+}
+
+void test_wait_stats_percentiles_from_histogram()
+{
+  WaitStats s;
+  initWaitStats(s);
+  TEST_ASSERT_EQUAL_UINT32(0, s.p50Ms);
+  // Games of 1..50 minutes, uniformly: p50 ≈ 25 min, p90 ≈ 45 min
+  for (uint32_t m = 1; m <= 50; m++)
+    addWaitSample(s, m * 60000UL, m * 60000UL);
+  TEST_ASSERT_UINT32_WITHIN(WAIT_HIST_BIN_MS, 25 * 60000UL, s.p50Ms);
+  TEST_ASSERT_UINT32_WITHIN(WAIT_HIST_BIN_MS, 45 * 60000UL, s.p90Ms);
+}
+
+void test_court_stats_follow_game_ends()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 0);
+  CourtPacket on = {3, 1}, off = {3, 0};
+  applyPacket(state, on, 1000);
+  applyPacket(state, off, 1000 + 20 * 60000UL);
+  TEST_ASSERT_EQUAL_UINT32(1, state.waits[2].count);
+  TEST_ASSERT_EQUAL_UINT32(0, state.waits[0].count);
+  TEST_ASSERT_EQUAL_UINT32(1, state.allWaits.count);
+  TEST_ASSERT_EQUAL_UINT32(20 * 60000UL, currentWaitMs(state, 1000 + 21 * 60000UL));
+  // Hours later the window is empty, so the lifetime average is shown
+  TEST_ASSERT_EQUAL_UINT32(overallAverageMs(state), currentWaitMs(state, 10 * 3600000UL));
+}
+
+// ============================================
+// NEXT-COURT PREDICTION TESTS
+// ============================================
+
+void test_expected_remaining_is_conditional_on_elapsed()
+{
+  WaitStats s;
+  initWaitStats(s);
+  for (int i = 0; i < 10; i++)
+  {
+    addWaitSample(s, 10 * 60000UL, 0);
+    addWaitSample(s, 30 * 60000UL, 0);
+  }
+  // Before 10 min, half the games end soon; after, only the 30-min kind is left
+  uint32_t early = expectedRemainingMs(s, 60000);
+  uint32_t late = expectedRemainingMs(s, 15 * 60000UL);
+  TEST_ASSERT_UINT32_WITHIN(WAIT_HIST_BIN_MS, 19 * 60000UL, early);
+  TEST_ASSERT_UINT32_WITHIN(WAIT_HIST_BIN_MS, 16 * 60000UL, late);
+  TEST_ASSERT_EQUAL_UINT32(0, expectedRemainingMs(s, 90 * 60000UL));
+}
+
+void test_predictor_orders_courts_by_free_time()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 0);
+  CourtPredictor<NUM_COURTS> predictor;
+
+  // No history yet: every game is assumed PREDICT_DEFAULT_GAME_MS long
+  CourtPacket c1 = {1, 1}, c4 = {4, 1}, c4off = {4, 0};
+  applyPacket(state, c1, 1000);
+  predictor.update(state, 0, 1000);
+  applyPacket(state, c4, 301000);
+  predictor.update(state, 3, 301000);
+  TEST_ASSERT_EQUAL_UINT32(2, predictor.size());
+  TEST_ASSERT_EQUAL_INT(0, predictor.courtAt(0)); // started first
+  TEST_ASSERT_EQUAL_UINT32(PREDICT_DEFAULT_GAME_MS - 300000, predictor.remainingMs(0, 301000));
+
+  applyPacket(state, c4off, 400000);
+  predictor.update(state, 3, 400000);
+  TEST_ASSERT_EQUAL_UINT32(1, predictor.size());
+
+  // Overdue court is re-predicted as "any minute now", not left at 0
+  uint32_t late = 1000 + PREDICT_DEFAULT_GAME_MS + 5000;
+  predictor.refresh(state, late);
+  TEST_ASSERT_EQUAL_UINT32(1, predictor.size());
+  TEST_ASSERT_TRUE(predictor.remainingMs(0, late) > 0);
+}
+
+// ============================================
+// EVENT LOG TESTS
+// ============================================
+
+// Fresh directory standing in for the LittleFS mount; tearDown()
+// removes it with the segments in it
+static char logDir[64];
+
+static const char *makeLogDir()
+{
+  snprintf(logDir, sizeof(logDir), "/tmp/rallyrack_log_XXXXXX");
+  const char *dir = mkdtemp(logDir);
+  if (!dir)
+    logDir[0] = 0;
+  TEST_ASSERT_NOT_NULL(dir);
+  return dir;
+}
+
+static void removeLogDir()
+{
+  if (!logDir[0])
+    return;
+  if (DIR *d = opendir(logDir))
+  {
+    char path[sizeof(logDir) + sizeof(dirent::d_name)];
+    while (dirent *e = readdir(d))
+    {
+      if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0)
+        continue;
+      snprintf(path, sizeof(path), "%s/%s", logDir, e->d_name);
+      remove(path);
+    }
+    closedir(d);
+  }
+  rmdir(logDir);
+  logDir[0] = 0;
+}
+
+void test_event_log_replay_rebuilds_state()
+{
+  const char *dir = makeLogDir();
+
+  SystemState live;
+  initSystemState(live);
+  openAllCourts(live, 1000);
+  EventLog log;
+  TEST_ASSERT_TRUE(log.open(dir));
+  log.append(EV_CLOCK, 0, 1000); // boot marker, sets the replay origin
+
+  uint32_t t = 1000;
+  for (int g = 0; g < 40; g++)
+  {
+    CourtPacket on = {(uint8_t)(1 + g % NUM_COURTS), 1};
+    CourtPacket off = {on.courtId, 0};
+    t += 60000;
+    applyPacket(live, on, t);
+    log.append(EV_OCCUPIED, on.courtId, t);
+    t += 600000 + 1000 * g;
+    applyPacket(live, off, t);
+    log.append(EV_FREED, off.courtId, t);
+    log.service(t, false);
+  }
+  CourtPacket running = {3, 1};
+  applyPacket(live, running, t + 5000);
+  log.append(EV_OCCUPIED, 3, t + 5000);
+  TEST_ASSERT_TRUE(log.flush());
+
+  // "Reboot": new log object, new state
+  SystemState restored;
+  initSystemState(restored);
+  EventLog reopened;
+  TEST_ASSERT_TRUE(reopened.open(dir));
+  TEST_ASSERT_EQUAL_UINT32(82, reopened.replay(restored));
+  TEST_ASSERT_EQUAL_UINT32(t + 5000, reopened.lastTimeMs());
+
+  TEST_ASSERT_EQUAL_UINT32(live.totalGames, restored.totalGames);
+  TEST_ASSERT_EQUAL_UINT32(overallAverageMs(live), overallAverageMs(restored));
+  TEST_ASSERT_TRUE(restored.courts[2].inUse);
+  TEST_ASSERT_EQUAL_UINT32(t + 5000, restored.courts[2].inUseSinceMs);
+  for (int c = 0; c < NUM_COURTS; c++)
+    TEST_ASSERT_EQUAL_FLOAT(live.courts[c].avgWaitMs, restored.courts[c].avgWaitMs);
+}
+
+void test_event_log_survives_torn_tail()
+{
+  const char *dir = makeLogDir();
+  EventLog log;
+  TEST_ASSERT_TRUE(log.open(dir));
+  log.append(EV_OCCUPIED, 1, 1000);
+  log.append(EV_FREED, 1, 61000);
+  TEST_ASSERT_TRUE(log.flush());
+
+  // Power lost mid-write: half a record at the end of the segment
+  char path[96];
+  snprintf(path, sizeof(path), "%s/ev0.log", dir);
+  FILE *f = fopen(path, "ab");
+  const uint8_t junk[5] = {EV_OCCUPIED, 2, 9, 9, 9};
+  fwrite(junk, 1, sizeof(junk), f);
+  fclose(f);
+
+  EventLog reopened;
+  TEST_ASSERT_TRUE(reopened.open(dir));
+  TEST_ASSERT_EQUAL_UINT32(1, reopened.stats().tornSegments);
+  reopened.append(EV_OCCUPIED, 2, 70000); // must not land behind the junk
+  TEST_ASSERT_TRUE(reopened.flush());
+
+  SystemState state;
+  initSystemState(state);
+  EventLog again;
+  again.open(dir);
+  TEST_ASSERT_EQUAL_UINT32(3, again.replay(state));
+  TEST_ASSERT_EQUAL_UINT32(1, state.totalGames);
+  TEST_ASSERT_TRUE(state.courts[1].inUse);
+}
+
+void test_event_log_ring_drops_oldest_segment()
+{
+  const char *dir = makeLogDir();
+  EventLog log;
+  TEST_ASSERT_TRUE(log.open(dir));
+  const uint32_t perSegment = EVENT_LOG_SEGMENT_BYTES / EVENT_RECORD_BYTES;
+  const uint32_t total = perSegment * (EVENT_LOG_SEGMENTS + 1);
+  for (uint32_t i = 0; i < total; i++)
+  {
+    log.append(EV_CLOCK, 0, i);
+    log.service(i, false);
+  }
+  TEST_ASSERT_TRUE(log.flush());
+  TEST_ASSERT_EQUAL_UINT32(total, log.stats().written);
+
+  SystemState state;
+  initSystemState(state);
+  EventLog reopened;
+  reopened.open(dir);
+  uint32_t kept = reopened.replay(state);
+  TEST_ASSERT_TRUE(kept < total);
+  TEST_ASSERT_TRUE(kept >= perSegment * (EVENT_LOG_SEGMENTS - 1));
+  TEST_ASSERT_EQUAL_UINT32(total - 1, reopened.lastTimeMs()); // newest records always kept
+}
+
+// ============================================
+// TELEMETRY TESTS
+// ============================================
+
+void test_cobs_round_trips_zeros_and_long_runs()
+{
+  uint8_t in[600], enc[620], dec[600];
+  for (size_t i = 0; i < sizeof(in); i++)
+    in[i] = (i % 300 == 0) ? 0 : (uint8_t)i; // zeros plus runs longer than 254
+  size_t n = cobsEncode(in, sizeof(in), enc);
+  for (size_t i = 0; i < n; i++)
+    TEST_ASSERT_NOT_EQUAL(0, enc[i]);
+  TEST_ASSERT_EQUAL_UINT32(sizeof(in), cobsDecode(enc, n, dec, sizeof(dec)));
+  TEST_ASSERT_EQUAL_MEMORY(in, dec, sizeof(in));
+}
+
+void test_telemetry_stream_sends_snapshot_then_changes_only()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 1000);
+  CourtPredictor<NUM_COURTS> predictor;
+  TelemetryStream<NUM_COURTS> stream;
+  std::vector<uint8_t> wire;
+  auto write = [&](const uint8_t *b, size_t n)
+  { wire.insert(wire.end(), b, b + n); };
+
+  stream.service(state, predictor, 1000, write);
+  stream.service(state, predictor, 1000 + TELEMETRY_DELTA_MS, write); // nothing changed
+  CourtPacket on = {5, 1};
+  applyPacket(state, on, 3000);
+  predictor.update(state, 4, 3000);
+  const char *noise = "[OCCUPIED] Court 5 now in use\n"; // text log sharing the port
+  wire.insert(wire.end(), noise, noise + strlen(noise));
+  stream.service(state, predictor, 3000, write);
+
+  TelemetryDecoder decoder;
+  TelemetryBoard board;
+  TelemetryFrame f;
+  int frames = 0;
+  for (uint8_t b : wire)
+    if (decoder.feed(b, f))
+    {
+      board.apply(f);
+      frames++;
+      if (frames == 1)
+      {
+        TEST_ASSERT_EQUAL_UINT8(TLM_SNAPSHOT, f.type);
+        TEST_ASSERT_EQUAL_UINT8(NUM_COURTS, f.count);
+      }
+    }
+
+  TEST_ASSERT_EQUAL_INT(2, frames);
+  TEST_ASSERT_EQUAL_UINT32(1, decoder.noise);
+  TEST_ASSERT_EQUAL_UINT8(TLM_DELTA, f.type);
+  TEST_ASSERT_EQUAL_UINT8(1, f.count);
+  TEST_ASSERT_EQUAL_UINT8(5, f.nextCourt);
+  TEST_ASSERT_TRUE(board.court[5].flags & TLM_FLAG_IN_USE);
+  TEST_ASSERT_EQUAL_UINT32(3000, board.court[5].sinceMs);
+  TEST_ASSERT_TRUE(board.court[1].flags & TLM_FLAG_AVAILABLE);
+  TEST_ASSERT_EQUAL_UINT32(0, board.seqGaps);
+}
+
+void test_telemetry_decoder_rejects_corrupt_frame()
+{
+  TelemetryFrame f = {};
+  f.type = TLM_DELTA;
+  f.count = 1;
+  f.courts[0] = TelemetryCourt{2, TLM_FLAG_IN_USE, 1234, 600, 3};
+  uint8_t payload[TLM_MAX_PAYLOAD], enc[TLM_MAX_ENCODED];
+  size_t n = cobsEncode(payload, encodeTelemetryPayload(f, payload), enc);
+  enc[n / 2] ^= 0x10; // flip a bit on the wire (stays non-zero)
+
+  TelemetryDecoder decoder;
+  TelemetryFrame out;
+  bool got = false;
+  for (size_t i = 0; i < n; i++)
+    got |= decoder.feed(enc[i], out);
+  got |= decoder.feed(0, out);
+  TEST_ASSERT_FALSE(got);
+  TEST_ASSERT_EQUAL_UINT32(1, decoder.noise);
+}
+
 void setUp(void) { /* before each test */ }
-void tearDown(void) { /* after each test */ }
+void tearDown(void) { removeLogDir(); }
+
+// ============================================
+// STATE SYNC TESTS
+// ============================================
+
+// Delimited frames on the wire → decoded sync frames
+static std::vector<SyncFrame> decodeSyncFrames(const std::vector<uint8_t> &wire)
+{
+  std::vector<SyncFrame> out;
+  CobsReader<SYNC_MAX_PAYLOAD> reader;
+  const uint8_t *payload;
+  size_t len;
+  SyncFrame f;
+  for (uint8_t b : wire)
+    if (reader.feed(b, payload, len) && decodeSyncPayload(payload, len, f))
+      out.push_back(f);
+  return out;
+}
+
+static void sendAck(SyncProducer<NUM_COURTS> &producer, const SyncAck &ack)
+{
+  uint8_t payload[SYNC_ACK_BYTES], out[COBS_MAX_FRAME(SYNC_ACK_BYTES)];
+  size_t n = cobsFrame(payload, encodeSyncAck(ack, payload), out);
+  for (size_t i = 0; i < n; i++)
+    producer.receive(out[i]);
+}
+
+void test_sync_delta_carries_only_changed_fields()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 1000);
+  CourtPredictor<NUM_COURTS> predictor;
+  SyncProducer<NUM_COURTS> producer(0x1234);
+  SyncConsumer consumer;
+  std::vector<uint8_t> wire;
+  auto write = [&](const uint8_t *b, size_t n)
+  { wire.insert(wire.end(), b, b + n); };
+
+  producer.service(state, predictor, 1000, write);
+  std::vector<SyncFrame> frames = decodeSyncFrames(wire);
+  TEST_ASSERT_EQUAL_INT(1, (int)frames.size());
+  TEST_ASSERT_EQUAL_UINT32(0, frames[0].baseVersion);
+  TEST_ASSERT_EQUAL_UINT8(NUM_COURTS, frames[0].count);
+  sendAck(producer, consumer.apply(frames[0]));
+  TEST_ASSERT_EQUAL_UINT32(producer.version(), producer.ackedVersion());
+
+  // Caught up: nothing goes out until something changes
+  wire.clear();
+  producer.service(state, predictor, 1000 + SYNC_INTERVAL_MS, write);
+  TEST_ASSERT_EQUAL_INT(0, (int)wire.size());
+
+  CourtPacket on = {3, 1};
+  applyPacket(state, on, 2500);
+  producer.service(state, predictor, 2500, write);
+  frames = decodeSyncFrames(wire);
+  TEST_ASSERT_EQUAL_INT(1, (int)frames.size());
+  TEST_ASSERT_EQUAL_UINT32(consumer.version(), frames[0].baseVersion);
+  TEST_ASSERT_EQUAL_UINT8(1, frames[0].count);
+  TEST_ASSERT_EQUAL_UINT8(3, frames[0].records[0].val.courtId);
+  TEST_ASSERT_EQUAL_HEX8(SYNC_F_FLAGS | SYNC_F_SINCE, frames[0].records[0].mask);
+  TEST_ASSERT_EQUAL_UINT32(producer.version(), frames[0].toVersion);
+  TEST_ASSERT_EQUAL_UINT32(producer.courtVersion(2), frames[0].toVersion);
+
+  consumer.apply(frames[0]);
+  TEST_ASSERT_TRUE(consumer.board.court[3].flags & TLM_FLAG_IN_USE);
+  TEST_ASSERT_EQUAL_UINT32(2500, consumer.board.court[3].sinceMs);
+  TEST_ASSERT_EQUAL_UINT32(producer.version(), consumer.version());
+}
+
+void test_sync_converges_under_drops_and_reordering()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 1000);
+  CourtPredictor<NUM_COURTS> predictor;
+  SyncProducer<NUM_COURTS> producer(0x0BAD);
+  SyncConsumer consumer;
+
+  // Frames in flight each way; every step each one is delivered,
+  // held back (reordered behind later frames), duplicated or dropped
+  std::vector<std::vector<uint8_t>> toBridge, toReceiver;
+  uint32_t rng = 12345;
+  auto roll = [&]()
+  {
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 16) % 100;
+  };
+  auto write = [&](const uint8_t *b, size_t n)
+  { toBridge.push_back(std::vector<uint8_t>(b, b + n)); };
+  auto deliver = [&](std::vector<std::vector<uint8_t>> &q, bool lossy, auto &&onFrame)
+  {
+    std::vector<std::vector<uint8_t>> held;
+    for (size_t i = q.size(); i-- > 0;) // newest first
+    {
+      uint32_t r = roll();
+      if (lossy && r < 20)
+        continue;
+      if (lossy && r < 80)
+      {
+        held.push_back(q[i]);
+        if (r >= 70)
+          onFrame(q[i]); // duplicated: delivered now and again later
+      }
+      else
+        onFrame(q[i]);
+    }
+    q.swap(held);
+  };
+  auto toConsumer = [&](const std::vector<uint8_t> &bytes)
+  {
+    for (const SyncFrame &f : decodeSyncFrames(bytes))
+    {
+      uint8_t payload[SYNC_ACK_BYTES], out[COBS_MAX_FRAME(SYNC_ACK_BYTES)];
+      size_t n = cobsFrame(payload, encodeSyncAck(consumer.apply(f), payload), out);
+      toReceiver.push_back(std::vector<uint8_t>(out, out + n));
+    }
+  };
+  auto toProducer = [&](const std::vector<uint8_t> &bytes)
+  {
+    for (uint8_t b : bytes)
+      producer.receive(b);
+  };
+
+  uint32_t t = 1000;
+  for (int step = 0; step < 3000; step++, t += 100)
+  {
+    if (step < 2400 && roll() < 30) // busy evening, then quiet
+    {
+      uint8_t court = (uint8_t)(1 + roll() % NUM_COURTS);
+      CourtPacket pkt = {court, (uint8_t)!state.courts[court - 1].inUse};
+      applyPacket(state, pkt, t);
+    }
+    producer.service(state, predictor, t, write);
+    bool lossy = step < 2700; // link recovers at the end
+    deliver(toBridge, lossy, toConsumer);
+    deliver(toReceiver, lossy, toProducer);
+  }
+
+  // Loss and reordering were actually exercised
+  TEST_ASSERT_TRUE(consumer.stats.frames < producer.framesSent);
+  TEST_ASSERT_TRUE(consumer.stats.stale > 0);
+  TEST_ASSERT_EQUAL_UINT32(producer.version(), consumer.version());
+  TEST_ASSERT_EQUAL_UINT32(producer.version(), producer.ackedVersion());
+  for (int i = 0; i < NUM_COURTS; i++)
+  {
+    TEST_ASSERT_TRUE(consumer.board.known[i + 1]);
+    TEST_ASSERT_TRUE(producer.court(i) == consumer.board.court[i + 1]);
+  }
+}
+
+void test_sync_resyncs_after_receiver_reboot()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 1000);
+  CourtPredictor<NUM_COURTS> predictor;
+  SyncConsumer consumer;
+  std::vector<uint8_t> wire;
+  auto write = [&](const uint8_t *b, size_t n)
+  { wire.insert(wire.end(), b, b + n); };
+
+  SyncProducer<NUM_COURTS> before(0x1111);
+  before.service(state, predictor, 1000, write);
+  for (const SyncFrame &f : decodeSyncFrames(wire))
+    consumer.apply(f);
+  TEST_ASSERT_EQUAL_UINT16(0x1111, consumer.epoch());
+
+  // Reboot mid-evening: the new producer has never been ACKed, so it
+  // opens with a snapshot and the bridge starts over from it
+  CourtPacket on = {6, 1};
+  applyPacket(state, on, 5000);
+  SyncProducer<NUM_COURTS> after(0x2222);
+  wire.clear();
+  after.service(state, predictor, 5000, write);
+  SyncAck ack = {0, 0};
+  for (const SyncFrame &f : decodeSyncFrames(wire))
+    ack = consumer.apply(f);
+  TEST_ASSERT_EQUAL_UINT16(0x2222, ack.epoch);
+  TEST_ASSERT_EQUAL_UINT32(after.version(), ack.version);
+  TEST_ASSERT_EQUAL_UINT32(1, consumer.stats.resyncs);
+  TEST_ASSERT_TRUE(consumer.board.court[6].flags & TLM_FLAG_IN_USE);
+
+  // A late ACK from the old boot asks the receiver for a fresh snapshot
+  sendAck(after, ack);
+  TEST_ASSERT_EQUAL_UINT32(after.version(), after.ackedVersion());
+  sendAck(after, SyncAck{0x1111, 3});
+  TEST_ASSERT_EQUAL_UINT32(0, after.ackedVersion());
+  wire.clear();
+  after.service(state, predictor, 5000 + SYNC_INTERVAL_MS, write);
+  std::vector<SyncFrame> frames = decodeSyncFrames(wire);
+  TEST_ASSERT_EQUAL_INT(1, (int)frames.size());
+  TEST_ASSERT_EQUAL_UINT32(0, frames[0].baseVersion);
+  TEST_ASSERT_EQUAL_UINT8(NUM_COURTS, frames[0].count);
+}
+
+// ============================================
+// OLED RENDER TESTS
+// ============================================
+
+void test_render_cache_matches_plain_font_blits()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 1000);
+  CourtPacket on = {2, 1};
+  applyPacket(state, on, 2000);
+  state.courts[0].avgWaitMs = 7.0f * 60000.0f;
+
+  OledRenderCache cache;
+  static uint8_t cached[FB_BYTES], plain[FB_BYTES];
+  uint32_t now = 2000 + 754000; // court 2 at 12:34
+  renderCourtTable(cache, cached, state, nullptr, 9UL * 60000UL, 0, now);
+
+  // The same screen, every string blitted from the font
+  memset(plain, 0, sizeof(plain));
+  blitText(plain, 0, 0, "RallyRack");
+  blitText(plain, 1, 0, "RallyRack");
+  blitText(plain, FB_WIDTH - 6 * 6, 0, "Avg:9m");
+  blitText(plain, 0, 10, "#");
+  blitText(plain, 18, 10, "Status");
+  blitText(plain, 78, 10, "Now");
+  blitText(plain, 108, 10, "Avg");
+  blitHLine(plain, 19);
+  for (int r = 0; r < COURTS_PER_PAGE; r++)
+  {
+    CourtRowFields f;
+    formatCourtRow(state.courts[r], r + 1, now, f);
+    int y = 22 + r * 10;
+    blitText(plain, 0, y, f.num);
+    blitText(plain, 18, y, f.status);
+    blitText(plain, 78, y, f.now);
+    blitText(plain, 108, y, f.avg);
+  }
+  TEST_ASSERT_EQUAL_MEMORY(plain, cached, FB_BYTES);
+}
+
+void test_blit_glyph_straddles_pages()
+{
+  static uint8_t fb[FB_BYTES];
+  memset(fb, 0, sizeof(fb));
+  blitGlyph(fb, 10, 22, '1'); // rows 22-28: bits 6-7 of page 2, 0-4 of page 3
+  const uint8_t *cols = fontGlyph('1');
+  for (int i = 0; i < FONT_GLYPH_COLS; i++)
+  {
+    TEST_ASSERT_EQUAL_HEX8((uint8_t)(cols[i] << 6), fb[2 * FB_WIDTH + 10 + i]);
+    TEST_ASSERT_EQUAL_HEX8((uint8_t)(cols[i] >> 2), fb[3 * FB_WIDTH + 10 + i]);
+  }
+  blitGlyph(fb, 125, 0, '8'); // clipped at the right edge
+  TEST_ASSERT_EQUAL_HEX8(fontGlyph('8')[2], fb[127]);
+}
+
+// ============================================
+// GOLDEN IMAGE TESTS
+// ============================================
+// Regenerate after an intended visual change with
+//   pio run -e oled_preview -t run -D run_args="--golden test/golden"
+
+void test_screens_match_golden_images()
+{
+  static MemoryTarget t;
+  static uint8_t rows[FB_HEIGHT][FB_WIDTH / 8];
+  char path[64], msg[96];
+  for (int s = 0; s < kGoldenSceneCount; s++)
+  {
+    snprintf(path, sizeof(path), "test/golden/%s.pbm", kGoldenScenes[s]);
+    TEST_ASSERT_TRUE_MESSAGE(readPbm(path, rows), path);
+    renderGoldenScene(s, t);
+    snprintf(msg, sizeof(msg), "%s: pixels differ from golden", kGoldenScenes[s]);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, pbmDiffPixels(t, rows), msg);
+  }
+}
+
+void test_screen_render_time_within_budget()
+{
+  static MemoryTarget t;
+  char msg[96];
+  for (int s = 0; s < kGoldenSceneCount; s++)
+  {
+    const int kRuns = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRuns; i++)
+      renderGoldenScene(s, t);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kRuns;
+    snprintf(msg, sizeof(msg), "%s: %.1f us/frame", kGoldenScenes[s], us);
+    TEST_MESSAGE(msg);
+    // Host time, generous: catches an accidental O(pixels^2) path, not jitter
+    TEST_ASSERT_TRUE_MESSAGE(us < 1000.0, msg);
+  }
+}
+
+// ============================================
+// INSTRUMENTATION TESTS
+// ============================================
+
+void test_histogram_percentiles_within_bucket_error()
+{
+  LatencyHistogram h;
+  TEST_ASSERT_EQUAL_UINT32(0, h.percentileUs(50));
+  for (uint32_t us = 1; us <= 1000; us++)
+    h.record(us);
+
+  TEST_ASSERT_EQUAL_UINT32(1000, h.count());
+  TEST_ASSERT_EQUAL_UINT32(1, h.minUs());
+  TEST_ASSERT_EQUAL_UINT32(1000, h.maxUs());
+  TEST_ASSERT_EQUAL_UINT32(500, h.meanUs());
+  // Upper bucket edges: never below the true value, at most 25% above
+  uint32_t p50 = h.percentileUs(50), p90 = h.percentileUs(90);
+  TEST_ASSERT_TRUE(p50 >= 500 && p50 <= 625);
+  TEST_ASSERT_TRUE(p90 >= 900 && p90 <= 1000);
+  TEST_ASSERT_EQUAL_UINT32(1000, h.percentileUs(100)); // capped at the max
+
+  // Every value falls in a bucket whose upper edge covers it
+  for (uint32_t us = 0; us < 5000000; us = us * 2 + 7)
+  {
+    int b = LatencyHistogram::bucketOf(us);
+    TEST_ASSERT_TRUE(LatencyHistogram::bucketUpperUs(b) >= us);
+    TEST_ASSERT_TRUE(b == 0 || LatencyHistogram::bucketUpperUs(b - 1) < us);
+  }
+  TEST_ASSERT_EQUAL_INT(INSTR_HIST_BUCKETS - 1, LatencyHistogram::bucketOf(UINT32_MAX));
+}
+
+void test_scoped_timer_records_elapsed_time()
+{
+  Instruments ins;
+  {
+    INSTR_SCOPE(ins[Probe::Render]);
+    uint32_t start = instrStamp();
+    while (instrElapsedUs(start) < 2000)
+    {
+    }
+  }
+  const LatencyHistogram &h = ins[Probe::Render];
+  TEST_ASSERT_EQUAL_UINT32(1, h.count());
+  TEST_ASSERT_TRUE(h.minUs() >= 2000 && h.minUs() < 200000);
+  TEST_ASSERT_EQUAL_UINT32(0, ins[Probe::Flush].count());
+
+  ins.reset();
+  TEST_ASSERT_EQUAL_UINT32(0, ins[Probe::Render].count());
+}
+
+void test_duration_format_fits_stats_page_column()
+{
+  char out[8];
+  const uint32_t us[] = {0, 850, 4250, 120000, 1500000, 42000000, UINT32_MAX};
+  const char *want[] = {"0us", "850us", "4.2ms", "120ms", "1.5s", "42s", "4294s"};
+  for (size_t i = 0; i < sizeof(us) / sizeof(us[0]); i++)
+  {
+    formatDurationUs(out, sizeof(out), us[i]);
+    TEST_ASSERT_EQUAL_STRING(want[i], out);
+    TEST_ASSERT_TRUE(strlen(out) <= 5);
+  }
+}
+
+// ============================================
+// WAKE SCHEDULE TESTS
+// ============================================
+
+// Court rows only: the header moves on a minute scale and is left
+// to the OLED_REFRESH_MS redraw
+static void renderRowsAt(const SystemState &state, uint32_t now, int firstCourt, uint8_t *fb)
+{
+  static OledRenderCache cache;
+  renderCourtTable(cache, fb, state, nullptr, 0, firstCourt, now);
+}
+
+void test_wake_schedule_catches_every_visible_change()
+{
+  static SystemState state;
+  static uint8_t atNow[FB_BYTES], before[FB_BYTES], atWake[FB_BYTES];
+  uint32_t rng = 777;
+  auto roll = [&](uint32_t n)
+  {
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 8) % n;
+  };
+
+  for (int trial = 0; trial < 500; trial++)
+  {
+    uint32_t now = 10000000u + roll(1000000);
+    initSystemState(state);
+    for (int i = 0; i < NUM_COURTS; i++)
+    {
+      CourtState &c = state.courts[i];
+      switch (roll(3))
+      {
+      case 0:
+        c.available = true;
+        c.availableSinceMs = now - roll(600000);
+        break;
+      case 1:
+        c.inUse = true;
+        c.inUseSinceMs = now - 1 - roll(3600000);
+        c.lastHeardMs = now - roll(60000);
+        c.faultTimeoutMs = roll(2) ? 0 : 20000 + roll(40000);
+        break;
+      default:
+        break; // never heard from
+      }
+    }
+
+    int first = courtPageAt<NUM_COURTS>(now) * COURTS_PER_PAGE;
+    uint32_t wake = nextTableChangeMs(state, now, first, OLED_REFRESH_MS);
+    TEST_ASSERT_TRUE(wake - now >= 1 && wake - now <= OLED_REFRESH_MS);
+
+    // Nothing visible changes while asleep...
+    renderRowsAt(state, now, first, atNow);
+    renderRowsAt(state, wake - 1, courtPageAt<NUM_COURTS>(wake - 1) * COURTS_PER_PAGE, before);
+    TEST_ASSERT_EQUAL_MEMORY(atNow, before, FB_BYTES);
+
+    // ...and a scheduled wake is never wasted
+    if (wake - now < OLED_REFRESH_MS)
+    {
+      renderRowsAt(state, wake, courtPageAt<NUM_COURTS>(wake) * COURTS_PER_PAGE, atWake);
+      TEST_ASSERT_TRUE(memcmp(atNow, atWake, FB_BYTES) != 0);
+    }
+  }
+}
+
+void test_wake_deadline_clamps_past_and_wraps()
+{
+  uint32_t now = 0xFFFFFF00u;
+  WakeDeadline wake(now, 500);
+  TEST_ASSERT_EQUAL_UINT32(500, wake.sleepMs());
+  wake.at(now + 0x200); // past the cap
+  TEST_ASSERT_EQUAL_UINT32(500, wake.sleepMs());
+  wake.at(now + 0x180); // across the 32-bit wrap, earlier than the cap
+  TEST_ASSERT_EQUAL_UINT32(0x180, wake.sleepMs());
+  TEST_ASSERT_EQUAL_UINT32(0x80, wake.ms());
+  wake.at(now - 5); // overdue: wake immediately
+  TEST_ASSERT_EQUAL_UINT32(0, wake.sleepMs());
+}
+
+void test_animation_next_frame_follows_frame_slots()
+{
+  AnimationScheduler anim;
+  AnimFrame fr;
+  anim.enqueue(3);
+  TEST_ASSERT_EQUAL(AnimTick::Frame, anim.tick(1000, fr));
+  TEST_ASSERT_EQUAL_UINT32(1000 + ANIM_FRAME_MS, anim.nextFrameMs());
+  TEST_ASSERT_EQUAL(AnimTick::Hold, anim.tick(anim.nextFrameMs() - 1, fr));
+  TEST_ASSERT_EQUAL(AnimTick::Frame, anim.tick(anim.nextFrameMs(), fr));
+  TEST_ASSERT_EQUAL_UINT8(1, fr.frame);
+
+  // Sleeping exactly until nextFrameMs() visits every frame, then Done
+  int frames = 2;
+  AnimTick t;
+  while ((t = anim.tick(anim.nextFrameMs(), fr)) == AnimTick::Frame)
+    frames++;
+  TEST_ASSERT_EQUAL(AnimTick::Done, t);
+  TEST_ASSERT_EQUAL_INT(ANIM_TOTAL_FRAMES, frames);
+}
+
+// ============================================
+// TIMER WHEEL TESTS
+// ============================================
+
+// Virtual clock against a brute-force deadline array: hundreds of
+// timers spread over every wheel level and past its horizon, with
+// jumps across the 32-bit wrap
+void test_timer_wheel_matches_brute_force_clock()
+{
+  const uint16_t kTimers = 512;
+  static TimerWheel<kTimers> wheel;
+  static bool armed[kTimers];
+  static uint32_t at[kTimers];
+  uint32_t rng = 2024;
+  auto roll = [&](uint32_t n)
+  {
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 8) % n;
+  };
+  // One span per wheel level, the last reaching past the 2^24 ms horizon
+  auto span = [&]()
+  {
+    switch (roll(4))
+    {
+    case 0:
+      return roll(64);
+    case 1:
+      return roll(4096);
+    case 2:
+      return roll(262144);
+    default:
+      return roll(40000) * 1000 + roll(1000);
+    }
+  };
+
+  // A crowded wheel, then a sparse one where far deadlines (parked
+  // past the horizon) are often the earliest
+  for (int run = 0; run < 2; run++)
+  {
+    uint32_t now = run ? 0xFFF00000u : 1000;
+    uint16_t ids = run ? 8 : kTimers;
+    wheel.reset(now);
+    memset(armed, 0, sizeof(armed));
+
+    for (int step = 0; step < 3000; step++)
+    {
+      uint32_t op = roll(10);
+      uint16_t id = (uint16_t)roll(ids);
+      if (op < 5)
+      {
+        at[id] = now + span();
+        wheel.schedule(id, at[id]);
+        armed[id] = true;
+        continue;
+      }
+      if (op < 6)
+      {
+        wheel.cancel(id);
+        armed[id] = false;
+        continue;
+      }
+
+      bool any = false;
+      uint32_t earliest = 0;
+      for (uint16_t i = 0; i < kTimers; i++)
+      {
+        if (armed[i] && (!any || (int32_t)(at[i] - earliest) < 0))
+          earliest = at[i];
+        any = any || armed[i];
+      }
+      uint32_t next = 0;
+      TEST_ASSERT_EQUAL(any, wheel.nextDeadline(next));
+      if (any)
+        TEST_ASSERT_EQUAL_UINT32(earliest, next);
+
+      // Every deadline up to the target fires exactly once, in order
+      uint32_t target = now + (roll(4) ? roll(3000) : roll(20000) * 1000);
+      uint32_t last = now;
+      wheel.advance(target, [&](uint16_t fired)
+                    {
+                      TEST_ASSERT_TRUE(armed[fired]);
+                      TEST_ASSERT_TRUE((int32_t)(at[fired] - target) <= 0);
+                      TEST_ASSERT_TRUE((int32_t)(at[fired] - last) >= 0);
+                      last = at[fired];
+                      armed[fired] = false; });
+      now = target;
+      size_t left = 0;
+      for (uint16_t i = 0; i < kTimers; i++)
+      {
+        TEST_ASSERT_FALSE(armed[i] && (int32_t)(at[i] - now) <= 0);
+        left += armed[i];
+      }
+      TEST_ASSERT_EQUAL_UINT32(left, wheel.size());
+    }
+  }
+}
+
+void test_timer_wheel_rearm_from_callback_and_cancel()
+{
+  TimerWheel<4> wheel(0);
+  int ticks = 0, other = 0;
+  wheel.schedule(0, 1000);
+  wheel.schedule(1, 2500);
+  wheel.schedule(1, 7000); // rescheduling moves the deadline
+  wheel.schedule(2, 3000);
+  wheel.cancel(2);
+  TEST_ASSERT_FALSE(wheel.pending(2));
+
+  // A periodic timer re-arms itself from its callback
+  auto fire = [&](uint16_t id)
+  {
+    if (id == 0)
+    {
+      ticks++;
+      wheel.schedule(0, wheel.now() + 1000);
+    }
+    else
+    {
+      other++;
+    }
+  };
+  TEST_ASSERT_EQUAL_UINT32(0, wheel.advance(999, fire));
+  TEST_ASSERT_EQUAL_UINT32(6, wheel.advance(6999, fire));
+  TEST_ASSERT_EQUAL_INT(6, ticks);
+  TEST_ASSERT_EQUAL_INT(0, other);
+  TEST_ASSERT_EQUAL_UINT32(2, wheel.advance(7000, fire));
+  TEST_ASSERT_EQUAL_INT(1, other);
+
+  // A deadline already in the past fires on the next advance, even
+  // without the clock moving
+  wheel.schedule(3, 5000);
+  uint32_t next = 0;
+  TEST_ASSERT_TRUE(wheel.nextDeadline(next));
+  TEST_ASSERT_EQUAL_UINT32(7000, next);
+  TEST_ASSERT_EQUAL_UINT32(1, wheel.advance(7000, fire));
+  TEST_ASSERT_FALSE(wheel.pending(3));
+}
+
+// Fault deadlines fire for every court, including the ones not on the
+// OLED page being shown, exactly when the row would start reading Fault
+void test_fault_timers_cover_undisplayed_courts()
+{
+  SystemState state;
+  initSystemState(state);
+  CourtTimers<NUM_COURTS>::Wheel wheel(0);
+  uint32_t now = 1000;
+  for (int i = 0; i < NUM_COURTS; i++)
+  {
+    applyPacket(state, CourtPacket{(uint8_t)(i + 1), 1}, now);
+    armFaultTimer<NUM_COURTS>(wheel, state, i);
+  }
+  state.courts[NUM_COURTS - 1].faultTimeoutMs = 20000; // advertised a fast heartbeat
+  armFaultTimer<NUM_COURTS>(wheel, state, NUM_COURTS - 1);
+
+  // Everyone but the last court keeps reporting
+  bool faulted[NUM_COURTS] = {false};
+  uint32_t firedAt[NUM_COURTS] = {0};
+  for (now = 1000; now < 200000; now += 250)
+  {
+    if (now % 10000 == 0)
+    {
+      for (int i = 0; i < NUM_COURTS - 1; i++)
+      {
+        applyPacket(state, CourtPacket{(uint8_t)(i + 1), 1}, now);
+        armFaultTimer<NUM_COURTS>(wheel, state, i);
+      }
+    }
+    wheel.advance(now, [&](uint16_t id)
+                  {
+                    TEST_ASSERT_TRUE(id < NUM_COURTS);
+                    faulted[id] = true;
+                    firedAt[id] = wheel.now(); });
+  }
+
+  for (int i = 0; i < NUM_COURTS - 1; i++)
+    TEST_ASSERT_FALSE(faulted[i]);
+  TEST_ASSERT_TRUE(faulted[NUM_COURTS - 1]);
+  const CourtState &silent = state.courts[NUM_COURTS - 1];
+  TEST_ASSERT_FALSE(courtFaulted(silent, firedAt[NUM_COURTS - 1] - 1));
+  TEST_ASSERT_TRUE(courtFaulted(silent, firedAt[NUM_COURTS - 1]));
+  TEST_ASSERT_EQUAL_UINT32(NUM_COURTS - 1, wheel.size());
+}
+
+// ============================================
+// TRANSMITTER JOURNAL TESTS
+// ============================================
+
+void test_journal_coalesces_undone_presses_and_keeps_real_games()
+{
+  TxJournal j;
+  journalInit(j);
+  journalRecord(j, true, 1000);
+  journalRecord(j, false, 2500); // undone within TX_COALESCE_MS
+  TEST_ASSERT_FALSE(journalPending(j));
+
+  journalRecord(j, true, 10000);
+  journalRecord(j, true, 11000); // no change
+  journalRecord(j, false, 610000);
+  journalRecord(j, true, 700000);
+  TEST_ASSERT_EQUAL_UINT8(3, j.count);
+
+  // One frame carries the backlog, each record aged from its press
+  CourtFrame f, out;
+  initCourtFrame(f, 4, 9);
+  journalFill(j, f, 4, 760000);
+  uint8_t buf[PACKET_MAX_BYTES];
+  size_t len = encodeCourtFrame(f, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT32(PACKET_HEADER_BYTES + 4 * 3, len);
+  TEST_ASSERT_TRUE(decodeCourtFrame(buf, len, out));
+  TEST_ASSERT_EQUAL_UINT8(3, out.count);
+  TEST_ASSERT_EQUAL_UINT8(1, out.records[0].occupied);
+  TEST_ASSERT_EQUAL_UINT32(750000, recordAgeMs(out, 0));
+  TEST_ASSERT_EQUAL_UINT8(0, out.records[1].occupied);
+  TEST_ASSERT_EQUAL_UINT32(150000, recordAgeMs(out, 1));
+  TEST_ASSERT_EQUAL_UINT32(60000, recordAgeMs(out, 2));
+
+  // A full journal drops the oldest entries, never the current state
+  for (uint32_t i = 0; i < TX_JOURNAL_DEPTH; i++)
+    journalRecord(j, i % 2 == 1, 800000 + i * 60000);
+  TEST_ASSERT_EQUAL_UINT8(TX_JOURNAL_DEPTH, j.count);
+  TEST_ASSERT_EQUAL_UINT32(3, j.dropped);
+  TEST_ASSERT_EQUAL_UINT32(800000 + (TX_JOURNAL_DEPTH - 1) * 60000, j.entries[TX_JOURNAL_DEPTH - 1].atMs);
+
+  journalSent(j, true, 2000000, 0);
+  TEST_ASSERT_FALSE(journalPending(j));
+}
+
+void test_journal_backoff_doubles_with_jitter_and_caps()
+{
+  uint32_t rng = 99;
+  for (uint8_t attempts = 1; attempts < 20; attempts++)
+  {
+    uint32_t step = attempts <= 16 ? (uint32_t)TX_RETRY_BASE_MS << (attempts - 1) : TX_RETRY_MAX_MS;
+    if (step > TX_RETRY_MAX_MS)
+      step = TX_RETRY_MAX_MS;
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (int k = 0; k < 200; k++)
+    {
+      rng = rng * 1103515245u + 12345u;
+      uint32_t d = journalBackoffMs(attempts, rng);
+      TEST_ASSERT_TRUE(d >= step / 2 && d <= step);
+      lo = d < lo ? d : lo;
+      hi = d > hi ? d : hi;
+    }
+    TEST_ASSERT_TRUE(hi - lo >= step / 4); // jitter spreads retries out
+  }
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(TX_RETRY_MAX_MS, journalBackoffMs(255, UINT32_MAX));
+
+  // Failures push the retry out; a new press makes it due again
+  TxJournal j;
+  journalInit(j);
+  journalRecord(j, true, 5000);
+  TEST_ASSERT_EQUAL_UINT32(0, journalRetryInMs(j, 5000));
+  journalSent(j, false, 5000, 0);
+  journalSent(j, false, 5000, 0);
+  TEST_ASSERT_EQUAL_UINT8(2, j.attempts);
+  TEST_ASSERT_EQUAL_UINT32(TX_RETRY_BASE_MS, journalRetryInMs(j, 5000));
+  journalRecord(j, false, 60000);
+  TEST_ASSERT_EQUAL_UINT8(0, j.attempts);
+  TEST_ASSERT_EQUAL_UINT32(0, journalRetryInMs(j, 60000));
+}
+
+// A game played while the link was down is timed from the presses
+void test_aged_records_date_games_from_the_press()
+{
+  SystemState state;
+  initSystemState(state);
+  openAllCourts(state, 1000);
+
+  uint32_t rxMs = 3600000;
+  CourtFrame f;
+  initCourtFrame(f, 3, 1);
+  addAgedCourtRecord(f, 3, true, 40 * 60000);  // started 40 min ago
+  addAgedCourtRecord(f, 3, false, 10 * 60000); // ended 10 min ago
+  for (int i = 0; i < f.count; i++)
+    applyPacket(state, f.records[i], recordTimeMs(state, f, i, rxMs), rxMs);
+
+  const CourtState &c = state.courts[2];
+  TEST_ASSERT_TRUE(c.available);
+  TEST_ASSERT_EQUAL_UINT32(1, c.waitSamples);
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 30 * 60000.0f, c.avgWaitMs);
+  TEST_ASSERT_EQUAL_UINT32(rxMs - 10 * 60000, c.availableSinceMs);
+  TEST_ASSERT_EQUAL_UINT32(rxMs, c.lastHeardMs); // heard now, not then
+
+  // Never dated before the court's current state began
+  CourtFrame late;
+  initCourtFrame(late, 3, 2);
+  addAgedCourtRecord(late, 3, true, 30 * 60000);
+  TEST_ASSERT_EQUAL_UINT32(c.availableSinceMs, recordTimeMs(state, late, 0, rxMs));
+
+  // Unaged frames keep the plain layout and the receive time
+  CourtFrame plain;
+  initCourtFrame(plain, 3, 3);
+  addCourtRecord(plain, 3, true);
+  uint8_t buf[PACKET_MAX_BYTES];
+  TEST_ASSERT_EQUAL_UINT32(PACKET_HEADER_BYTES + 2, encodeCourtFrame(plain, buf, sizeof(buf)));
+  TEST_ASSERT_EQUAL_UINT32(rxMs, recordTimeMs(state, plain, 0, rxMs));
+}
+
+// ============================================
+// TRANSMITTER STATE TESTS
+// ============================================
+
+void test_retained_state_survives_only_with_valid_crc()
+{
+  RetainedCourtState r;
+  memset(&r, 0xA7, sizeof(r)); // power-on garbage
+  TEST_ASSERT_FALSE(retainedValid(r));
+
+  retainedInit(r, true); // reloaded from NVS
+  TEST_ASSERT_TRUE(retainedValid(r));
+  TEST_ASSERT_EQUAL_UINT8(1, r.occupied);
+  TEST_ASSERT_FALSE(retainedDirty(r));
+
+  retainedSet(r, false, 5000);
+  TEST_ASSERT_TRUE(retainedValid(r)); // every change is resealed
+  TEST_ASSERT_TRUE(retainedDirty(r));
+
+  // Any flipped bit sends the boot path back to NVS
+  for (size_t i = 0; i < offsetof(RetainedCourtState, crc); i++)
+  {
+    RetainedCourtState bad = r;
+    ((uint8_t *)&bad)[i] ^= 0x10;
+    TEST_ASSERT_FALSE(retainedValid(bad));
+  }
+}
+
+void test_retained_state_commits_lazily_or_on_low_power()
+{
+  RetainedCourtState r;
+  retainedInit(r, false);
+  TEST_ASSERT_FALSE(retainedCommitDue(r, 1000000, true)); // nothing changed
+
+  // Presses never commit by themselves. The clock starts at the first
+  // change away from what NVS holds and keeps running after that.
+  retainedSet(r, true, 10000);
+  retainedSet(r, false, 400000); // back to NVS's value: clean again
+  retainedSet(r, true, 500000);
+  TEST_ASSERT_EQUAL_UINT32(500000, r.changedAtMs);
+  retainedSet(r, true, 600000);
+  TEST_ASSERT_EQUAL_UINT32(500000, r.changedAtMs);
+  TEST_ASSERT_FALSE(retainedCommitDue(r, 500000 + TX_NVS_COMMIT_MS - 1, false));
+  TEST_ASSERT_TRUE(retainedCommitDue(r, 500000, true)); // battery nearly flat
+  TEST_ASSERT_TRUE(retainedCommitDue(r, 500000 + TX_NVS_COMMIT_MS, false));
+
+  retainedCommitted(r);
+  TEST_ASSERT_FALSE(retainedDirty(r));
+  TEST_ASSERT_EQUAL_UINT8(1, r.committed);
+
+  // Toggled back to what NVS holds: nothing left to write
+  retainedSet(r, false, 1200000);
+  retainedSet(r, true, 1201000);
+  TEST_ASSERT_FALSE(retainedCommitDue(r, 1200000 + TX_NVS_COMMIT_MS, true));
+}
+
+void test_tx_channel_probe_order_and_relearn()
+{
+  // Every channel once, the configured one first
+  bool seen[WIFI_CHANNEL_COUNT + 1] = {};
+  TEST_ASSERT_EQUAL_UINT8(6, channelProbe(0, 6));
+  TEST_ASSERT_EQUAL_UINT8(7, channelProbe(1, 6));
+  TEST_ASSERT_EQUAL_UINT8(1, channelProbe(8, 6));
+  for (uint8_t n = 0; n < WIFI_CHANNEL_COUNT; n++)
+  {
+    uint8_t ch = channelProbe(n, 6);
+    TEST_ASSERT_TRUE(ch >= 1 && ch <= WIFI_CHANNEL_COUNT);
+    TEST_ASSERT_FALSE(seen[ch]);
+    seen[ch] = true;
+  }
+  TEST_ASSERT_EQUAL_UINT8(1, channelProbe(0, 0)); // out of range: start at 1
+
+  TxChannel c = {0, 0, 0, 0};
+  TEST_ASSERT_TRUE(channelProbeDue(c)); // power-on: find the receiver first
+  channelSent(c, 11, true);
+  TEST_ASSERT_EQUAL_UINT8(11, c.channel);
+  TEST_ASSERT_FALSE(channelProbeDue(c));
+
+  // Lost ACKs short of the limit keep the channel, and an ACK clears them
+  for (int i = 0; i < TX_CHANNEL_RELEARN_FAILS - 1; i++)
+    channelSent(c, 11, false);
+  TEST_ASSERT_EQUAL_UINT8(11, c.channel);
+  channelSent(c, 11, true);
+  for (int i = 0; i < TX_CHANNEL_RELEARN_FAILS - 1; i++)
+    channelSent(c, 11, false);
+  TEST_ASSERT_EQUAL_UINT8(11, c.channel);
+
+  // One more in a row: probe again
+  channelSent(c, 11, false);
+  TEST_ASSERT_EQUAL_UINT8(0, c.channel);
+  TEST_ASSERT_EQUAL_UINT8(0, c.failedSends);
+  TEST_ASSERT_TRUE(channelProbeDue(c));
+}
+
+void test_tx_channel_failed_probes_back_off()
+{
+  // Receiver switched off: count how many sends each full probe is
+  // followed by before the next one is due
+  TxChannel c = {0, 0, 0, 0};
+  uint32_t probes = 0, singles = 0, gap = 0, lastGap = 0;
+  for (int send = 0; send < 1000; send++)
+  {
+    bool probe = channelProbeDue(c);
+    if (probe)
+    {
+      if (probes > 0)
+      {
+        TEST_ASSERT_TRUE(gap >= lastGap); // gaps never shrink...
+        TEST_ASSERT_TRUE(gap <= TX_CHANNEL_PROBE_MAX_SKIP); // ...up to the cap
+        if (probes == 1)
+          TEST_ASSERT_EQUAL_UINT32(2, gap);
+        lastGap = gap;
+      }
+      probes++;
+      gap = 0;
+    }
+    else
+    {
+      singles++;
+      gap++;
+    }
+    channelSent(c, ESPNOW_CHANNEL, false, probe);
+  }
+  TEST_ASSERT_EQUAL_UINT32(TX_CHANNEL_PROBE_MAX_SKIP, lastGap);
+  // 13 sends per probe: far from 13 per wake
+  TEST_ASSERT_TRUE((probes * WIFI_CHANNEL_COUNT + singles) < 1000 * 2);
+
+  // The receiver is back on the configured channel, which sends and
+  // probes both try first: one ACK there clears the backoff
+  channelSent(c, ESPNOW_CHANNEL, true, channelProbeDue(c));
+  TEST_ASSERT_EQUAL_UINT8(ESPNOW_CHANNEL, c.channel);
+  TEST_ASSERT_EQUAL_UINT8(0, c.failedProbes);
+  TEST_ASSERT_EQUAL_UINT8(0, c.probeIn);
+}
+
+// ============================================
+// BOOT CLOCK TESTS
+// ============================================
+
+void test_boot_clock_prefers_rtc_then_event_log()
+{
+  RetainedClock c;
+  memset(&c, 0x5A, sizeof(c)); // power-on garbage
+  uint32_t ms = 0;
+  TEST_ASSERT_EQUAL(ClockSource::EventLog, bootBoardMs(c, 5000000, true, 777000, 40, ms));
+  TEST_ASSERT_EQUAL_UINT32(777000, ms);
+  TEST_ASSERT_EQUAL(ClockSource::Fresh, bootBoardMs(c, 5000000, false, 0, 40, ms));
+  TEST_ASSERT_EQUAL_UINT32(40, ms);
+
+  // Soft reset: the RTC timer kept counting, so the reset itself is
+  // on the clock
+  retainClock(c, 0xFFFFF000u, 100000000);
+  TEST_ASSERT_EQUAL(ClockSource::Rtc, bootBoardMs(c, 100000000 + 7250000, true, 777000, 40, ms));
+  TEST_ASSERT_EQUAL_UINT32(0xFFFFF000u + 7250, ms); // wraps like the board clock
+
+  // RTC timer restarted (power loss) or implausibly far ahead
+  TEST_ASSERT_FALSE(resumeClock(c, 99999999, ms));
+  TEST_ASSERT_FALSE(resumeClock(c, 100000000 + RETAINED_CLOCK_MAX_GAP_US + 1, ms));
+  RetainedClock bad = c;
+  bad.boardMs ^= 1;
+  TEST_ASSERT_FALSE(resumeClock(bad, 100000000, ms));
+}
+
+// After a soft reset the replayed board is drawn with its game clocks
+// still running, not restarted at boot
+void test_soft_reset_resumes_running_game_clocks()
+{
+  const char *dir = makeLogDir();
+  TEST_ASSERT_NOT_NULL(dir);
+  EventLog log;
+  TEST_ASSERT_TRUE(log.open(dir));
+  log.append(EV_CLOCK, 0, 1000);
+  log.append(EV_OCCUPIED, 3, 50000);
+  TEST_ASSERT_TRUE(log.flush());
+  RetainedClock c;
+  retainClock(c, 95000, 300000000); // last save before the reset
+
+  SystemState restored;
+  initSystemState(restored);
+  EventLog reopened;
+  TEST_ASSERT_TRUE(reopened.open(dir));
+  TEST_ASSERT_EQUAL_UINT32(2, reopened.replay(restored));
+  uint32_t now = 0;
+  TEST_ASSERT_EQUAL(ClockSource::Rtc, bootBoardMs(c, 302500000, true, reopened.lastTimeMs(), 30, now));
+
+  restored.courts[2].lastHeardMs = now; // restoreCourts(): one fault timeout to check in
+  CourtRowFields f;
+  formatCourtRow(restored.courts[2], 3, now, f);
+  TEST_ASSERT_EQUAL_STRING("Started", f.status);
+  TEST_ASSERT_EQUAL_STRING("00:47", f.now);
+}
+
+// ============================================
+// RENDER PIPELINE TESTS
+// ============================================
+
+void test_snapshot_mailbox_hands_over_newest_whole_snapshot()
+{
+  struct Snap
+  {
+    uint32_t words[16]; // all equal in a whole snapshot
+  };
+  static SnapshotMailbox<Snap> box;
+  auto fill = [](Snap &s, uint32_t v)
+  {
+    for (uint32_t &w : s.words)
+      w = v;
+  };
+
+  TEST_ASSERT_FALSE(box.fetch());
+  fill(box.back(), 1);
+  box.publish();
+  fill(box.back(), 2);
+  box.publish(); // 1 was never fetched: skipped
+  TEST_ASSERT_TRUE(box.fetch());
+  TEST_ASSERT_EQUAL_UINT32(2, box.front().words[0]);
+  TEST_ASSERT_FALSE(box.fetch()); // nothing new: front() keeps 2
+  TEST_ASSERT_EQUAL_UINT32(2, box.front().words[15]);
+
+  // Producer plays the state task, consumer the render task: every
+  // fetched snapshot is whole and newer than the one before
+  const uint32_t kSnaps = 200000;
+  std::thread producer([&]()
+                       {
+    for (uint32_t v = 3; v < kSnaps; v++)
+    {
+      fill(box.back(), v);
+      box.publish();
+    } });
+
+  uint32_t last = 2, fetched = 0;
+  bool whole = true, newer = true;
+  while (last < kSnaps - 1)
+  {
+    if (!box.fetch())
+      continue;
+    const Snap &s = box.front();
+    for (uint32_t w : s.words)
+      whole = whole && w == s.words[0];
+    newer = newer && s.words[0] > last;
+    last = s.words[0];
+    fetched++;
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(whole);
+  TEST_ASSERT_TRUE(newer);
+  TEST_ASSERT_TRUE(fetched > 0);
+  TEST_ASSERT_FALSE(box.fetch());
+}
+
+void test_board_snapshot_renders_like_live_state()
+{
+  SystemState state;
+  seedPreviewState(state);
+  uint32_t now = kPreviewNowMs;
+  OledRenderCache cache;
+  static uint8_t live[FB_BYTES], fromSnap[FB_BYTES];
+  static BoardSnapshot<NUM_COURTS> snap;
+
+  // Default title, then every court busy so the title is the estimate
+  for (int pass = 0; pass < 2; pass++)
+  {
+    CourtPredictor<NUM_COURTS> predictor;
+    for (int i = 0; i < NUM_COURTS; i++)
+    {
+      CourtState &c = state.courts[i];
+      if (pass == 1 && !c.inUse)
+      {
+        c.available = false;
+        c.inUse = true;
+        c.inUseSinceMs = now - (uint32_t)(i + 1) * 90000UL;
+        c.lastHeardMs = now - 5000;
+      }
+      predictor.update(state, i, now);
+    }
+    unsigned long overallMs = currentWaitMs(state, now);
+    takeBoardSnapshot(snap, state, predictor, overallMs, now);
+    TEST_ASSERT_EQUAL_INT(pass == 1 ? predictor.courtAt(0) : -1, snap.nextCourt);
+
+    // Drawn later than it was taken, as the render task does: the
+    // clocks and the estimate still match the live board
+    uint32_t later = now + 61500;
+    for (int first = 0; first < NUM_COURTS; first += COURTS_PER_PAGE)
+    {
+      char t1[16], t2[16];
+      renderCourtTable(cache, live, state, nextCourtTitle(t1, sizeof(t1), predictor, later), overallMs, first, later);
+      renderCourtTable(cache, fromSnap, snap.courts, snapshotTitle(t2, sizeof(t2), snap, later), snap.overallMs,
+                       first, later);
+      TEST_ASSERT_EQUAL_MEMORY(live, fromSnap, FB_BYTES);
+      TEST_ASSERT_EQUAL_UINT32(nextTableChangeMs(state, later, first, OLED_REFRESH_MS),
+                               nextTableChangeMs(snap.courts, later, first, OLED_REFRESH_MS));
+    }
+  }
+
+  // The snapshot is a copy: changes after it do not show
+  CourtPacket off = {1, 0};
+  applyPacket(state, off, now + 1000);
+  TEST_ASSERT_TRUE(snap.courts[0].inUse);
+}
+
+void test_task_load_reports_share_since_last_report()
+{
+  TaskLoad load;
+  TaskLoadMark mark = {0, 0};
+  char line[48];
+
+  for (int i = 0; i < 20; i++)
+    load.add(1550); // 20 passes, 31 ms busy
+  formatTaskLoad(line, sizeof(line), load, mark, 10000);
+  TEST_ASSERT_EQUAL_STRING("2.0 wakes/s, busy 0.31%", line);
+
+  // The next report covers only what happened after the first
+  load.add(5000);
+  formatTaskLoad(line, sizeof(line), load, mark, 10000);
+  TEST_ASSERT_EQUAL_STRING("0.1 wakes/s, busy 0.05%", line);
+
+  // Counters wrapping between reports do not upset the difference
+  load.busyUs.store(0xFFFFFF00u);
+  mark.busyUs = 0xFFFFFF00u;
+  load.add(1000);
+  formatTaskLoad(line, sizeof(line), load, mark, 1000);
+  TEST_ASSERT_EQUAL_STRING("1.0 wakes/s, busy 0.10%", line);
+}
+
+// ============================================
+// ASYNC FLUSH TESTS
+// ============================================
+
+// SSD1306 as far as the flush drives it: command streams that set the
+// column/page window (horizontal addressing) or the inversion, and
+// data written at a cursor that wraps inside the window
+static const size_t kWireChunk = 31; // OLED_I2C_CHUNK: Wire's buffer minus the control byte
+
+struct PanelModel
+{
+  uint8_t ram[FB_BYTES] = {};
+  bool inverted = false;
+  int col0 = 0, col1 = FB_WIDTH - 1, page0 = 0, page1 = FB_PAGES - 1;
+  int col = 0, page = 0;
+  uint32_t transactions = 0, bytes = 0;
+  uint32_t failAt = 0; // transaction number that NACKs, 0 = none
+
+  bool transfer(const uint8_t *head, size_t headLen, const uint8_t *data, size_t len)
+  {
+    if (++transactions == failAt)
+      return false; // NACKed: nothing of it reaches the panel
+    bytes += (uint32_t)(1 + headLen + len);
+    if (head[0] == OLED_CTRL_DATA)
+    {
+      for (size_t i = 1; i < headLen; i++)
+        put(head[i]);
+      for (size_t i = 0; i < len; i++)
+        put(data[i]);
+      return true;
+    }
+    for (size_t i = 1; i < headLen; i++)
+    {
+      switch (head[i])
+      {
+      case OLED_CMD_COLUMNADDR:
+        if (i + 2 >= headLen)
+          return false;
+        col = col0 = head[i + 1];
+        col1 = head[i + 2];
+        i += 2;
+        break;
+      case OLED_CMD_PAGEADDR:
+        if (i + 2 >= headLen)
+          return false;
+        page = page0 = head[i + 1];
+        page1 = head[i + 2];
+        i += 2;
+        break;
+      case OLED_CMD_INVERT:
+      case OLED_CMD_NORMAL:
+        inverted = head[i] == OLED_CMD_INVERT;
+        break;
+      default:
+        break;
+      }
+    }
+    return true;
+  }
+
+  void put(uint8_t b)
+  {
+    ram[page * FB_WIDTH + col] = b;
+    if (++col > col1)
+    {
+      col = col0;
+      if (++page > page1)
+        page = page0;
+    }
+  }
+};
+
+void test_flush_transfers_rebuild_each_frame_on_the_panel()
+{
+  static uint8_t fb[FB_BYTES];
+  uint32_t rng = 4242;
+  auto roll = [&](uint32_t n)
+  {
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 8) % n;
+  };
+
+  // Wire-sized chunks and whole spans per transaction
+  const size_t chunks[] = {kWireChunk, FB_WIDTH};
+  for (size_t maxChunk : chunks)
+  {
+    PanelModel panel;
+    FrameDiffer differ;
+    memset(fb, 0, sizeof(fb));
+    bool inverted = false;
+    for (int frame = 0; frame < 300; frame++)
+    {
+      // A few scattered edits, sometimes a full repaint
+      int edits = roll(10) == 0 ? FB_BYTES : (int)roll(40);
+      for (int e = 0; e < edits; e++)
+        fb[edits == FB_BYTES ? e : roll(FB_BYTES)] = (uint8_t)roll(256);
+
+      FlushJob job;
+      job.fb = fb;
+      job.count = (uint8_t)differ.diff(fb, job.spans, OLED_MAX_SPANS);
+      job.invert = -1;
+      if (roll(8) == 0)
+      {
+        inverted = !inverted;
+        job.invert = inverted ? 1 : 0;
+      }
+      uint32_t before = panel.bytes;
+      TEST_ASSERT_TRUE(forEachFlushTransfer(job, maxChunk, [&](const uint8_t *h, size_t hl, const uint8_t *d, size_t l)
+                                            {
+        TEST_ASSERT_TRUE(l <= maxChunk);
+        return panel.transfer(h, hl, d, l); }));
+
+      TEST_ASSERT_EQUAL_MEMORY(fb, panel.ram, FB_BYTES);
+      TEST_ASSERT_EQUAL(inverted, panel.inverted);
+      TEST_ASSERT_EQUAL_UINT32(panel.bytes - before, flushJobBytes(job, maxChunk));
+    }
+  }
+}
+
+void test_whole_span_transfers_cut_bus_overhead()
+{
+  static uint8_t fb[FB_BYTES];
+  memset(fb, 0x5A, sizeof(fb));
+  FrameDiffer differ;
+  FlushJob job;
+  job.fb = fb;
+  job.count = (uint8_t)differ.diff(fb, job.spans, OLED_MAX_SPANS); // first flush: every page
+  job.invert = -1;
+
+  // Per page: one addressing transaction, then 128 data bytes in five
+  // Wire-sized writes or in a single one
+  PanelModel wire, idf;
+  forEachFlushTransfer(job, kWireChunk, [&](const uint8_t *h, size_t hl, const uint8_t *d, size_t l)
+                       { return wire.transfer(h, hl, d, l); });
+  forEachFlushTransfer(job, FB_WIDTH, [&](const uint8_t *h, size_t hl, const uint8_t *d, size_t l)
+                       { return idf.transfer(h, hl, d, l); });
+  TEST_ASSERT_EQUAL_UINT32(FB_PAGES * 6, wire.transactions);
+  TEST_ASSERT_EQUAL_UINT32(FB_PAGES * 2, idf.transactions);
+  TEST_ASSERT_EQUAL_UINT32(FB_PAGES * (8 + 5 * 2 + FB_WIDTH), wire.bytes);
+  TEST_ASSERT_EQUAL_UINT32(FB_PAGES * (8 + 2 + FB_WIDTH), idf.bytes);
+
+  // A bus error ends the flush at that transaction
+  int sent = 0;
+  TEST_ASSERT_FALSE(forEachFlushTransfer(job, FB_WIDTH, [&](const uint8_t *, size_t, const uint8_t *, size_t)
+                                         { return ++sent < 3; }));
+  TEST_ASSERT_EQUAL_INT(3, sent);
+}
+
+void test_failed_flush_transfer_resends_whole_frame()
+{
+  static uint8_t fb[FB_BYTES];
+  memset(fb, 0, sizeof(fb));
+  PanelModel panel;
+  FrameDiffer differ;
+  bool inverted = false, failed = false;
+  int8_t pendingInvert = -1;
+
+  // The render task's side of a flush, as in the receiver's flushDisplay()
+  auto flush = [&]()
+  {
+    if (failed)
+    {
+      differ.invalidate();
+      pendingInvert = inverted ? 1 : 0;
+      failed = false;
+    }
+    FlushJob job;
+    job.fb = fb;
+    job.count = (uint8_t)differ.diff(fb, job.spans, OLED_MAX_SPANS);
+    job.invert = pendingInvert;
+    pendingInvert = -1;
+    failed = !forEachFlushTransfer(job, FB_WIDTH, [&](const uint8_t *h, size_t hl, const uint8_t *d, size_t l)
+                                   { return panel.transfer(h, hl, d, l); });
+  };
+
+  flush();
+  TEST_ASSERT_EQUAL_MEMORY(fb, panel.ram, FB_BYTES);
+
+  // The inversion and the data of one span are lost to a NACK
+  memset(fb + 3 * FB_WIDTH, 0xFF, FB_WIDTH);
+  inverted = true;
+  pendingInvert = 1;
+  panel.failAt = panel.transactions + 1;
+  flush();
+  TEST_ASSERT_TRUE(failed);
+  TEST_ASSERT_FALSE(panel.inverted);
+
+  // The next frame changes elsewhere, yet the lost span and the
+  // inversion arrive with it
+  fb[7 * FB_WIDTH + 5] = 0x81;
+  flush();
+  TEST_ASSERT_FALSE(failed);
+  TEST_ASSERT_EQUAL_MEMORY(fb, panel.ram, FB_BYTES);
+  TEST_ASSERT_TRUE(panel.inverted);
+}
 
 int main(int argc, char **argv)
 {
@@ -492,6 +2806,12 @@ int main(int argc, char **argv)
   RUN_TEST(test_global_average_single_court);
   RUN_TEST(test_global_average_weighted);
   RUN_TEST(test_global_average_uniform);
+  RUN_TEST(test_overall_average_tracks_recorded_games);
+
+  // Court count scaling tests
+  RUN_TEST(test_large_board_accepts_all_court_ids);
+  RUN_TEST(test_storage_is_sized_by_court_count);
+  RUN_TEST(test_pager_covers_every_court);
 
   // State machine tests
   RUN_TEST(test_court_lifecycle);
@@ -514,6 +2834,8 @@ int main(int argc, char **argv)
   // Fault detection tests
   RUN_TEST(test_fault_triggers_after_timeout);
   RUN_TEST(test_fault_clears_on_recovery);
+  RUN_TEST(test_fault_deadline_follows_advertised_interval);
+  RUN_TEST(test_only_frames_from_faulted_courts_clear_a_fault);
 
   // Boundary and edge case tests
   RUN_TEST(test_invalid_court_ids);
@@ -522,6 +2844,120 @@ int main(int argc, char **argv)
   // Integration tests
   RUN_TEST(test_realistic_scenario_full_day);
 
+  // Packet engine tests
+  RUN_TEST(test_apply_packet_game_lifecycle);
+  RUN_TEST(test_apply_packet_rejects_unknown_court);
+  RUN_TEST(test_apply_packet_idle_court_freed_without_sample);
+  RUN_TEST(test_court_row_fields_are_column_padded);
+
+  // Packet format tests
+  RUN_TEST(test_frame_decodes_legacy_two_byte_packet);
+  RUN_TEST(test_frame_round_trips_batched_records);
+  RUN_TEST(test_frame_rejects_malformed_input);
+  RUN_TEST(test_link_tracker_suppresses_duplicates_and_counts_loss);
+  RUN_TEST(test_link_tracker_handles_wrap_and_reboot);
+  RUN_TEST(test_link_tracker_passes_legacy_frames);
+  RUN_TEST(test_link_tracker_records_reported_awake_time);
+
+  // Packet queue tests
+  RUN_TEST(test_spsc_queue_fifo_and_empty);
+  RUN_TEST(test_spsc_queue_drops_when_full);
+  RUN_TEST(test_spsc_queue_wraps_index);
+  RUN_TEST(test_spsc_queue_two_thread_hammer);
+
+  // Animation scheduler tests
+  RUN_TEST(test_animation_idle_without_events);
+  RUN_TEST(test_animation_frames_follow_clock);
+  RUN_TEST(test_animation_coalesces_duplicate_courts);
+  RUN_TEST(test_animation_queues_back_to_back_courts);
+
+  // OLED dirty-region tests
+  RUN_TEST(test_frame_diff_first_flush_is_full_frame);
+  RUN_TEST(test_frame_diff_reports_only_changed_columns);
+  RUN_TEST(test_frame_diff_splits_distant_changes);
+  RUN_TEST(test_frame_diff_out_of_spans_keeps_pending_bytes);
+
+  // Transmitter power budget tests
+  RUN_TEST(test_power_budget_weights_states_by_time);
+  RUN_TEST(test_power_budget_led_scales_with_duty);
+
+  // Adaptive heartbeat tests
+  RUN_TEST(test_heartbeat_backs_off_while_acked);
+  RUN_TEST(test_heartbeat_tightens_on_failure_and_state_change);
+
+  // Streaming wait statistics tests
+  RUN_TEST(test_wait_stats_ewma_tracks_recent_games);
+  RUN_TEST(test_wait_stats_windows_expire_old_games);
+  RUN_TEST(test_wait_stats_percentiles_from_histogram);
+  RUN_TEST(test_court_stats_follow_game_ends);
+
+  // Next-court prediction tests
+  RUN_TEST(test_expected_remaining_is_conditional_on_elapsed);
+  RUN_TEST(test_predictor_orders_courts_by_free_time);
+
+  // Event log tests
+  RUN_TEST(test_event_log_replay_rebuilds_state);
+  RUN_TEST(test_event_log_survives_torn_tail);
+  RUN_TEST(test_event_log_ring_drops_oldest_segment);
+
+  // Telemetry tests
+  RUN_TEST(test_cobs_round_trips_zeros_and_long_runs);
+  RUN_TEST(test_telemetry_stream_sends_snapshot_then_changes_only);
+  RUN_TEST(test_telemetry_decoder_rejects_corrupt_frame);
+
+  // State sync tests
+  RUN_TEST(test_sync_delta_carries_only_changed_fields);
+  RUN_TEST(test_sync_converges_under_drops_and_reordering);
+  RUN_TEST(test_sync_resyncs_after_receiver_reboot);
+
+  // OLED render tests
+  RUN_TEST(test_render_cache_matches_plain_font_blits);
+  RUN_TEST(test_blit_glyph_straddles_pages);
+
+  // Golden image tests
+  RUN_TEST(test_screens_match_golden_images);
+  RUN_TEST(test_screen_render_time_within_budget);
+
+  // Instrumentation tests
+  RUN_TEST(test_histogram_percentiles_within_bucket_error);
+  RUN_TEST(test_scoped_timer_records_elapsed_time);
+  RUN_TEST(test_duration_format_fits_stats_page_column);
+
+  // Wake schedule tests
+  RUN_TEST(test_wake_schedule_catches_every_visible_change);
+  RUN_TEST(test_wake_deadline_clamps_past_and_wraps);
+  RUN_TEST(test_animation_next_frame_follows_frame_slots);
+
+  // Timer wheel tests
+  RUN_TEST(test_timer_wheel_matches_brute_force_clock);
+  RUN_TEST(test_timer_wheel_rearm_from_callback_and_cancel);
+  RUN_TEST(test_fault_timers_cover_undisplayed_courts);
+
+  // Transmitter journal tests
+  RUN_TEST(test_journal_coalesces_undone_presses_and_keeps_real_games);
+  RUN_TEST(test_journal_backoff_doubles_with_jitter_and_caps);
+  RUN_TEST(test_aged_records_date_games_from_the_press);
+
+  // Transmitter state tests
+  RUN_TEST(test_retained_state_survives_only_with_valid_crc);
+  RUN_TEST(test_retained_state_commits_lazily_or_on_low_power);
+  RUN_TEST(test_tx_channel_probe_order_and_relearn);
+  RUN_TEST(test_tx_channel_failed_probes_back_off);
+
+  // Boot clock tests
+  RUN_TEST(test_boot_clock_prefers_rtc_then_event_log);
+  RUN_TEST(test_soft_reset_resumes_running_game_clocks);
+
+  // Render pipeline tests
+  RUN_TEST(test_snapshot_mailbox_hands_over_newest_whole_snapshot);
+  RUN_TEST(test_board_snapshot_renders_like_live_state);
+  RUN_TEST(test_task_load_reports_share_since_last_report);
+
+  // Async flush tests
+  RUN_TEST(test_flush_transfers_rebuild_each_frame_on_the_panel);
+  RUN_TEST(test_whole_span_transfers_cut_bus_overhead);
+  RUN_TEST(test_failed_flush_transfer_resends_whole_frame);
+
   UNITY_END();
   return 0;
 }